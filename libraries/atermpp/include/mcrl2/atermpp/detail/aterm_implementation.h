@@ -78,6 +78,24 @@ extern std::size_t total_nodes_in_hashtable;
 extern TermInfo *terminfo;
 
 extern std::size_t garbage_collect_count_down;
+extern std::size_t allocated_block_memory;
+extern std::size_t garbage_collection_count;
+extern double garbage_collection_time;
+
+/// \brief Statistics of the storage of terms.
+struct aterm_heap_statistics
+{
+  std::size_t terms;                // The number of terms in the hashtable.
+  std::size_t bytes;                // The number of bytes in blocks of terms and in the hashtable.
+  std::size_t garbage_collections;  // The number of times terms with reference count 0 were collected.
+  double garbage_collection_time;   // The time in seconds spent on collecting terms.
+};
+
+inline
+aterm_heap_statistics heap_statistics()
+{
+  return { total_nodes_in_hashtable, allocated_block_memory + aterm_table_size * sizeof(_aterm*), garbage_collection_count, garbage_collection_time };
+}
 
 void resize_aterm_hashtable();
 void allocate_block(const std::size_t size);
@@ -118,6 +118,19 @@ class indexed_set
     {
       return m_keys.size()-free_positions.size();
     }
+
+    /// \brief Returns the number of entries of the hash table of the indexed set.
+    std::size_t bucket_count() const
+    {
+      return hashtable.size();
+    }
+
+    /// \brief Returns an estimate of the number of bytes used by the hash table and the keys.
+    /// The memory used by the terms that the keys refer to is not included.
+    std::size_t memory_usage() const
+    {
+      return hashtable.capacity() * sizeof(std::size_t) + m_keys.size() * sizeof(ELEMENT);
+    }
 };
 
 } // namespace atermpp
@@ -21,8 +21,10 @@
 #include <cstring>
 #include <sstream>
 #include <algorithm>
+#include <chrono>
 
 
+#include "mcrl2/utilities/execution_timer.h"
 #include "mcrl2/utilities/logger.h"
 #include "mcrl2/atermpp/detail/aterm_implementation.h"
 #include "mcrl2/atermpp/detail/aterm_int.h"
@@ -97,10 +99,17 @@ _aterm* * aterm_hashtable;
 // The following is not a vector to avoid that it is prematurely destroyed.
 std::size_t terminfo_size=INITIAL_MAX_TERM_SIZE;
 std::size_t garbage_collect_count_down=0;
+std::size_t allocated_block_memory=0;
+std::size_t garbage_collection_count=0;
+double garbage_collection_time=0;
 TermInfo *terminfo;
 
 std::size_t total_nodes_in_hashtable = 0;
 
+// Reports the growth of the term table in the timings of the tools.
+static const bool aterm_counter_is_registered =
+  (mcrl2::utilities::execution_timer::register_counter("aterms", []() { return static_cast<long long>(total_nodes_in_hashtable); }), true);
+
 void call_creation_hook(detail::_aterm* term)
 {
   const function_symbol& sym = term->function();
@@ -226,7 +235,7 @@ void collect_terms_with_reference_count_0()
 {
   // This function puts all with reference count==0 in the freelist, in the reverse order as
   // the sequence of blocks.
-
+  const auto start = std::chrono::steady_clock::now();
 
   // First put all terms with reference count 0 in the freelist.
   for(std::size_t size=TERM_SIZE; size<terminfo_size; ++size)
@@ -285,6 +294,7 @@ void collect_terms_with_reference_count_0()
         {
           previous_block->next_by_size=next_block;
         }
+        allocated_block_memory-=reinterpret_cast<char*>(b->end)-reinterpret_cast<char*>(b);
         free(b);
       }
       else
@@ -296,6 +306,8 @@ void collect_terms_with_reference_count_0()
     }
   }
   garbage_collect_count_down=(1+number_of_blocks)*(BLOCK_SIZE/(sizeof(std::size_t)*16));
+  garbage_collection_count++;
+  garbage_collection_time+=std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count();
 }
 
 #ifdef MCRL2_CHECK_ATERMPP_CLEANUP
@@ -396,6 +408,7 @@ void allocate_block(const std::size_t size)
   TermInfo& ti = terminfo[size];
 
   newblock->end = newblock->data + number_of_terms_in_data_block*size;
+  allocated_block_memory+=reinterpret_cast<char*>(newblock->end)-reinterpret_cast<char*>(newblock);
 
   // Put new terms in the block in the freelist.
 
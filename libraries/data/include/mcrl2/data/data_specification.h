@@ -14,6 +14,8 @@
 
 #include <algorithm>
 #include <functional>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include "mcrl2/atermpp/aterm_appl.h"
@@ -30,6 +32,7 @@
 #include "mcrl2/data/data_equation.h"
 #include "mcrl2/data/function_update.h"
 #include "mcrl2/data/detail/io.h"
+#include "mcrl2/data/detail/system_defined_data_type_cache.h"
 
 
 namespace mcrl2
@@ -74,52 +77,48 @@ class data_specification: public sort_specification
   private:
 
     /// \cond INTERNAL_DOCS
-    /// \brief Cached constructors by target sort
-    struct target_sort_to_function_map
+    /// \brief A sequence of function symbols without duplicates, with a hash index for membership
+    /// tests, and the same function symbols grouped by target sort. All three are kept up to date
+    /// on insertion and removal.
+    struct function_symbol_table
     {
-      bool _outdated;
-      std::map<sort_expression, std::vector<function_symbol> > _mapping;
-
-      target_sort_to_function_map()
-        : _outdated(true)
-      {}
-
-      /// \brief Groups functions according to their target sorts.
-      /// \param [in,out] c container in which the functions are stored grouped by target sort.
-      /// \param [in] functions a container with function symbols
-      template <typename Container>
-      void group_functions_by_target_sort(std::map<sort_expression, std::vector<function_symbol> >& c, const Container& functions)
+      function_symbol_vector functions;
+      std::unordered_set<function_symbol, std::hash<atermpp::aterm> > index;
+      std::unordered_map<sort_expression, function_symbol_vector, std::hash<atermpp::aterm> > by_target_sort;
+
+      /// \brief Adds f, unless it is already present.
+      /// \return True if f was added.
+      bool insert(const function_symbol& f)
       {
-        for (typename Container::const_iterator i = functions.begin(); i != functions.end(); ++i)
+        if (!index.insert(f).second)
         {
-          sort_expression index_sort(i->sort().target_sort());
-          if(c.find(index_sort) == c.end() || std::find(c[index_sort].begin(), c[index_sort].end(), *i) == c[index_sort].end())
-          {
-            c[index_sort].push_back(*i);
-          }
+          return false;
         }
+        functions.push_back(f);
+        by_target_sort[f.sort().target_sort()].push_back(f);
+        return true;
       }
 
-      template <typename FunctionContainer>
-      void reset(const FunctionContainer& c)
+      void remove(const function_symbol& f)
       {
-        if(_outdated)
+        if (index.erase(f) > 0)
         {
-          _mapping.clear();
-          group_functions_by_target_sort(_mapping, c);
-          _outdated = false;
+          detail::remove(functions, f);
+          detail::remove(by_target_sort[f.sort().target_sort()], f);
         }
       }
 
-      void expire()
+      void clear()
       {
-        _outdated = true;
+        functions.clear();
+        index.clear();
+        by_target_sort.clear();
       }
 
-      std::map<sort_expression, std::vector<function_symbol> >&mapping()
+      /// \brief Returns the function symbols with target sort s.
+      const function_symbol_vector& with_target_sort(const sort_expression& s)
       {
-        assert(!_outdated);
-        return _mapping;
+        return by_target_sort[s];
       }
     };
 
@@ -132,28 +131,22 @@ class data_specification: public sort_specification
 
   protected:
 
-    /// \brief A mapping of sort expressions to the constructors corresponding to that sort.
-    function_symbol_vector m_user_defined_constructors;
+    /// \brief The constructors of the specification.
+    function_symbol_table m_user_defined_constructors;
 
     /// \brief The mappings of the specification.
-    function_symbol_vector m_user_defined_mappings;
+    function_symbol_table m_user_defined_mappings;
 
     /// \brief The equations of the specification.
     std::vector< data_equation > m_user_defined_equations;
 
-    /// \brief Set containing all constructors, including the system defined ones.
-    /// The types in these constructors are normalised.
-    mutable function_symbol_vector m_normalised_constructors;
-
-    /// \brief Cache normalised constructors grouped by target sort.
-    mutable target_sort_to_function_map m_grouped_normalised_constructors;
+    /// \brief Set containing all constructors, including the system defined ones,
+    /// also grouped by target sort. The types in these constructors are normalised.
+    mutable function_symbol_table m_normalised_constructors;
 
-    /// \brief Set containing system defined all mappings, including the system defined ones.
-    /// The types in these mappings are normalised.
-    mutable function_symbol_vector m_normalised_mappings;
-
-    /// \brief Cache normalised mappings grouped by target sort.
-    mutable target_sort_to_function_map m_grouped_normalised_mappings;
+    /// \brief Set containing all mappings, including the system defined ones,
+    /// also grouped by target sort. The types in these mappings are normalised.
+    mutable function_symbol_table m_normalised_mappings;
     //
     /// \brief Table containing all equations, including the system defined ones.
     ///        The sorts in these equations are normalised.
@@ -176,11 +169,13 @@ class data_specification: public sort_specification
     inline
     void add_normalised_constructor(const function_symbol& f) const
     {
-      function_symbol g(normalize_sorts(f, *this));
-      if (std::find(m_normalised_constructors.begin(),m_normalised_constructors.end(),g)==m_normalised_constructors.end()) // not found
-      {
-        m_normalised_constructors.push_back(g);
-      }
+      insert_normalised_constructor(function_symbol(normalize_sorts(f, *this)));
+    }
+
+    /// \brief Adds a constructor of which the sorts are already normalised.
+    void insert_normalised_constructor(const function_symbol& g) const
+    {
+      m_normalised_constructors.insert(g);
     }
 
     /// \brief Adds a mapping to this specification, and marks it as system
@@ -192,11 +187,13 @@ class data_specification: public sort_specification
     /// \note this operation does not invalidate iterators of mappings_const_range
     void add_normalised_mapping(const function_symbol& f) const
     {
-      function_symbol g(normalize_sorts(f, *this));
-      if (std::find(m_normalised_mappings.begin(),m_normalised_mappings.end(),g)==m_normalised_mappings.end()) // not found
-      {
-        m_normalised_mappings.push_back(g);
-      }
+      insert_normalised_mapping(function_symbol(normalize_sorts(f, *this)));
+    }
+
+    /// \brief Adds a mapping of which the sorts are already normalised.
+    void insert_normalised_mapping(const function_symbol& g) const
+    {
+      m_normalised_mappings.insert(g);
     }
 
     /// \brief Adds an equation to this specification, and marks it as system
@@ -348,7 +345,7 @@ class data_specification: public sort_specification
     const function_symbol_vector& constructors() const
     {
       normalise_data_specification_if_required();
-      return m_normalised_constructors;
+      return m_normalised_constructors.functions;
     }
 
     /// \brief Gets the constructors defined by the user, excluding those that
@@ -357,7 +354,7 @@ class data_specification: public sort_specification
     inline
     const function_symbol_vector& user_defined_constructors() const
     {
-      return m_user_defined_constructors;
+      return m_user_defined_constructors.functions;
     }
 
     /// \brief Gets all constructors of a sort including those that are system defined.
@@ -369,8 +366,7 @@ class data_specification: public sort_specification
     const function_symbol_vector& constructors(const sort_expression& s) const
     {
       normalise_data_specification_if_required();
-      m_grouped_normalised_constructors.reset(constructors());
-      return m_grouped_normalised_constructors.mapping()[normalize_sorts(s,*this)];
+      return m_normalised_constructors.with_target_sort(normalize_sorts(s,*this));
     }
 
     /// \brief Gets all mappings in this specification including those that are system defined.
@@ -382,7 +378,7 @@ class data_specification: public sort_specification
     const function_symbol_vector& mappings() const
     {
       normalise_data_specification_if_required();
-      return m_normalised_mappings;
+      return m_normalised_mappings.functions;
     }
 
     /// \brief Gets all user defined mappings in this specification.
@@ -393,7 +389,7 @@ class data_specification: public sort_specification
     inline
     const function_symbol_vector& user_defined_mappings() const
     {
-      return m_user_defined_mappings;
+      return m_user_defined_mappings.functions;
     }
 
     /// \brief Gets all mappings of a sort including those that are system defined
@@ -405,8 +401,7 @@ class data_specification: public sort_specification
     const function_symbol_vector& mappings(const sort_expression& s) const
     {
       normalise_data_specification_if_required();
-      m_grouped_normalised_mappings.reset(mappings());
-      return m_grouped_normalised_mappings.mapping()[normalize_sorts(s, *this)];
+      return m_normalised_mappings.with_target_sort(normalize_sorts(s, *this));
     }
 
     /// \brief Gets all equations in this specification including those that are system defined
@@ -439,11 +434,15 @@ class data_specification: public sort_specification
     /// \note this operation does not invalidate iterators of constructors_const_range
     void add_constructor(const function_symbol& f)
     {
-      if (std::find(m_user_defined_constructors.begin(),m_user_defined_constructors.end(),f)==m_user_defined_constructors.end())
+      if (m_user_defined_constructors.insert(f))
       {
-        m_user_defined_constructors.push_back(f);
         import_system_defined_sort(f.sort());
-        data_is_not_necessarily_normalised_anymore();
+        // If no new sorts were imported, the normalised data is brought up to date
+        // incrementally instead of being recomputed.
+        if (m_normalised_data_is_up_to_date)
+        {
+          add_normalised_constructor(f);
+        }
       }
     }
 
@@ -454,11 +453,13 @@ class data_specification: public sort_specification
     /// \note this operation does not invalidate iterators of mappings_const_range
     void add_mapping(const function_symbol& f)
     {
-      if (std::find(m_user_defined_mappings.begin(),m_user_defined_mappings.end(),f)==m_user_defined_mappings.end())
+      if (m_user_defined_mappings.insert(f))
       {
-        m_user_defined_mappings.push_back(f);
         import_system_defined_sort(f.sort());
-        data_is_not_necessarily_normalised_anymore();
+        if (m_normalised_data_is_up_to_date)
+        {
+          add_normalised_mapping(f);
+        }
       }
     }
 
@@ -472,7 +473,10 @@ class data_specification: public sort_specification
       import_system_defined_sorts(find_sort_expressions(e));
       // m_user_defined_equations.push_back(data::translate_user_notation(e));
       m_user_defined_equations.push_back(e);
-      data_is_not_necessarily_normalised_anymore();
+      if (m_normalised_data_is_up_to_date)
+      {
+        add_normalised_equation(data::translate_user_notation(e));
+      }
     }
 
   private:
@@ -500,13 +504,13 @@ class data_specification: public sort_specification
 
 
       // Normalise the constructors.
-      for (const function_symbol& f: m_user_defined_constructors)
+      for (const function_symbol& f: m_user_defined_constructors.functions)
       {
         add_normalised_constructor(f);
       }
 
       // Normalise the sorts of the mappings.
-      for (const function_symbol& f: m_user_defined_mappings)
+      for (const function_symbol& f: m_user_defined_mappings.functions)
       {
         add_normalised_mapping(f);
       }
@@ -524,9 +528,9 @@ class data_specification: public sort_specification
     {
       if (!m_normalised_data_is_up_to_date)
       {
+        // Normalising the sorts marks the data as not normalised, so it must be done first.
+        normalise_sort_specification_if_required();
         m_normalised_data_is_up_to_date=true;
-        m_grouped_normalised_constructors.expire();
-        m_grouped_normalised_mappings.expire();
         add_data_types_for_sorts();
       }
     }
@@ -702,17 +706,39 @@ class data_specification: public sort_specification
     /// mappings and equations that belong to this sort to the `normalised' sets in this
     /// data type. E.g. for the sort Nat of natural numbers, it is required that Pos
     /// (positive numbers) are defined.
+    /// The generated data types are cached, and they are only normalised if the aliases of this
+    /// specification affect them.
     void import_data_type_for_system_defined_sort(const sort_expression& sort) const
     {
-      std::set < function_symbol > constructors;
-      std::set < function_symbol > mappings;
-      std::set < data_equation > equations;
-      find_associated_system_defined_data_types_for_a_sort(sort, constructors, mappings, equations);
-
-      // add normalised constructors, mappings and equations
-      add_normalised_constructors(constructors.begin(), constructors.end());
-      add_normalised_mappings(mappings.begin(), mappings.end());
-      add_normalised_equations(equations.begin(), equations.end());
+      const detail::system_defined_data_type& data_type = detail::system_defined_data_type_cache(sort,
+        [&](const sort_expression& s)
+        {
+          std::set < function_symbol > constructors;
+          std::set < function_symbol > mappings;
+          std::set < data_equation > equations;
+          find_associated_system_defined_data_types_for_a_sort(s, constructors, mappings, equations);
+          return detail::system_defined_data_type(constructors, mappings, equations);
+        });
+
+      if (data_type.is_normalised(sort_alias_map()))
+      {
+        for (const function_symbol& f: data_type.constructors)
+        {
+          insert_normalised_constructor(f);
+        }
+        for (const function_symbol& f: data_type.mappings)
+        {
+          insert_normalised_mapping(f);
+        }
+        m_normalised_equations.insert(m_normalised_equations.end(), data_type.equations.begin(), data_type.equations.end());
+      }
+      else
+      {
+        // add normalised constructors, mappings and equations
+        add_normalised_constructors(data_type.constructors.begin(), data_type.constructors.end());
+        add_normalised_mappings(data_type.mappings.begin(), data_type.mappings.end());
+        add_normalised_equations(data_type.equations.begin(), data_type.equations.end());
+      }
     }
 
   public:
@@ -757,8 +783,8 @@ class data_specification: public sort_specification
     /// only if they point to the element that is removed
     void remove_constructor(const function_symbol& f)
     {
-      detail::remove(m_normalised_constructors, normalize_sorts(f,*this));
-      detail::remove(m_user_defined_constructors, f);
+      m_normalised_constructors.remove(function_symbol(normalize_sorts(f,*this)));
+      m_user_defined_constructors.remove(f);
     }
 
     /// \brief Removes mapping from specification.
@@ -770,8 +796,8 @@ class data_specification: public sort_specification
     /// only if they point to the element that is removed
     void remove_mapping(const function_symbol& f)
     {
-      detail::remove(m_normalised_mappings, normalize_sorts(f,*this));
-      detail::remove(m_user_defined_mappings, f);
+      m_normalised_mappings.remove(function_symbol(normalize_sorts(f,*this)));
+      m_user_defined_mappings.remove(f);
     }
 
     /// \brief Removes equation from specification.
@@ -832,8 +858,8 @@ class data_specification: public sort_specification
       other.normalise_data_specification_if_required();
       return
         sort_specification::operator==(other) &&
-        m_normalised_constructors == other.m_normalised_constructors &&
-        m_normalised_mappings == other.m_normalised_mappings &&
+        m_normalised_constructors.functions == other.m_normalised_constructors.functions &&
+        m_normalised_mappings.functions == other.m_normalised_mappings.functions &&
         m_normalised_equations == other.m_normalised_equations;
     }
 
@@ -845,8 +871,6 @@ class data_specification: public sort_specification
       m_user_defined_equations=other.m_user_defined_equations;
       m_normalised_mappings=other.m_normalised_mappings;
       m_normalised_constructors=other.m_normalised_constructors;
-      m_grouped_normalised_mappings=other.m_grouped_normalised_mappings;
-      m_grouped_normalised_constructors=other.m_grouped_normalised_constructors;
       m_normalised_equations=other.m_normalised_equations;
       return *this;
     }
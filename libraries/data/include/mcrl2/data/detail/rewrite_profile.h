@@ -0,0 +1,228 @@
+// Author(s): Wieger Wesselink
+// Copyright: see the accompanying file COPYING or copy at
+// https://svn.win.tue.nl/trac/MCRL2/browser/trunk/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file mcrl2/data/detail/rewrite_profile.h
+/// \brief Collecting per equation and per function symbol statistics of the rewriters.
+
+#ifndef MCRL2_DATA_DETAIL_REWRITE_PROFILE_H
+#define MCRL2_DATA_DETAIL_REWRITE_PROFILE_H
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "mcrl2/data/data_equation.h"
+#include "mcrl2/data/print.h"
+#include "mcrl2/utilities/exception.h"
+#include "mcrl2/utilities/text_utility.h"
+
+namespace mcrl2
+{
+
+namespace data
+{
+
+namespace detail
+{
+
+/// \brief Statistics of the rewriters. The jitty rewriter records for every equation how often it
+/// is tried, how often it is applied, and the time spent from the start of the match until the
+/// right hand side is in normal form. Since this time includes nested rewriting, the times of
+/// different equations overlap. Furthermore the number of rewrite steps per head symbol and the
+/// number of subterms that were already marked as being in normal form are recorded. The compiling
+/// rewriter only records the number of calls to rewrite.
+struct rewrite_profile
+{
+  struct equation_statistics
+  {
+    std::size_t attempts = 0;
+    std::size_t successes = 0;
+    std::chrono::steady_clock::duration time = std::chrono::steady_clock::duration::zero();
+  };
+
+  std::unordered_map<data_equation, equation_statistics, std::hash<atermpp::aterm> > equations;
+  std::unordered_map<function_symbol, std::size_t, std::hash<atermpp::aterm> > function_symbol_calls;
+  std::size_t rewrite_calls = 0;
+  std::size_t normal_form_hits = 0;
+
+  /// \brief If true, only the number of rewrite calls is recorded.
+  bool count_only = false;
+
+  /// \brief Measures one attempt to apply an equation, from its construction until its destruction.
+  /// If profile is nullptr nothing is measured.
+  class equation_attempt
+  {
+    protected:
+      equation_statistics* m_statistics = nullptr;
+      std::chrono::steady_clock::time_point m_start;
+
+    public:
+      equation_attempt(rewrite_profile* profile, const data_equation& eq)
+      {
+        if (profile)
+        {
+          m_statistics = &profile->equations[eq];
+          m_statistics->attempts++;
+          m_start = std::chrono::steady_clock::now();
+        }
+      }
+
+      equation_attempt(const equation_attempt&) = delete;
+      equation_attempt& operator=(const equation_attempt&) = delete;
+
+      /// \brief Records that the equation is applied.
+      void success()
+      {
+        if (m_statistics)
+        {
+          m_statistics->successes++;
+        }
+      }
+
+      ~equation_attempt()
+      {
+        if (m_statistics)
+        {
+          m_statistics->time += std::chrono::steady_clock::now() - m_start;
+        }
+      }
+  };
+
+  /// \brief Returns the equations, with the most time consuming ones first.
+  std::vector<std::pair<data_equation, equation_statistics> > sorted_equations() const
+  {
+    std::vector<std::pair<data_equation, equation_statistics> > result(equations.begin(), equations.end());
+    std::sort(result.begin(), result.end(),
+              [](const std::pair<data_equation, equation_statistics>& x, const std::pair<data_equation, equation_statistics>& y)
+              {
+                return x.second.time > y.second.time || (x.second.time == y.second.time && x.second.attempts > y.second.attempts);
+              });
+    return result;
+  }
+
+  /// \brief Returns the function symbols, with the most frequently rewritten ones first.
+  std::vector<std::pair<function_symbol, std::size_t> > sorted_function_symbols() const
+  {
+    std::vector<std::pair<function_symbol, std::size_t> > result(function_symbol_calls.begin(), function_symbol_calls.end());
+    std::sort(result.begin(), result.end(),
+              [](const std::pair<function_symbol, std::size_t>& x, const std::pair<function_symbol, std::size_t>& y)
+              {
+                return x.second > y.second;
+              });
+    return result;
+  }
+
+  static double seconds(std::chrono::steady_clock::duration d)
+  {
+    return std::chrono::duration<double>(d).count();
+  }
+
+  /// \brief Writes a human readable report.
+  void write_report(std::ostream& out) const
+  {
+    out << "rewrite calls: " << rewrite_calls << "\n";
+    out << "normal form hits: " << normal_form_hits << "\n";
+    out << "\nequations (time in seconds, attempts, successes, equation):\n";
+    for (const auto& p: sorted_equations())
+    {
+      out << std::fixed << std::setprecision(6) << std::setw(12) << seconds(p.second.time) << " "
+          << std::setw(12) << p.second.attempts << " " << std::setw(12) << p.second.successes << "  " << data::pp(p.first) << "\n";
+    }
+    out << "\nfunction symbols (rewrite steps, symbol):\n";
+    for (const auto& p: sorted_function_symbols())
+    {
+      out << std::setw(12) << p.second << "  " << data::pp(p.first) << ": " << data::pp(p.first.sort()) << "\n";
+    }
+  }
+
+  /// \brief Writes the profile in JSON format, with the equations and function symbols in the order of the report.
+  void write_json(std::ostream& out) const
+  {
+    out << "{\n  \"rewrite_calls\": " << rewrite_calls << ",\n  \"normal_form_hits\": " << normal_form_hits << ",\n  \"equations\": [";
+    bool first = true;
+    for (const auto& p: sorted_equations())
+    {
+      out << (first ? "\n" : ",\n") << "    {\"equation\": " << utilities::json_string(data::pp(p.first))
+          << ", \"attempts\": " << p.second.attempts << ", \"successes\": " << p.second.successes
+          << ", \"time\": " << std::setprecision(9) << seconds(p.second.time) << "}";
+      first = false;
+    }
+    out << "\n  ],\n  \"function_symbols\": [";
+    first = true;
+    for (const auto& p: sorted_function_symbols())
+    {
+      out << (first ? "\n" : ",\n") << "    {\"name\": " << utilities::json_string(data::pp(p.first))
+          << ", \"sort\": " << utilities::json_string(data::pp(p.first.sort())) << ", \"calls\": " << p.second << "}";
+      first = false;
+    }
+    out << "\n  ]\n}\n";
+  }
+
+  /// \brief Saves the profile to filename. If the extension of filename is .json the JSON format is used,
+  /// otherwise the report format.
+  void save(const std::string& filename) const
+  {
+    std::ofstream out(filename);
+    if (!out.good())
+    {
+      throw mcrl2::runtime_error("Could not write to filename " + filename);
+    }
+    const std::string extension = ".json";
+    if (filename.size() >= extension.size() && filename.compare(filename.size() - extension.size(), extension.size(), extension) == 0)
+    {
+      write_json(out);
+    }
+    else
+    {
+      write_report(out);
+    }
+  }
+};
+
+template <class T> // note, T is only a dummy
+struct rewrite_profile_pointer
+{
+  static rewrite_profile* profile;
+};
+
+template <class T>
+rewrite_profile* rewrite_profile_pointer<T>::profile = nullptr;
+
+/// \brief Returns the profile in which the rewriters record their statistics, or nullptr if profiling is disabled.
+inline
+rewrite_profile* active_rewrite_profile()
+{
+  return rewrite_profile_pointer<int>::profile;
+}
+
+/// \brief Returns the active profile if it records more than the number of rewrite calls, or nullptr otherwise.
+inline
+rewrite_profile* active_detailed_rewrite_profile()
+{
+  rewrite_profile* profile = active_rewrite_profile();
+  return profile && !profile->count_only ? profile : nullptr;
+}
+
+/// \brief Sets the profile in which the rewriters record their statistics. Profiling is disabled by
+/// passing nullptr. The rewriters do not synchronise access to the profile.
+inline
+void set_active_rewrite_profile(rewrite_profile* profile)
+{
+  rewrite_profile_pointer<int>::profile = profile;
+}
+
+} // namespace detail
+
+} // namespace data
+
+} // namespace mcrl2
+
+#endif // MCRL2_DATA_DETAIL_REWRITE_PROFILE_H
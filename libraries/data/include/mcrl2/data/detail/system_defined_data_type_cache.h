@@ -0,0 +1,97 @@
+// Author(s): Wieger Wesselink
+// Copyright: see the accompanying file COPYING or copy at
+// https://github.com/mCRL2org/mCRL2/blob/master/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file mcrl2/data/detail/system_defined_data_type_cache.h
+/// \brief A process wide cache of the generated data types of system defined sorts.
+
+#ifndef MCRL2_DATA_DETAIL_SYSTEM_DEFINED_DATA_TYPE_CACHE_H
+#define MCRL2_DATA_DETAIL_SYSTEM_DEFINED_DATA_TYPE_CACHE_H
+
+#include <map>
+#include <unordered_map>
+#include <unordered_set>
+#include "mcrl2/data/data_equation.h"
+#include "mcrl2/data/find.h"
+
+namespace mcrl2
+{
+
+namespace data
+{
+
+namespace detail
+{
+
+/// \brief The constructors, mappings and equations that are generated for a system defined sort,
+/// and all sort expressions that occur in them, including nested ones.
+struct system_defined_data_type
+{
+  function_symbol_vector constructors;
+  function_symbol_vector mappings;
+  data_equation_vector equations;
+  std::unordered_set<sort_expression, std::hash<atermpp::aterm> > sorts;
+
+  template <typename FunctionContainer, typename EquationContainer>
+  system_defined_data_type(const FunctionContainer& constructors_, const FunctionContainer& mappings_, const EquationContainer& equations_)
+    : constructors(constructors_.begin(), constructors_.end()),
+      mappings(mappings_.begin(), mappings_.end()),
+      equations(equations_.begin(), equations_.end())
+  {
+    auto out = std::inserter(sorts, sorts.end());
+    data::find_sort_expressions(constructors, out);
+    data::find_sort_expressions(mappings, out);
+    data::find_sort_expressions(equations, out);
+  }
+
+  /// \brief Returns true if normalising the sorts with respect to the given aliases does not change
+  /// the constructors, mappings and equations. This is the case if none of the sort expressions that
+  /// are rewritten by the aliases occurs in them.
+  bool is_normalised(const std::map<sort_expression, sort_expression>& normalised_aliases) const
+  {
+    for (const auto& p: normalised_aliases)
+    {
+      if (sorts.find(p.first) != sorts.end())
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+};
+
+template <class T> // note, T is only a dummy
+struct system_defined_data_type_map
+{
+  static std::unordered_map<sort_expression, system_defined_data_type, std::hash<atermpp::aterm> > map;
+};
+
+template <class T>
+std::unordered_map<sort_expression, system_defined_data_type, std::hash<atermpp::aterm> > system_defined_data_type_map<T>::map;
+
+/// \brief Returns the data type of the system defined sort, which is computed by generate(sort) the first
+/// time it is requested in this process. Since the generated data types do not depend on a data
+/// specification, they are shared by all data specifications.
+template <typename Generate>
+const system_defined_data_type& system_defined_data_type_cache(const sort_expression& sort, Generate generate)
+{
+  auto& map = system_defined_data_type_map<int>::map;
+  auto i = map.find(sort);
+  if (i == map.end())
+  {
+    i = map.emplace(sort, generate(sort)).first;
+  }
+  return i->second;
+}
+
+} // namespace detail
+
+} // namespace data
+
+} // namespace mcrl2
+
+#endif // MCRL2_DATA_DETAIL_SYSTEM_DEFINED_DATA_TYPE_CACHE_H
@@ -25,6 +25,7 @@
 #include <limits>
 #include <map>
 #include <sstream>
+#include <unordered_map>
 #include <utility>
 
 namespace mcrl2
@@ -338,6 +339,29 @@ class enumerator_algorithm
     /// \brief throw_exceptions If true, an exception is thrown when the enumeration is aborted.
     bool m_throw_exceptions;
 
+    /// \brief A constructor of a sort, together with the information that is needed to enumerate it.
+    struct enumerator_constructor
+    {
+      data::function_symbol constructor;
+
+      // The domain of the constructor, or the empty list if it is a constant.
+      data::sort_expression_list domain;
+
+      // The normal form of the constructor if it is a constant.
+      data::data_expression normal_form;
+
+      // True if the application of the constructor to variables is a normal form, in which
+      // case it does not need to be rewritten.
+      bool is_normal_form;
+
+      enumerator_constructor(const data::function_symbol& constructor_, const data::sort_expression_list& domain_, const data::data_expression& normal_form_, bool is_normal_form_)
+        : constructor(constructor_), domain(domain_), normal_form(normal_form_), is_normal_form(is_normal_form_)
+      {}
+    };
+
+    /// \brief The constructors of the sorts that have been enumerated so far.
+    mutable std::unordered_map<data::sort_expression, std::vector<enumerator_constructor>, std::hash<atermpp::aterm> > m_constructors;
+
     std::string print(const data::variable& x) const
     {
       std::ostringstream out;
@@ -360,6 +384,36 @@ class enumerator_algorithm
       }
     }
 
+    /// \brief Returns the constructors of the given sort.
+    /// \details The constructors are computed on the first call, using the substitution sigma.
+    /// Since the variables that are used for this are fresh, they are not affected by sigma.
+    template <typename MutableSubstitution>
+    const std::vector<enumerator_constructor>& constructors(const data::sort_expression& sort, MutableSubstitution& sigma) const
+    {
+      auto i = m_constructors.find(sort);
+      if (i != m_constructors.end())
+      {
+        return i->second;
+      }
+      std::vector<enumerator_constructor> result;
+      for (const data::function_symbol& constructor: dataspec.constructors(sort))
+      {
+        if (data::is_function_sort(constructor.sort()))
+        {
+          const data::sort_expression_list& domain = atermpp::down_cast<data::function_sort>(constructor.sort()).domain();
+          data::variable_list y(domain.begin(), domain.end(), [&](const data::sort_expression& s) { return data::variable(id_generator(), s); });
+          const data_expression cy = application(constructor, y.begin(), y.end());
+          result.emplace_back(constructor, domain, data_expression(), datar(cy, sigma) == cy);
+        }
+        else
+        {
+          // TODO: We want to apply datar without the substitution sigma, but that is currently an inefficient operation of data::rewriter.
+          result.emplace_back(constructor, data::sort_expression_list(), datar(constructor, sigma), true);
+        }
+      }
+      return m_constructors.emplace(sort, std::move(result)).first->second;
+    }
+
     // add element without additional variables
     template <typename EnumeratorListElement, typename MutableSubstitution, typename Filter, typename Expression>
     void add_element(std::deque<EnumeratorListElement>& P,
@@ -454,11 +508,30 @@ class enumerator_algorithm
     {
       assert(!P.empty());
 
-      auto p = P.front();
+      // The front element is not copied. New elements are added at the back of P, which does not
+      // invalidate references to p.
+      // If an exception is thrown, the front element is removed as well.
+      auto& p = P.front();
+      try
+      {
+        enumerate_element(P, p, sigma, accept);
+      }
+      catch (...)
+      {
+        P.pop_front();
+        throw;
+      }
+      P.pop_front();
+    }
+
+    /// \brief Enumerates the first variable of the element p, and adds the resulting elements to P.
+    /// \pre p is not an element of P, or it is the front element of P.
+    template <typename EnumeratorListElement, typename MutableSubstitution, typename Filter>
+    void enumerate_element(std::deque<EnumeratorListElement>& P, EnumeratorListElement& p, MutableSubstitution& sigma, Filter accept) const
+    {
       auto const& v = p.variables();
       auto const& phi = p.expression();
       //mCRL2log(log::debug) << "  <process-element> " << p << std::endl;
-      P.pop_front();
 
       auto const& v1 = v.front();
       auto const& vtail = v.tail();
@@ -547,28 +620,28 @@ class enumerator_algorithm
       }
       else
       {
-        auto const& C = dataspec.constructors(sort);
+        auto const& C = constructors(sort, sigma);
         if (!C.empty())
         {
-          for (auto i = C.begin(); i != C.end(); ++i)
+          for (const enumerator_constructor& c: C)
           {
-            auto const& constructor = *i;
-            if (data::is_function_sort(constructor.sort()))
+            if (!c.domain.empty())
             {
-              auto const& domain = atermpp::down_cast<data::function_sort>(constructor.sort()).domain();
-              data::variable_list y(domain.begin(), domain.end(), [&](const data::sort_expression& s) { return data::variable(id_generator(), s); });
-              // TODO: We want to apply datar without the substitution sigma, but that is currently an inefficient operation of data::rewriter.
-              data_expression cy = datar(application(constructor, y.begin(), y.end()), sigma);
+              data::variable_list y(c.domain.begin(), c.domain.end(), [&](const data::sort_expression& s) { return data::variable(id_generator(), s); });
+              data_expression cy = application(c.constructor, y.begin(), y.end());
+              if (!c.is_normal_form)
+              {
+                // TODO: We want to apply datar without the substitution sigma, but that is currently an inefficient operation of data::rewriter.
+                cy = datar(cy, sigma);
+              }
               sigma[v1] = cy;
               add_element(P, sigma, accept, vtail, y, phi, p, v1, cy);
               sigma[v1] = v1;
             }
             else
             {
-              // TODO: We want to apply datar without the substitution sigma, but that is currently an inefficient operation of data::rewriter.
-              auto const e1 = datar(constructor, sigma);
-              sigma[v1] = e1;
-              add_element(P, sigma, accept, vtail, phi, p, v1, e1);
+              sigma[v1] = c.normal_form;
+              add_element(P, sigma, accept, vtail, phi, p, v1, c.normal_form);
               sigma[v1] = v1;
             }
           }
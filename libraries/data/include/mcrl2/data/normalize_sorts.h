@@ -15,6 +15,7 @@
 #include "mcrl2/data/builder.h"
 #include "mcrl2/data/sort_specification.h"
 #include <functional>
+#include <unordered_map>
 
 namespace mcrl2
 {
@@ -31,27 +32,45 @@ struct normalize_sorts_builder: public sort_expression_builder<normalize_sorts_b
   using super::apply;
 
   const std::map<sort_expression, sort_expression>& m_normalized_aliases;
+  std::unordered_map<sort_expression, sort_expression, std::hash<atermpp::aterm> >& m_cache;
 
   normalize_sorts_builder(const data::sort_specification& sortspec)
-    : m_normalized_aliases(sortspec.sort_alias_map())
+    : m_normalized_aliases(sortspec.sort_alias_map()),
+      m_cache(sortspec.normalised_sort_cache())
   {}
 
   sort_expression apply(const sort_expression& x)
   {
+    // Without aliases every sort is in normal form.
+    if (m_normalized_aliases.empty())
+    {
+      return x;
+    }
+    auto c = m_cache.find(x);
+    if (c != m_cache.end())
+    {
+      return c->second;
+    }
+
+    sort_expression result;
     auto i = m_normalized_aliases.find(x);
     if (i != m_normalized_aliases.end())
     {
-      return i->second;
+      result = i->second;
     }
-    sort_expression result = super::apply(x);
-
-    // Rewrite result to normal form.
-    auto j = m_normalized_aliases.find(result);
-    if (j != m_normalized_aliases.end())
+    else
     {
-      result = apply(j->second);
+      result = super::apply(x);
+
+      // Rewrite result to normal form.
+      auto j = m_normalized_aliases.find(result);
+      if (j != m_normalized_aliases.end())
+      {
+        result = apply(j->second);
+      }
     }
 
+    m_cache[x] = result;
     return result;
   }
 };
@@ -78,6 +97,10 @@ void normalize_sorts(T& x,
                      typename std::enable_if< !std::is_base_of<atermpp::aterm, T>::value >::type* = nullptr
                     )
 {
+  if (sortspec.sort_alias_map().empty())
+  {
+    return;
+  }
   core::make_update_apply_builder<data::sort_expression_builder>
   (data::detail::normalize_sorts_function(sortspec)).update(x);
 }
@@ -88,6 +111,10 @@ T normalize_sorts(const T& x,
                   typename std::enable_if< std::is_base_of<atermpp::aterm, T>::value >::type* = nullptr
                  )
 {
+  if (sortspec.sort_alias_map().empty())
+  {
+    return x;
+  }
   return core::make_update_apply_builder<data::sort_expression_builder>
          (data::detail::normalize_sorts_function(sortspec)).apply(x);
 }
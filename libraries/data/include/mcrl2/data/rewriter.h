@@ -15,8 +15,12 @@
 // TODO: this include should not be necessary, it is a problem in the design of the data library
 #include "mcrl2/data/expression_traits.h"
 
+#include <memory>
+#include <unordered_map>
+#include <vector>
 #include "mcrl2/data/data_specification.h"
 #include "mcrl2/data/detail/rewrite.h"
+#include "mcrl2/data/find.h"
 #include "mcrl2/data/substitutions/mutable_indexed_substitution.h"
 
 namespace mcrl2
@@ -45,6 +49,67 @@ class rewriter
     /// \brief The type for the substitution that is used internally.
     typedef data::mutable_indexed_substitution<> substitution_type;
 
+  protected:
+    /// \brief A substitution that is reused by the functions that do not get a substitution_type,
+    /// such that it does not need to be constructed for every call. Between calls it is the identity.
+    mutable substitution_type m_sigma;
+
+    /// \brief True while m_sigma is used. A nested call, e.g. from a substitution function that
+    /// uses this rewriter, then uses a local substitution.
+    mutable bool m_sigma_in_use = false;
+
+    /// \brief The free variables of terms that were rewritten with an arbitrary substitution function.
+    mutable std::unordered_map<data_expression, std::shared_ptr<const std::vector<variable> > > m_free_variables;
+
+    /// \brief The maximal number of terms of which the free variables are stored.
+    static std::size_t free_variables_cache_size()
+    {
+      return 10000;
+    }
+
+    /// \brief Returns the free variables of x.
+    std::shared_ptr<const std::vector<variable> > free_variables(const data_expression& x) const
+    {
+      auto i = m_free_variables.find(x);
+      if (i != m_free_variables.end())
+      {
+        return i->second;
+      }
+      if (m_free_variables.size() >= free_variables_cache_size())
+      {
+        m_free_variables.clear();
+      }
+      const std::set<variable> variables = data::find_free_variables(x);
+      std::shared_ptr<const std::vector<variable> > result = std::make_shared<const std::vector<variable> >(variables.begin(), variables.end());
+      m_free_variables[x] = result;
+      return result;
+    }
+
+    /// \brief Rewrites x with m_sigma, and restores m_sigma to the identity afterwards.
+    /// \pre The variables in m_sigma that are not mapped to themselves are in variables.
+    data_expression rewrite_with_shared_substitution(const data_expression& x, const std::vector<variable>& variables) const
+    {
+      m_sigma_in_use = true;
+      try
+      {
+        data_expression result = m_rewriter->rewrite(x, m_sigma);
+        for (const variable& v: variables)
+        {
+          m_sigma[v] = v;
+        }
+        m_sigma.clear_variables_in_rhs();
+        m_sigma_in_use = false;
+        return result;
+      }
+      catch (...)
+      {
+        m_sigma.clear();
+        m_sigma_in_use = false;
+        throw;
+      }
+    }
+
+  public:
     /// \brief The type for expressions manipulated by the rewriter.
     typedef data_expression term_type;
 
@@ -82,11 +147,14 @@ class rewriter
     /// \brief Rewrites a data expression.
     /// \param[in] x A data expression
     /// \return The normal form of x.
-    /// N.B. This function is extremely inefficient, due to limitations of the detail::Rewriter class.
     data_expression operator()(const data_expression& x) const
     {
-      substitution_type sigma;
-      return m_rewriter->rewrite(x, sigma);
+      if (m_sigma_in_use)
+      {
+        substitution_type sigma;
+        return m_rewriter->rewrite(x, sigma);
+      }
+      return rewrite_with_shared_substitution(x, std::vector<variable>());
     }
 
     /// \brief Rewrites the data expression x, and on the fly applies a substitution
@@ -94,16 +162,38 @@ class rewriter
     /// \param[in] x A data expression
     /// \param[in] sigma A substitution function
     /// \return The normal form of the term.
-    /// N.B. This function is extremely inefficient, due to limitations of the detail::Rewriter class.
+    /// N.B. The detail::Rewriter class only accepts a substitution_type. Therefore sigma is copied
+    /// to a substitution_type for the free variables of x. These are cached per term, and the
+    /// substitution_type is reused between calls.
     template <typename SubstitutionFunction>
     data_expression operator()(const data_expression& x, const SubstitutionFunction& sigma) const
     {
-      substitution_type sigma_copy;
-      for(const variable& v: data::find_free_variables(x))
+      const std::shared_ptr<const std::vector<variable> > variables = free_variables(x);
+      if (m_sigma_in_use)
+      {
+        substitution_type sigma_copy;
+        for (const variable& v: *variables)
+        {
+          sigma_copy[v] = sigma(v);
+        }
+        return m_rewriter->rewrite(x, sigma_copy);
+      }
+
+      m_sigma_in_use = true;
+      try
+      {
+        for (const variable& v: *variables)
+        {
+          m_sigma[v] = sigma(v);
+        }
+      }
+      catch (...)
       {
-        sigma_copy[v] = sigma(v);
+        m_sigma.clear();
+        m_sigma_in_use = false;
+        throw;
       }
-      return m_rewriter->rewrite(x, sigma_copy);
+      return rewrite_with_shared_substitution(x, *variables);
     }
 
     /// \brief Rewrites the data expression x, and on the fly applies a substitution
@@ -13,6 +13,7 @@
 #ifndef MCRL2_DATA_SORT_SPECIFICATION_H
 #define MCRL2_DATA_SORT_SPECIFICATION_H
 
+#include <unordered_map>
 #include "mcrl2/utilities/logger.h"
 
 #include "mcrl2/data/find.h"
@@ -93,6 +94,10 @@ class sort_specification
     /// \brief Table containing how sorts should be mapped to normalised sorts.
     mutable std::map< sort_expression, sort_expression > m_normalised_aliases;
 
+    /// \brief The normal forms of sort expressions with respect to m_normalised_aliases that
+    ///        have been computed so far. It is cleared when m_normalised_aliases changes.
+    mutable std::unordered_map< sort_expression, sort_expression, std::hash<atermpp::aterm> > m_normalised_sort_cache;
+
   public:
 
     /// \brief Default constructor
@@ -266,6 +271,15 @@ class sort_specification
       return m_normalised_aliases;
     }
 
+    /// \brief Gets the normal forms of sort expressions that have been computed by normalize_sorts.
+    /// \details The table is only valid for the current sort_alias_map(), and is cleared when it changes.
+    ///    It is modified by normalize_sorts, which is therefore not thread safe.
+    std::unordered_map< sort_expression, sort_expression, std::hash<atermpp::aterm> >& normalised_sort_cache() const
+    {
+      normalise_sort_specification_if_required();
+      return m_normalised_sort_cache;
+    }
+
     bool operator==(const sort_specification& other) const
     {
       return m_user_defined_sorts==other.m_user_defined_sorts &&
@@ -292,7 +306,12 @@ class sort_specification
       {
         m_normalised_sorts_are_up_to_date=true;
         m_normalised_sorts.clear();
+        const std::map< sort_expression, sort_expression > previous_aliases = std::move(m_normalised_aliases);
         reconstruct_m_normalised_aliases();
+        if (m_normalised_aliases != previous_aliases)
+        {
+          m_normalised_sort_cache.clear();
+        }
         for (const sort_expression& s: m_sorts_in_context)
         {
           m_normalised_sorts.insert(normalize_sorts(s,*this));
@@ -423,7 +442,7 @@ class sort_specification
     // is thrown.
     void check_for_alias_loop(
       const sort_expression& s,
-      std::set<sort_expression> sorts_already_seen,
+      std::set<sort_expression>& sorts_already_seen,
       const bool toplevel=true) const;
 
 
@@ -209,6 +209,16 @@ public:
     m_variables_in_rhs.clear();
   }
 
+  /// \brief Forgets the variables that occur in the right hand sides of the assignments. They are
+  ///        computed again when variables_in_rhs is called.
+  /// \details After removing assignments the set of these variables may be too large. Calling this
+  ///          function when all assignments have been removed avoids that.
+  void clear_variables_in_rhs()
+  {
+    m_variables_in_rhs_set_is_defined=false;
+    m_variables_in_rhs.clear();
+  }
+
   /// \brief Compare substitutions
   template <typename Substitution>
   bool operator==(const Substitution&) const
@@ -376,6 +386,16 @@ public:
     m_variables_in_rhs.clear();
   }
 
+  /// \brief Forgets the variables that occur in the right hand sides of the assignments. They are
+  ///        computed again when variables_in_rhs is called.
+  /// \details After removing assignments the set of these variables may be too large. Calling this
+  ///          function when all assignments have been removed avoids that.
+  void clear_variables_in_rhs()
+  {
+    m_variables_in_rhs_set_is_defined=false;
+    m_variables_in_rhs.clear();
+  }
+
   /// \brief Compare substitutions
   template <typename Substitution>
   bool operator==(const Substitution&) const
@@ -42,8 +42,8 @@ atermpp::aterm_appl data_specification_to_aterm(const data_specification& s)
   return atermpp::aterm_appl(core::detail::function_symbol_DataSpec(),
            atermpp::aterm_appl(core::detail::function_symbol_SortSpec(), atermpp::aterm_list(s.user_defined_sorts().begin(),s.user_defined_sorts().end()) +
                               atermpp::aterm_list(s.user_defined_aliases().begin(),s.user_defined_aliases().end())),
-           atermpp::aterm_appl(core::detail::function_symbol_ConsSpec(), atermpp::aterm_list(s.m_user_defined_constructors.begin(),s.m_user_defined_constructors.end())),
-           atermpp::aterm_appl(core::detail::function_symbol_MapSpec(), atermpp::aterm_list(s.m_user_defined_mappings.begin(),s.m_user_defined_mappings.end())),
+           atermpp::aterm_appl(core::detail::function_symbol_ConsSpec(), atermpp::aterm_list(s.m_user_defined_constructors.functions.begin(),s.m_user_defined_constructors.functions.end())),
+           atermpp::aterm_appl(core::detail::function_symbol_MapSpec(), atermpp::aterm_list(s.m_user_defined_mappings.functions.begin(),s.m_user_defined_mappings.functions.end())),
            atermpp::aterm_appl(core::detail::function_symbol_DataEqnSpec(), atermpp::aterm_list(s.m_user_defined_equations.begin(),s.m_user_defined_equations.end())));
 }
 } // namespace detail
@@ -174,7 +174,7 @@ bool data_specification::is_certainly_finite(const sort_expression& s) const
 // is thrown.
 void sort_specification::check_for_alias_loop(
   const sort_expression& s,
-  std::set<sort_expression> sorts_already_seen,
+  std::set<sort_expression>& sorts_already_seen,
   const bool toplevel) const
 {
   if (is_basic_sort(s))
@@ -236,13 +236,14 @@ void sort_specification::check_for_alias_loop(
 // This function returns the normal form of e, under the two maps map1 and map2.
 // This normal form is obtained by repeatedly applying map1 and map2, until this
 // is not possible anymore. It is assumed that this procedure terminates. There is
-// no check for loops.
+// no check for loops, except for an assertion on the sorts in sorts_already_seen,
+// which is only maintained in debug mode.
 static
 sort_expression find_normal_form(
   const sort_expression& e,
   const std::multimap< sort_expression, sort_expression >& map1,
   const std::multimap< sort_expression, sort_expression >& map2,
-  std::set < sort_expression > sorts_already_seen = std::set < sort_expression >())
+  std::set < sort_expression >& sorts_already_seen)
 {
   assert(sorts_already_seen.find(e)==sorts_already_seen.end()); // e has not been seen already.
   assert(!is_untyped_sort(e));
@@ -301,27 +302,23 @@ sort_expression find_normal_form(
 
 
   assert(is_basic_sort(result_sort) || is_structured_sort(result_sort));
-  const std::multimap< sort_expression, sort_expression >::const_iterator i1=map1.find(result_sort);
-  if (i1!=map1.end()) // found
+  std::multimap< sort_expression, sort_expression >::const_iterator i=map1.find(result_sort);
+  if (i==map1.end()) // not found
   {
+    i=map2.find(result_sort);
+    if (i==map2.end()) // not found
+    {
+      return result_sort;
+    }
+  }
 #ifndef NDEBUG
-    sorts_already_seen.insert(result_sort);
+  sorts_already_seen.insert(result_sort);
 #endif
-   return find_normal_form(i1->second,map1,map2
-                           ,sorts_already_seen
-                          );
- }
- const std::multimap< sort_expression, sort_expression >::const_iterator i2=map2.find(result_sort);
- if (i2!=map2.end()) // found
- {
+  const sort_expression normal_form=find_normal_form(i->second,map1,map2,sorts_already_seen);
 #ifndef NDEBUG
-    sorts_already_seen.insert(result_sort);
+  sorts_already_seen.erase(result_sort);
 #endif
-    return find_normal_form(i2->second,map1,map2,
-                            sorts_already_seen
-                           );
-  }
-  return result_sort;
+  return normal_form;
 }
 
 // The function below recalculates m_normalised_aliases, such that
@@ -429,9 +426,10 @@ void sort_specification::reconstruct_m_normalised_aliases() const
   // right hand side to normal form.
 
   const std::multimap< sort_expression, sort_expression > empty_multimap;
+  std::set < sort_expression > sorts_already_seen;
   for(const std::pair< sort_expression,sort_expression>& p: resulting_normalized_sort_aliases)
   {
-    m_normalised_aliases[p.first]=find_normal_form(p.second,resulting_normalized_sort_aliases,empty_multimap);
+    m_normalised_aliases[p.first]=find_normal_form(p.second,resulting_normalized_sort_aliases,empty_multimap,sorts_already_seen);
     assert(p.first!=p.second);
   }
 }
@@ -26,6 +26,7 @@
 #include "mcrl2/core/detail/function_symbols.h"
 #include "mcrl2/data/substitutions/mutable_map_substitution.h"
 #include "mcrl2/data/replace.h"
+#include "mcrl2/data/detail/rewrite_profile.h"
 
 #ifdef MCRL2_DISPLAY_REWRITE_STATISTICS
 #include "mcrl2/data/detail/rewrite_statistics.h"
@@ -624,6 +625,11 @@ data_expression RewriterJitty::rewrite_aux(
     {
       assert(terma.size()==1);
       assert(remove_normal_form_function(terma[0])==terma[0]);
+      rewrite_profile* profile = active_detailed_rewrite_profile();
+      if (profile)
+      {
+        profile->normal_form_hits++;
+      }
       return terma[0];
     }
   }
@@ -716,6 +722,12 @@ data_expression RewriterJitty::rewrite_aux_function_symbol(
 
   const std::size_t arity=(is_function_symbol(term)?0:detail::recursive_number_of_args(term));
 
+  rewrite_profile* profile = active_detailed_rewrite_profile();
+  if (profile)
+  {
+    profile->function_symbol_calls[op]++;
+  }
+
   data_expression* rewritten = MCRL2_SPECIFIC_STACK_ALLOCATOR(data_expression, arity);
   bool* rewritten_defined = MCRL2_SPECIFIC_STACK_ALLOCATOR(bool, arity);
 
@@ -767,6 +779,7 @@ data_expression RewriterJitty::rewrite_aux_function_symbol(
         {
           break;
         }
+        rewrite_profile::equation_attempt attempt(profile, rule1);
 
         assert(no_assignments==0);
 
@@ -787,6 +800,7 @@ data_expression RewriterJitty::rewrite_aux_function_symbol(
           if (rule1.condition()==sort_bool::true_() || rewrite_aux(
                    subst_values(vars,terms,variable_is_in_normal_form,no_assignments,rule1.condition(),m_generator),sigma)==sort_bool::true_())
           {
+            attempt.success();
             const data_expression& rhs=rule1.rhs();
 
             if (arity == rule_arity)
@@ -889,6 +903,11 @@ data_expression RewriterJitty::rewrite(
 #ifdef MCRL2_DISPLAY_REWRITE_STATISTICS
   data::detail::increment_rewrite_count();
 #endif
+  rewrite_profile* profile = active_rewrite_profile();
+  if (profile)
+  {
+    profile->rewrite_calls++;
+  }
   const data_expression& t=rewrite_aux(term, sigma);
   assert(remove_normal_form_function(t)==t);
   return t;
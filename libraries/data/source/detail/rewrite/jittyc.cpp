@@ -38,6 +38,7 @@
 #include "mcrl2/data/replace.h"
 #include "mcrl2/data/traverser.h"
 #include "mcrl2/data/substitutions/mutable_map_substitution.h"
+#include "mcrl2/data/detail/rewrite_profile.h"
 
 #ifdef MCRL2_DISPLAY_REWRITE_STATISTICS
 #include "mcrl2/data/detail/rewrite_statistics.h"
@@ -2731,6 +2732,11 @@ data_expression RewriterCompilingJitty::rewrite(
 #ifdef MCRL2_DISPLAY_REWRITE_STATISTICS
   data::detail::increment_rewrite_count();
 #endif
+  rewrite_profile* profile = active_rewrite_profile();
+  if (profile)
+  {
+    profile->rewrite_calls++;
+  }
   // Save global sigma and restore it afterwards, as rewriting might be recursive with different
   // substitutions, due to the enumerator.
   substitution_type *saved_sigma=global_sigma;
@@ -964,6 +964,79 @@ void test_standard_sorts_mappings_functions()
    BOOST_CHECK(mappings.size()==225);
 }
 
+// Returns true if all sorts occurring in the constructors, mappings and equations of spec are normalised.
+bool sorts_are_normalised(const data_specification& spec)
+{
+  std::set<sort_expression> sorts;
+  find_sort_expressions(spec.constructors(), std::inserter(sorts, sorts.end()));
+  find_sort_expressions(spec.mappings(), std::inserter(sorts, sorts.end()));
+  find_sort_expressions(spec.equations(), std::inserter(sorts, sorts.end()));
+  for (const sort_expression& s: sorts)
+  {
+    if (normalize_sorts(s, spec) != s)
+    {
+      std::cerr << "sort " << data::pp(s) << " is not normalised" << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+// The generated data types of system defined sorts are shared between specifications, but they
+// must be normalised with respect to the aliases of each specification.
+void test_system_defined_data_type_cache()
+{
+  data_specification spec1 = parse_data_specification("map f: List(Nat) # Set(Bool) -> Bool;");
+  BOOST_CHECK(sorts_are_normalised(spec1));
+
+  data_specification spec2 = parse_data_specification("sort L = List(Nat); S = Set(Bool); map f: L # S -> Bool;");
+  BOOST_CHECK(sorts_are_normalised(spec2));
+
+  data_specification spec3 = parse_data_specification("map f: List(Nat) # Set(Bool) -> Bool;");
+  BOOST_CHECK(spec1.constructors() == spec3.constructors());
+  BOOST_CHECK(spec1.mappings() == spec3.mappings());
+  BOOST_CHECK(spec1.equations() == spec3.equations());
+}
+
+// Checks that adding and removing functions to a normalised specification gives the same result as
+// normalising the specification from scratch.
+void test_incremental_normalisation()
+{
+  basic_sort s("S");
+  function_symbol c("c", s);
+  function_symbol f("f", make_function_sort(s, sort_nat::nat()));
+  function_symbol g("g", make_function_sort(sort_nat::nat(), s));
+
+  data_specification spec1;
+  spec1.add_sort(s);
+  spec1.add_mapping(f);
+  spec1.add_mapping(g);
+  spec1.add_constructor(c);
+  BOOST_CHECK(spec1.constructors(s) == function_symbol_vector({ c }));
+  const std::size_t size = spec1.mappings(s).size();
+
+  // The sorts of f and g are already present, so they are added to the normalised specification.
+  spec1.remove_mapping(g);
+  spec1.remove_mapping(f);
+  BOOST_CHECK(spec1.mappings(s).size() == size - 1);
+  spec1.add_mapping(f);
+  spec1.add_mapping(g);
+  spec1.add_mapping(g);
+  BOOST_CHECK(spec1.mappings(s).size() == size);
+  BOOST_CHECK(std::count(spec1.mappings().begin(), spec1.mappings().end(), g) == 1);
+
+  data_specification spec2;
+  spec2.add_sort(s);
+  spec2.add_mapping(f);
+  spec2.add_mapping(g);
+  spec2.add_constructor(c);
+  BOOST_CHECK(spec1 == spec2);
+
+  spec1.remove_constructor(c);
+  BOOST_CHECK(spec1.constructors(s).empty());
+  BOOST_CHECK(spec1.user_defined_constructors().empty());
+}
+
 int test_main(int argc, char** argv)
 {
   test_bke();
@@ -996,6 +1069,10 @@ int test_main(int argc, char** argv)
 
   test_standard_sorts_mappings_functions();
 
+  test_system_defined_data_type_cache();
+
+  test_incremental_normalisation();
+
   return EXIT_SUCCESS;
 }
 
@@ -359,6 +359,52 @@ BOOST_AUTO_TEST_CASE(constructors_that_are_not_a_normal_form_test)
   enumerate(dataspec_text, variable_text, expression_text, free_variable_text, number_of_solutions, more_solutions_possible);
 }
 
+// The application of the constructor c to variables is not a normal form.
+BOOST_AUTO_TEST_CASE(constructor_applications_that_are_not_a_normal_form_test)
+{
+  std::string dataspec_text =
+    "sort D;            \n"
+    "cons a: D;         \n"
+    "     c: Bool -> D; \n"
+    "var  b: Bool;      \n"
+    "eqn  c(b) = a;     \n"
+    ;
+  std::string variable_text = "x: D;";
+  std::string expression_text = "x == a";
+  const std::string& free_variable_text = variable_text;
+  std::size_t number_of_solutions = 3;
+  bool more_solutions_possible = false;
+  enumerate(dataspec_text, variable_text, expression_text, free_variable_text, number_of_solutions, more_solutions_possible);
+}
+
+// The constructors of a sort are computed once by an enumerator. Check that they can be used
+// for several enumerations.
+BOOST_AUTO_TEST_CASE(reuse_enumerator_test)
+{
+  typedef enumerator_list_element_with_substitution<> enumerator_element;
+  typedef enumerator_algorithm_with_iterator<> enumerator_type;
+
+  data_specification dataspec = parse_data_specification("sort D = struct d1(Bool) | d2(Bool, Bool) | d3;");
+  variable_list variables = parse_variable_list("x: D; y: D;", dataspec);
+  rewriter rewr(dataspec);
+  data::enumerator_identifier_generator id_generator;
+  enumerator_type enumerator(rewr, dataspec, rewr, id_generator);
+  mutable_indexed_substitution<> sigma;
+
+  for (const std::string& text: { "true", "x != y", "x == y" })
+  {
+    data_expression phi = parse_data_expression(text, variables, dataspec);
+    std::size_t count = 0;
+    std::deque<enumerator_element> P(1, enumerator_element(variables, phi));
+    for (auto i = enumerator.begin(sigma, P); i != enumerator.end(); ++i)
+    {
+      count++;
+    }
+    std::size_t expected = text == std::string("true") ? 49 : text == std::string("x != y") ? 42 : 7;
+    BOOST_CHECK_EQUAL(count, expected);
+  }
+}
+
 BOOST_AUTO_TEST_CASE(cannot_enumerate_real_default)
 {
   typedef data::enumerator_list_element<data_expression> enumerator_element;
@@ -428,6 +474,34 @@ BOOST_AUTO_TEST_CASE(cannot_enumerate_real_with_substitution)
   BOOST_CHECK(false);
 }
 
+// The element that cannot be enumerated must be removed from P when an exception is thrown.
+BOOST_AUTO_TEST_CASE(cannot_enumerate_removes_element)
+{
+  typedef data::enumerator_list_element<data_expression> enumerator_element;
+
+  data::data_specification dataspec;
+  dataspec.add_context_sort(data::sort_real::real_());
+  data::rewriter R(dataspec);
+  data::variable_list r = { data::variable("r", data::sort_real::real_()) };
+  data::variable_list b = { data::variable("b", data::sort_bool::bool_()) };
+  data::enumerator_identifier_generator id_generator;
+  data::enumerator_algorithm<> E(R, dataspec, R, id_generator, (std::numeric_limits<std::size_t>::max)(), true);
+  std::deque<enumerator_element> P;
+  P.push_back(enumerator_element(r, parse_data_expression("r == r", r)));
+  P.push_back(enumerator_element(b, parse_data_expression("b", b)));
+  data::rewriter::substitution_type sigma;
+
+  BOOST_CHECK_THROW(E.enumerate_front(P, sigma, data::is_not_false()), mcrl2::runtime_error);
+  BOOST_REQUIRE_EQUAL(P.size(), 1u);
+  BOOST_CHECK_EQUAL(P.front().variables(), b);
+
+  // The remaining element can still be enumerated.
+  E.enumerate_front(P, sigma, data::is_not_false());
+  BOOST_REQUIRE_EQUAL(P.size(), 1u);
+  BOOST_CHECK(P.front().variables().empty());
+  BOOST_CHECK_EQUAL(P.front().expression(), data::sort_bool::true_());
+}
+
 boost::unit_test::test_suite* init_unit_test_suite(int argc, char* argv[])
 {
   return nullptr;
@@ -46,9 +46,31 @@ void test_normalize_sorts()
   data::normalize_sorts(equations, dataspec);
 }
 
+// The normal forms of sorts are cached in the specification. Check that they are recomputed
+// when an alias is added.
+void test_normalize_sorts_after_adding_alias()
+{
+  basic_sort A("A");
+  basic_sort B("B");
+  basic_sort C("C");
+  data_specification dataspec;
+  dataspec.add_sort(C);
+  dataspec.add_alias(alias(A, sort_nat::nat()));
+  BOOST_CHECK(normalize_sorts(sort_list::list(A), dataspec) == sort_list::list(sort_nat::nat()));
+  BOOST_CHECK(normalize_sorts(make_function_sort(B, A), dataspec) == make_function_sort(B, sort_nat::nat()));
+
+  dataspec.add_alias(alias(B, C));
+  BOOST_CHECK(normalize_sorts(make_function_sort(B, A), dataspec) == make_function_sort(C, sort_nat::nat()));
+
+  // A copy keeps the normal forms of the original.
+  data_specification copy = dataspec;
+  BOOST_CHECK(normalize_sorts(sort_set::set_(B), copy) == sort_set::set_(C));
+}
+
 int test_main(int argc, char* argv[])
 {
   test_normalize_sorts();
+  test_normalize_sorts_after_adding_alias();
 
   return 0;
 }
@@ -11,6 +11,7 @@
 
 #include "mcrl2/data/detail/data_functional.h"
 #include "mcrl2/data/detail/one_point_rule_preprocessor.h"
+#include "mcrl2/data/detail/rewrite_profile.h"
 #include "mcrl2/data/detail/parse_substitution.h"
 #include "mcrl2/data/detail/test_rewriters.h"
 #include "mcrl2/data/find.h"
@@ -20,11 +21,14 @@
 #include "mcrl2/data/print.h"
 #include "mcrl2/data/rewriter.h"
 #include "mcrl2/data/rewriters/simplify_rewriter.h"
+#include "mcrl2/data/substitutions/mutable_map_substitution.h"
 #include "mcrl2/utilities/text_utility.h"
 #include <boost/test/minimal.hpp>
 #include <iostream>
+#include <map>
 #include <memory>
 #include <set>
+#include <sstream>
 #include <string>
 
 using namespace mcrl2;
@@ -230,6 +234,103 @@ void test_equality_on_functions()
   test_expressions(R, expr1, expr2, "", data_spec, sigma);
 }
 
+// A substitution function that rewrites its right hand sides with the rewriter that uses it.
+struct rewriting_substitution
+{
+  const data::rewriter& R;
+  const data::mutable_map_substitution<>& sigma;
+
+  rewriting_substitution(const data::rewriter& R_, const data::mutable_map_substitution<>& sigma_)
+    : R(R_), sigma(sigma_)
+  { }
+
+  data_expression operator()(const variable& v) const
+  {
+    return R(sigma(v));
+  }
+};
+
+// Rewriting with an arbitrary substitution function must give the same results as rewriting with
+// a substitution_type, also when the rewriter is used repeatedly and from within the substitution.
+void test_generic_substitution()
+{
+  data_specification data_spec;
+  data_spec.add_context_sort(sort_nat::nat());
+  data::rewriter R(data_spec);
+
+  data::variable_list variables = parse_variables("m, n: Nat; f: Nat -> Nat;");
+  variable m = atermpp::down_cast<variable>(parse_data_expression("m", variables));
+  variable n = atermpp::down_cast<variable>(parse_data_expression("n", variables));
+  std::vector<data_expression> expressions = {
+    parse_data_expression("m + n", variables),
+    parse_data_expression("m * 2 + m", variables),
+    parse_data_expression("(lambda m: Nat. m + n)(3) + m", variables),
+    parse_data_expression("exists k: Nat. k == m && k < n", variables),
+    parse_data_expression("f(m)", variables)
+  };
+
+  for (std::size_t i = 0; i < 20; i++)
+  {
+    data::mutable_map_substitution<> sigma;
+    // The rewriter expects the right hand sides of a substitution to be in normal form.
+    sigma[m] = R(parse_data_expression(std::to_string(i) + " + 1", variables));
+    if (i % 2 == 0)
+    {
+      sigma[n] = R(parse_data_expression(std::to_string(2 * i), variables));
+    }
+    for (const data_expression& x: expressions)
+    {
+      data::rewriter::substitution_type sigma1;
+      for (const variable& v: data::find_free_variables(x))
+      {
+        sigma1[v] = sigma(v);
+      }
+      data_expression expected = R(x, sigma1);
+      BOOST_CHECK(R(x, sigma) == expected);
+      BOOST_CHECK(R(x, rewriting_substitution(R, sigma)) == expected);
+
+      // The shared substitution must be the identity again.
+      BOOST_CHECK(R(x) == R(x, data::mutable_map_substitution<>()));
+    }
+  }
+}
+
+void test_rewrite_profile()
+{
+  std::string DATA_SPEC1 =
+    "map f: Nat -> Nat;\n"
+    "var n: Nat;\n"
+    "eqn f(0) = 0;\n"
+    "    n > 0 -> f(n) = f(Int2Nat(n - 1));\n"
+    ;
+  data_specification data_spec = parse_data_specification(DATA_SPEC1);
+  data::rewriter R(data_spec, data::jitty);
+  data_expression x = parse_data_expression("f(3)", data_spec);
+  data::detail::rewrite_profile profile;
+  data::detail::set_active_rewrite_profile(&profile);
+  data_expression result = R(x);
+  data::detail::set_active_rewrite_profile(nullptr);
+  R(x);
+
+  BOOST_CHECK(result == R(parse_data_expression("0")));
+  BOOST_CHECK(profile.rewrite_calls == 1);
+
+  // The rewriter uses its own copies of the equations, so they are looked up by their printed form.
+  std::map<std::string, data::detail::rewrite_profile::equation_statistics> equations;
+  for (const auto& p: profile.equations)
+  {
+    equations[data::pp(p.first)] = p.second;
+  }
+  BOOST_CHECK(equations["n > 0  ->  f(n)  =  f(Int2Nat(n - 1))"].successes == 3);
+  BOOST_CHECK(equations["n > 0  ->  f(n)  =  f(Int2Nat(n - 1))"].attempts >= 3);
+  BOOST_CHECK(equations["f(0)  =  0"].successes == 1);
+  BOOST_CHECK(profile.function_symbol_calls[atermpp::down_cast<function_symbol>(atermpp::down_cast<application>(x).head())] == 4);
+
+  std::ostringstream out;
+  profile.write_json(out);
+  BOOST_CHECK(out.str().find("\"successes\": 3") != std::string::npos);
+}
+
 int test_main(int argc, char** argv)
 {
   test1();
@@ -240,6 +341,8 @@ int test_main(int argc, char** argv)
   simplify_rewriter_test();
   test_lambda_expression();
   test_equality_on_functions();
+  test_generic_substitution();
+  test_rewrite_profile();
 
   return 0;
 }
@@ -0,0 +1,440 @@
+// Author(s): Wieger Wesselink
+// Copyright: see the accompanying file COPYING or copy at
+// https://github.com/mCRL2org/mCRL2/blob/master/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file mcrl2/lps/detail/ldd.h
+/// \brief A small implementation of list decision diagrams (LDDs).
+
+#ifndef MCRL2_LPS_DETAIL_LDD_H
+#define MCRL2_LPS_DETAIL_LDD_H
+
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+namespace mcrl2 {
+
+namespace lps {
+
+namespace detail {
+
+/// \brief A list decision diagram, represented by an index in an ldd_manager.
+typedef std::size_t ldd;
+
+/// \brief Stores the nodes of list decision diagrams, and implements the operations on them.
+/// \details An LDD represents a set of vectors of equal length. A node has a value, a down
+/// edge to the LDD of the suffixes of the vectors that start with this value, and a right edge
+/// to the node with the next (larger) value at the same level. There are two terminals:
+/// false (the empty set) and true (the set containing the empty vector). Nodes are hash consed,
+/// hence two LDDs are equal if and only if they have the same index.
+/// Nodes are never freed; the operation caches can be cleared with clear_cache().
+class ldd_manager
+{
+  protected:
+    struct node
+    {
+      std::uint32_t value;
+      ldd down;
+      ldd right;
+
+      bool operator==(const node& other) const
+      {
+        return value == other.value && down == other.down && right == other.right;
+      }
+    };
+
+    struct node_hash
+    {
+      std::size_t operator()(const node& x) const
+      {
+        std::size_t h = x.value;
+        h = h * 1000003 ^ x.down;
+        h = h * 1000003 ^ x.right;
+        return h;
+      }
+    };
+
+    // The arguments of an operation. For project and relprod the level and the projection are stored as well.
+    struct operation_key
+    {
+      ldd first;
+      ldd second;
+      std::size_t level;
+      std::size_t projection;
+
+      bool operator==(const operation_key& other) const
+      {
+        return first == other.first && second == other.second && level == other.level && projection == other.projection;
+      }
+    };
+
+    struct operation_key_hash
+    {
+      std::size_t operator()(const operation_key& x) const
+      {
+        std::size_t h = x.first;
+        h = h * 1000003 ^ x.second;
+        h = h * 1000003 ^ x.level;
+        h = h * 1000003 ^ x.projection;
+        return h;
+      }
+    };
+
+    typedef std::unordered_map<operation_key, ldd, operation_key_hash> operation_cache;
+
+    std::vector<node> m_nodes;
+    std::unordered_map<node, ldd, node_hash> m_unique_table;
+    operation_cache m_union_cache;
+    operation_cache m_minus_cache;
+    operation_cache m_project_cache;
+    operation_cache m_relprod_cache;
+    std::unordered_map<ldd, double> m_count_cache;
+    std::vector<std::vector<bool> > m_projections;
+
+    const node& get(ldd x) const
+    {
+      assert(x > 1 && x < m_nodes.size());
+      return m_nodes[x];
+    }
+
+    ldd project(ldd x, std::size_t projection, std::size_t level)
+    {
+      const std::vector<bool>& used = m_projections[projection];
+      if (x == empty_set() || level == used.size())
+      {
+        return x;
+      }
+      operation_key key{x, 0, level, projection};
+      auto i = m_project_cache.find(key);
+      if (i != m_project_cache.end())
+      {
+        return i->second;
+      }
+      const node n = get(x);
+      ldd result;
+      if (used[level])
+      {
+        ldd down = project(n.down, projection, level + 1);
+        ldd right = project(n.right, projection, level);
+        result = make_node(n.value, down, right);
+      }
+      else
+      {
+        ldd down = project(n.down, projection, level + 1);
+        ldd right = project(n.right, projection, level);
+        result = union_(down, right);
+      }
+      m_project_cache[key] = result;
+      return result;
+    }
+
+    // Applies relation r to the set x, starting at the given level. The relation is defined on the levels
+    // that are used, and contains for each of them a pair of levels with the source and the target value.
+    ldd relprod(ldd x, ldd r, std::size_t projection, std::size_t level)
+    {
+      const std::vector<bool>& used = m_projections[projection];
+      if (x == empty_set() || r == empty_set())
+      {
+        return empty_set();
+      }
+      if (level == used.size())
+      {
+        assert(x == empty_vector() && r == empty_vector());
+        return empty_vector();
+      }
+      operation_key key{x, r, level, projection};
+      auto i = m_relprod_cache.find(key);
+      if (i != m_relprod_cache.end())
+      {
+        return i->second;
+      }
+      ldd result = empty_set();
+      if (used[level])
+      {
+        // Both x and r are chains sorted on value, so they can be traversed simultaneously.
+        ldd xi = x;
+        ldd ri = r;
+        while (xi != empty_set() && ri != empty_set())
+        {
+          const node& xn = get(xi);
+          const node& rn = get(ri);
+          if (xn.value < rn.value)
+          {
+            xi = xn.right;
+          }
+          else if (rn.value < xn.value)
+          {
+            ri = rn.right;
+          }
+          else
+          {
+            const ldd x_down = xn.down;
+            const ldd r_down = rn.down;
+            for (ldd t = r_down; t != empty_set(); t = get(t).right)
+            {
+              const node tn = get(t);
+              ldd down = relprod(x_down, tn.down, projection, level + 1);
+              if (down != empty_set())
+              {
+                result = union_(result, make_node(tn.value, down, empty_set()));
+              }
+            }
+            xi = get(xi).right;
+            ri = get(ri).right;
+          }
+        }
+      }
+      else
+      {
+        // Copy the values of x at this level.
+        std::vector<std::pair<std::uint32_t, ldd> > children;
+        for (ldd xi = x; xi != empty_set(); xi = get(xi).right)
+        {
+          const node xn = get(xi);
+          ldd down = relprod(xn.down, r, projection, level + 1);
+          if (down != empty_set())
+          {
+            children.emplace_back(xn.value, down);
+          }
+        }
+        for (auto j = children.rbegin(); j != children.rend(); ++j)
+        {
+          result = make_node(j->first, j->second, result);
+        }
+      }
+      m_relprod_cache[key] = result;
+      return result;
+    }
+
+    template <typename Function>
+    void enumerate(ldd x, std::vector<std::uint32_t>& v, Function& f) const
+    {
+      if (x == empty_set())
+      {
+        return;
+      }
+      if (x == empty_vector())
+      {
+        f(v);
+        return;
+      }
+      for (ldd xi = x; xi != empty_set(); xi = get(xi).right)
+      {
+        const node n = get(xi); // f may create new nodes, so a reference could be invalidated
+        v.push_back(n.value);
+        enumerate(n.down, v, f);
+        v.pop_back();
+      }
+    }
+
+  public:
+    ldd_manager()
+    {
+      // Reserve the indices of the terminals.
+      m_nodes.push_back(node{0, 0, 0});
+      m_nodes.push_back(node{0, 0, 0});
+    }
+
+    /// \brief The empty set.
+    static ldd empty_set()
+    {
+      return 0;
+    }
+
+    /// \brief The set containing only the empty vector.
+    static ldd empty_vector()
+    {
+      return 1;
+    }
+
+    /// \brief Returns the node with the given value, down and right edges.
+    /// \pre down is not the empty set, and right is empty or has a value larger than value.
+    ldd make_node(std::uint32_t value, ldd down, ldd right)
+    {
+      assert(down != empty_set());
+      assert(right == empty_set() || get(right).value > value);
+      node n{value, down, right};
+      auto i = m_unique_table.find(n);
+      if (i != m_unique_table.end())
+      {
+        return i->second;
+      }
+      ldd result = m_nodes.size();
+      m_nodes.push_back(n);
+      m_unique_table[n] = result;
+      return result;
+    }
+
+    /// \brief Returns the LDD containing the vector v only.
+    ldd singleton(const std::vector<std::uint32_t>& v)
+    {
+      ldd result = empty_vector();
+      for (auto i = v.rbegin(); i != v.rend(); ++i)
+      {
+        result = make_node(*i, result, empty_set());
+      }
+      return result;
+    }
+
+    /// \brief Returns the union of x and y.
+    ldd union_(ldd x, ldd y)
+    {
+      if (x == y || y == empty_set())
+      {
+        return x;
+      }
+      if (x == empty_set())
+      {
+        return y;
+      }
+      operation_key key{std::min(x, y), std::max(x, y), 0, 0};
+      auto i = m_union_cache.find(key);
+      if (i != m_union_cache.end())
+      {
+        return i->second;
+      }
+      const node xn = get(x);
+      const node yn = get(y);
+      ldd result;
+      if (xn.value < yn.value)
+      {
+        result = make_node(xn.value, xn.down, union_(xn.right, y));
+      }
+      else if (yn.value < xn.value)
+      {
+        result = make_node(yn.value, yn.down, union_(x, yn.right));
+      }
+      else
+      {
+        ldd down = union_(xn.down, yn.down);
+        ldd right = union_(xn.right, yn.right);
+        result = make_node(xn.value, down, right);
+      }
+      m_union_cache[key] = result;
+      return result;
+    }
+
+    /// \brief Returns the set difference of x and y.
+    ldd minus(ldd x, ldd y)
+    {
+      if (x == y || x == empty_set())
+      {
+        return empty_set();
+      }
+      if (y == empty_set())
+      {
+        return x;
+      }
+      operation_key key{x, y, 0, 0};
+      auto i = m_minus_cache.find(key);
+      if (i != m_minus_cache.end())
+      {
+        return i->second;
+      }
+      const node xn = get(x);
+      const node yn = get(y);
+      ldd result;
+      if (xn.value < yn.value)
+      {
+        result = make_node(xn.value, xn.down, minus(xn.right, y));
+      }
+      else if (yn.value < xn.value)
+      {
+        result = minus(x, yn.right);
+      }
+      else
+      {
+        ldd down = minus(xn.down, yn.down);
+        ldd right = minus(xn.right, yn.right);
+        result = down == empty_set() ? right : make_node(xn.value, down, right);
+      }
+      m_minus_cache[key] = result;
+      return result;
+    }
+
+    /// \brief Registers a projection, i.e. a selection of positions of vectors.
+    /// \param used Contains for each position whether it is selected.
+    /// \return The index of the projection, that can be passed to project and relprod.
+    std::size_t add_projection(const std::vector<bool>& used)
+    {
+      m_projections.push_back(used);
+      return m_projections.size() - 1;
+    }
+
+    /// \brief Returns the projection of x on the positions i for which used[i] is true,
+    /// where used is the projection with the given index.
+    /// \pre The vectors in x have length used.size().
+    ldd project(ldd x, std::size_t projection)
+    {
+      return project(x, projection, 0);
+    }
+
+    /// \brief Returns the image of x under the relation r.
+    /// \details The relation r is a set of vectors containing for each position i with used[i]
+    /// the source and the target value at position i consecutively, where used is the projection
+    /// with the given index. The other positions of the vectors in x are copied.
+    ldd relprod(ldd x, ldd r, std::size_t projection)
+    {
+      return relprod(x, r, projection, 0);
+    }
+
+    /// \brief Returns the number of vectors in x.
+    double count(ldd x)
+    {
+      if (x == empty_set())
+      {
+        return 0;
+      }
+      if (x == empty_vector())
+      {
+        return 1;
+      }
+      auto i = m_count_cache.find(x);
+      if (i != m_count_cache.end())
+      {
+        return i->second;
+      }
+      const node n = get(x);
+      double result = count(n.down) + count(n.right);
+      m_count_cache[x] = result;
+      return result;
+    }
+
+    /// \brief Calls f(v) for every vector v in x.
+    template <typename Function>
+    void enumerate(ldd x, Function f) const
+    {
+      std::vector<std::uint32_t> v;
+      enumerate(x, v, f);
+    }
+
+    /// \brief Returns the number of nodes that have been created.
+    std::size_t node_count() const
+    {
+      return m_nodes.size() - 2;
+    }
+
+    /// \brief Clears the caches of the operations.
+    void clear_cache()
+    {
+      m_union_cache.clear();
+      m_minus_cache.clear();
+      m_project_cache.clear();
+      m_relprod_cache.clear();
+      m_count_cache.clear();
+    }
+};
+
+} // namespace detail
+
+} // namespace lps
+
+} // namespace mcrl2
+
+#endif // MCRL2_LPS_DETAIL_LDD_H
@@ -361,6 +361,12 @@ class next_state_generator
       return m_initial_state;
     }
 
+    /// \brief Returns the number of summands.
+    std::size_t summand_count() const
+    {
+      return m_summands.size();
+    }
+
     /// \brief Returns the rewriter associated with this generator.
     data::rewriter& rewriter()
     {
@@ -0,0 +1,184 @@
+// Author(s): Wieger Wesselink
+// Copyright: see the accompanying file COPYING or copy at
+// https://github.com/mCRL2org/mCRL2/blob/master/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file mcrl2/lps/symbolic_reachability.h
+/// \brief Symbolic computation of the reachable states of an LPS, using list decision diagrams.
+
+#ifndef MCRL2_LPS_SYMBOLIC_REACHABILITY_H
+#define MCRL2_LPS_SYMBOLIC_REACHABILITY_H
+
+#include <algorithm>
+#include <iomanip>
+#include "mcrl2/lps/detail/ldd.h"
+#include "mcrl2/lps/ltsmin.h"
+#include "mcrl2/utilities/logger.h"
+
+namespace mcrl2 {
+
+namespace lps {
+
+/// \brief Computes the reachable states of an LPS symbolically, using the PINS interface.
+/// \details Each summand of the LPS is a transition group. The transition relation of a group
+/// is only defined on the process parameters that it reads or writes. It is learned on the fly:
+/// each time a new projection of the visited states on these parameters is found, next_state_long
+/// is called to compute its successors. The states are stored in a list decision diagram, in which
+/// the values of the process parameters are the indices assigned by the PINS data type maps.
+class symbolic_reachability_algorithm
+{
+  public:
+    typedef detail::ldd ldd;
+
+  protected:
+    pins& m_pins;
+    bool m_chaining;
+    detail::ldd_manager m_ldd;
+    std::size_t m_state_length;
+    std::vector<int> m_initial_state;
+    std::vector<std::vector<std::size_t> > m_projection; // m_projection[g] contains the parameters that are read or written by group g
+    std::vector<std::size_t> m_projection_index;         // m_projection_index[g] is the index of m_projection[g] in m_ldd
+    std::vector<ldd> m_relation;                         // m_relation[g] is the part of the relation of group g that has been learned
+    std::vector<ldd> m_learned;                          // m_learned[g] contains the projected states for which m_relation[g] is complete
+    std::size_t m_level = 0;
+
+    struct learn_callback
+    {
+      detail::ldd_manager& manager;
+      const std::vector<std::size_t>& projection;
+      const std::vector<std::uint32_t>& source;
+      ldd& relation;
+
+      learn_callback(detail::ldd_manager& manager_, const std::vector<std::size_t>& projection_, const std::vector<std::uint32_t>& source_, ldd& relation_)
+        : manager(manager_), projection(projection_), source(source_), relation(relation_)
+      {}
+
+      void operator()(pins::ltsmin_state_type const& next_state, int* const& /* edge_labels */, int /* group */ = -1)
+      {
+        std::vector<std::uint32_t> v;
+        v.reserve(2 * projection.size());
+        for (std::size_t i = 0; i < projection.size(); i++)
+        {
+          v.push_back(source[i]);
+          v.push_back(static_cast<std::uint32_t>(next_state[projection[i]]));
+        }
+        relation = manager.union_(relation, manager.singleton(v));
+      }
+    };
+
+    // Extends the relation of group g with the transitions of the projections of the states in x.
+    void learn(std::size_t group, ldd x)
+    {
+      ldd projected = m_ldd.project(x, m_projection_index[group]);
+      ldd todo = m_ldd.minus(projected, m_learned[group]);
+      m_learned[group] = m_ldd.union_(m_learned[group], todo);
+
+      const std::vector<std::size_t>& projection = m_projection[group];
+      std::vector<int> source = m_initial_state; // The parameters that are not read by the group keep an arbitrary value.
+      std::vector<int> target(m_state_length);
+      std::vector<int> labels(m_pins.edge_label_count());
+      int* target_state = target.data();
+      int* edge_labels = labels.data();
+      m_ldd.enumerate(todo, [&](const std::vector<std::uint32_t>& v)
+      {
+        for (std::size_t i = 0; i < projection.size(); i++)
+        {
+          source[projection[i]] = static_cast<int>(v[i]);
+        }
+        learn_callback f(m_ldd, projection, v, m_relation[group]);
+        int* source_state = source.data();
+        m_pins.next_state_long(source_state, group, f, target_state, edge_labels);
+      });
+    }
+
+  public:
+    /// \brief Constructor.
+    /// \param p A PINS interface to an LPS.
+    /// \param chaining If true, the groups are applied one after another within each iteration,
+    /// where each group is applied to the results of the previous groups. Otherwise a
+    /// breadth first search is done.
+    explicit symbolic_reachability_algorithm(pins& p, bool chaining = false)
+      : m_pins(p),
+        m_chaining(chaining),
+        m_state_length(p.process_parameter_count()),
+        m_initial_state(p.process_parameter_count())
+    {
+      int* initial_state = m_initial_state.data();
+      m_pins.get_initial_state(initial_state);
+
+      for (std::size_t group = 0; group < m_pins.group_count(); group++)
+      {
+        std::vector<std::size_t> projection = m_pins.read_group(group);
+        const std::vector<std::size_t>& write_group = m_pins.write_group(group);
+        projection.insert(projection.end(), write_group.begin(), write_group.end());
+        std::sort(projection.begin(), projection.end());
+        projection.erase(std::unique(projection.begin(), projection.end()), projection.end());
+
+        std::vector<bool> used(m_state_length, false);
+        for (std::size_t i: projection)
+        {
+          used[i] = true;
+        }
+        m_projection.push_back(projection);
+        m_projection_index.push_back(m_ldd.add_projection(used));
+        m_relation.push_back(detail::ldd_manager::empty_set());
+        m_learned.push_back(detail::ldd_manager::empty_set());
+      }
+    }
+
+    /// \brief Computes the set of reachable states.
+    ldd run()
+    {
+      std::vector<std::uint32_t> initial_state(m_initial_state.begin(), m_initial_state.end());
+      ldd visited = m_ldd.singleton(initial_state);
+      ldd todo = visited;
+      m_level = 0;
+
+      while (todo != detail::ldd_manager::empty_set())
+      {
+        ldd next = m_chaining ? todo : detail::ldd_manager::empty_set();
+        for (std::size_t group = 0; group < m_pins.group_count(); group++)
+        {
+          ldd x = m_chaining ? next : todo;
+          learn(group, x);
+          next = m_ldd.union_(next, m_ldd.relprod(x, m_relation[group], m_projection_index[group]));
+        }
+        todo = m_ldd.minus(next, visited);
+        visited = m_ldd.union_(visited, todo);
+        m_level++;
+
+        mCRL2log(log::verbose) << "level " << std::setw(4) << m_level << ": "
+                               << std::setw(12) << m_ldd.count(visited) << " states, "
+                               << m_ldd.node_count() << " LDD nodes" << std::endl;
+        m_ldd.clear_cache();
+      }
+      return visited;
+    }
+
+    /// \brief Returns the number of states in the set x.
+    double count(ldd x)
+    {
+      return m_ldd.count(x);
+    }
+
+    /// \brief Returns the number of iterations of the last call to run().
+    std::size_t level() const
+    {
+      return m_level;
+    }
+
+    /// \brief Returns the LDD manager.
+    detail::ldd_manager& manager()
+    {
+      return m_ldd;
+    }
+};
+
+} // namespace lps
+
+} // namespace mcrl2
+
+#endif // MCRL2_LPS_SYMBOLIC_REACHABILITY_H
@@ -63,6 +63,7 @@
 #include "mcrl2/process/process_equation.h"
 #include "mcrl2/process/process_specification.h"
 #include "mcrl2/process/replace.h"
+#include "mcrl2/utilities/execution_timer.h"
 
 
 // For Aterm library extension functions
@@ -11309,6 +11310,7 @@ mcrl2::lps::stochastic_specification mcrl2::lps::linearise(
   s.insert(sort_real::real_());
   data_spec.add_context_sorts(s);
 
+  mcrl2::utilities::scoped_timer initialise_timing("initialise");
   specification_basic_type spec(type_checked_spec.action_labels(),
                                 type_checked_spec.equations(),
                                 data::variable_list(type_checked_spec.global_variables().begin(),type_checked_spec.global_variables().end()),
@@ -11317,6 +11319,7 @@ mcrl2::lps::stochastic_specification mcrl2::lps::linearise(
                                 lin_options,
                                 type_checked_spec);
   process_identifier init=spec.storeinit(type_checked_spec.init());
+  initialise_timing.finish();
 
   //linearise spec
   variable_list parameters;
@@ -11326,7 +11329,10 @@ mcrl2::lps::stochastic_specification mcrl2::lps::linearise(
   stochastic_distribution initial_distribution(
                               variable_list(),
                               sort_real::creal(sort_int::cint(sort_nat::cnat(sort_pos::c1())),sort_pos::c1()));
-  spec.transform(init,action_summands,deadlock_summands,parameters,initial_state,initial_distribution);
+  {
+    mcrl2::utilities::scoped_timer timing("transform");
+    spec.transform(init,action_summands,deadlock_summands,parameters,initial_state,initial_distribution);
+  }
 
   // compute global variables
   data::variable_list globals1 = spec.SieveProcDataVarsSummands(spec.global_variables,action_summands,deadlock_summands,parameters);
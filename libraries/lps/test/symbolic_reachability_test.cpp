@@ -25,6 +25,9 @@
 #include "mcrl2/lps/linearise.h"
 #include "mcrl2/lps/next_state_generator.h"
 #include "mcrl2/lps/state.h"
+#include "mcrl2/lps/symbolic_reachability.h"
+#include "mcrl2/lps/detail/test_input.h"
+#include "mcrl2/utilities/test_utilities.h"
 
 using namespace mcrl2;
 
@@ -177,6 +180,51 @@ void check_info(mcrl2::lps::stochastic_specification const& model)
 #endif
 }
 
+// Returns the number of reachable states of model, using explicit state space exploration.
+std::size_t explicit_state_count(const lps::specification& model)
+{
+  data::rewriter rewriter(model.data());
+  lps::next_state_generator explorer(model, rewriter);
+  std::stack<lps::state> stack;
+  std::set<lps::state> known;
+
+  stack.push(explorer.initial_state());
+  known.insert(stack.top());
+
+  while (!stack.empty())
+  {
+    lps::state current(stack.top());
+    stack.pop();
+
+    lps::next_state_generator::enumerator_queue enumeration_queue;
+    for (auto j = explorer.begin(current, &enumeration_queue); j != explorer.end(); ++j)
+    {
+      if (known.insert(j->target_state).second)
+      {
+        stack.push(j->target_state);
+      }
+    }
+  }
+  return known.size();
+}
+
+void check_symbolic_reachability(const lps::specification& model)
+{
+  std::string filename = utilities::temporary_filename("symbolic_reachability_test");
+  save_lps(model, filename);
+  lps::pins p(filename, "jitty");
+  std::remove(filename.c_str());
+
+  std::size_t expected = explicit_state_count(model);
+  for (bool chaining: { false, true })
+  {
+    lps::symbolic_reachability_algorithm algorithm(p, chaining);
+    lps::symbolic_reachability_algorithm::ldd states = algorithm.run();
+    std::cerr << "symbolic reachability (chaining = " << chaining << "): " << algorithm.count(states) << " states, expected " << expected << std::endl;
+    BOOST_CHECK(algorithm.count(states) == expected);
+  }
+}
+
 int test_main(int argc, char** argv)
 {
   using namespace mcrl2;
@@ -191,6 +239,11 @@ int test_main(int argc, char** argv)
   check_info(linearise(case_summands));
   check_info(linearise(case_last));
 
+  check_symbolic_reachability(remove_stochastic_operators(linearise(case_influenced_next)));
+  check_symbolic_reachability(remove_stochastic_operators(linearise(case_two_parameters)));
+  check_symbolic_reachability(remove_stochastic_operators(linearise(case_last)));
+  check_symbolic_reachability(remove_stochastic_operators(linearise(lps::detail::ABP_SPECIFICATION())));
+
   specification model = remove_stochastic_operators(linearise(case_no_influenced_parameters));
 
   if (1 < argc)
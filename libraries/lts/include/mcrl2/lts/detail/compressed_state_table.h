@@ -0,0 +1,267 @@
+// Author(s): Wieger Wesselink
+// Copyright: see the accompanying file COPYING or copy at
+// https://github.com/mCRL2org/mCRL2/blob/master/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file mcrl2/lts/detail/compressed_state_table.h
+/// \brief A table that assigns numbers to states, where states are stored as
+///        vectors of indices into per-parameter value tables.
+
+#ifndef MCRL2_LTS_DETAIL_COMPRESSED_STATE_TABLE_H
+#define MCRL2_LTS_DETAIL_COMPRESSED_STATE_TABLE_H
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include "mcrl2/atermpp/indexed_set.h"
+#include "mcrl2/lps/state.h"
+#include "mcrl2/utilities/exception.h"
+
+namespace mcrl2
+{
+namespace lts
+{
+
+/// \brief Assigns to each value of a process parameter a 32 bit index.
+/// \details This is used to store a state as a vector of indices instead of a term.
+class parameter_value_tables
+{
+  public:
+    typedef std::uint32_t value_index;
+
+  protected:
+    std::vector<atermpp::indexed_set<data::data_expression>> m_values; // m_values[i] contains the values of parameter i.
+
+  public:
+    /// \brief Constructor.
+    /// \param width The number of process parameters.
+    explicit parameter_value_tables(std::size_t width = 0)
+      : m_values(width)
+    {}
+
+    /// \brief Returns the number of process parameters.
+    std::size_t width() const
+    {
+      return m_values.size();
+    }
+
+    /// \brief Stores the compressed form of s in result. New parameter values are added to the tables.
+    /// \pre result points to an array of at least width() elements.
+    void compress(const lps::state& s, value_index* result)
+    {
+      assert(s.size() == width());
+      std::size_t i = 0;
+      for (const data::data_expression& x: s)
+      {
+        std::size_t index = m_values[i].put(x).first;
+        if (index > std::numeric_limits<value_index>::max())
+        {
+          throw mcrl2::runtime_error("parameter " + std::to_string(i) + " has too many values to store states in compressed form");
+        }
+        result[i++] = static_cast<value_index>(index);
+      }
+    }
+
+    /// \brief Stores the compressed form of s in result, provided that all values of s are in the tables.
+    /// \return False if s contains a value that is not in the tables.
+    bool find(const lps::state& s, value_index* result) const
+    {
+      assert(s.size() == width());
+      std::size_t i = 0;
+      for (const data::data_expression& x: s)
+      {
+        std::size_t index = m_values[i].index(x);
+        if (index == atermpp::indexed_set<data::data_expression>::npos)
+        {
+          return false;
+        }
+        result[i++] = static_cast<value_index>(index);
+      }
+      return true;
+    }
+
+    /// \brief Returns the state that corresponds to the compressed state v.
+    lps::state decompress(const value_index* v) const
+    {
+      std::vector<data::data_expression> values;
+      values.reserve(width());
+      for (std::size_t i = 0; i < width(); i++)
+      {
+        values.push_back(m_values[i].get(v[i]));
+      }
+      return lps::state(values.begin(), width());
+    }
+
+    /// \brief Returns the number of distinct values of process parameter i.
+    std::size_t value_count(std::size_t i) const
+    {
+      return m_values[i].size();
+    }
+};
+
+/// \brief An indexed set of states of a fixed width.
+/// \details Each value of a process parameter is stored once in an indexed set for
+///          that parameter. A state is stored as a flat vector of 32 bit indices into
+///          these sets, and the states are kept in an open addressing hash table.
+///          Since most process parameters range over a few values only, this takes
+///          much less memory than storing the states as terms.
+class compressed_state_table
+{
+  protected:
+    typedef parameter_value_tables::value_index value_index;
+
+    // The value of an unused slot in the hash table.
+    static std::size_t empty()
+    {
+      return std::numeric_limits<std::size_t>::max();
+    }
+
+    std::size_t m_width = 0;
+    parameter_value_tables m_values;
+    std::vector<value_index> m_states;   // State k is stored at positions [k * m_width, (k + 1) * m_width).
+    std::size_t m_size = 0;
+    std::vector<std::size_t> m_hashtable; // Contains state numbers, or empty(). The size is a power of two.
+    std::vector<value_index> m_key;       // Buffer for the compressed form of a state.
+
+    static std::size_t hash(const value_index* first, const value_index* last)
+    {
+      std::size_t h = 14695981039346656037ULL;
+      for (const value_index* i = first; i != last; ++i)
+      {
+        h = (h ^ *i) * 1099511628211ULL;
+      }
+      return h ^ (h >> 29);
+    }
+
+    const value_index* state_begin(std::size_t k) const
+    {
+      return m_states.data() + k * m_width;
+    }
+
+    bool equal(std::size_t k, const value_index* key) const
+    {
+      return std::equal(key, key + m_width, state_begin(k));
+    }
+
+    // Returns the position in the hash table of the state key, or of the empty slot where it should be inserted.
+    std::size_t find_position(const value_index* key) const
+    {
+      const std::size_t mask = m_hashtable.size() - 1;
+      std::size_t pos = hash(key, key + m_width) & mask;
+      while (m_hashtable[pos] != empty() && !equal(m_hashtable[pos], key))
+      {
+        pos = (pos + 1) & mask;
+      }
+      return pos;
+    }
+
+    void resize_hashtable()
+    {
+      m_hashtable.assign(2 * m_hashtable.size(), empty());
+      const std::size_t mask = m_hashtable.size() - 1;
+      for (std::size_t k = 0; k < m_size; k++)
+      {
+        std::size_t pos = hash(state_begin(k), state_begin(k) + m_width) & mask;
+        while (m_hashtable[pos] != empty())
+        {
+          pos = (pos + 1) & mask;
+        }
+        m_hashtable[pos] = k;
+      }
+    }
+
+  public:
+    /// \brief Constructor.
+    /// \param width The number of process parameters.
+    /// \param initial_size The initial size of the hash table.
+    explicit compressed_state_table(std::size_t width = 0, std::size_t initial_size = 1024)
+      : m_width(width),
+        m_values(width),
+        m_key(width)
+    {
+      std::size_t n = 16;
+      while (n < initial_size)
+      {
+        n = 2 * n;
+      }
+      m_hashtable.assign(n, empty());
+    }
+
+    /// \brief Adds the state s to the table.
+    /// \return The number of s, and a boolean that indicates whether s was not yet in the table.
+    std::pair<std::size_t, bool> put(const lps::state& s)
+    {
+      m_values.compress(s, m_key.data());
+      std::size_t pos = find_position(m_key.data());
+      if (m_hashtable[pos] != empty())
+      {
+        return std::make_pair(m_hashtable[pos], false);
+      }
+      std::size_t k = m_size++;
+      m_states.insert(m_states.end(), m_key.begin(), m_key.end());
+      m_hashtable[pos] = k;
+      if (4 * m_size > 3 * m_hashtable.size())
+      {
+        resize_hashtable();
+      }
+      return std::make_pair(k, true);
+    }
+
+    /// \brief Returns the number of the state s, or atermpp::indexed_set<lps::state>::npos if it is not in the table.
+    std::size_t index(const lps::state& s) const
+    {
+      std::vector<value_index> key(m_width);
+      if (!m_values.find(s, key.data()))
+      {
+        return atermpp::indexed_set<lps::state>::npos;
+      }
+      std::size_t pos = find_position(key.data());
+      if (m_hashtable[pos] == empty())
+      {
+        return atermpp::indexed_set<lps::state>::npos;
+      }
+      return m_hashtable[pos];
+    }
+
+    /// \brief Returns the state with number k as a term.
+    lps::state get(std::size_t k) const
+    {
+      assert(k < m_size);
+      return m_values.decompress(state_begin(k));
+    }
+
+    /// \brief Returns the number of states in the table.
+    std::size_t size() const
+    {
+      return m_size;
+    }
+
+    /// \brief Returns the number of entries of the hash table.
+    std::size_t bucket_count() const
+    {
+      return m_hashtable.size();
+    }
+
+    /// \brief Returns the number of distinct values of process parameter i.
+    std::size_t value_count(std::size_t i) const
+    {
+      return m_values.value_count(i);
+    }
+
+    /// \brief Returns an estimate of the number of bytes used for the states and the hash table.
+    /// The memory used by the parameter values themselves is not included.
+    std::size_t memory_usage() const
+    {
+      return m_states.capacity() * sizeof(value_index) + m_hashtable.capacity() * sizeof(std::size_t);
+    }
+};
+
+} // namespace lts
+} // namespace mcrl2
+
+#endif // MCRL2_LTS_DETAIL_COMPRESSED_STATE_TABLE_H
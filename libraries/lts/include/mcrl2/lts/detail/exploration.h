@@ -13,6 +13,7 @@
 #include <string>
 #include <limits>
 #include <memory>
+#include <unordered_map>
 #include <unordered_set>
 
 #include "mcrl2/atermpp/indexed_set.h"
@@ -21,14 +22,20 @@
 #include "mcrl2/lps/one_point_rule_rewrite.h"
 #include "mcrl2/lps/resolve_name_clashes.h"
 #include "mcrl2/lts/lts_lts.h"
+#include "mcrl2/lts/detail/compressed_state_table.h"
+#include "mcrl2/lts/detail/external_memory.h"
+#include "mcrl2/lts/detail/predecessor_table.h"
 #include "mcrl2/lts/detail/queue.h"
 #include "mcrl2/lts/detail/lts_generation_options.h"
 #include "mcrl2/lts/detail/exploration_strategy.h"
+#include "mcrl2/lts/detail/exploration_telemetry.h"
 #include "mcrl2/lts/detail/liblts_swap_to_from_probabilistic_lts.h"
 #include "mcrl2/lts/detail/lts_convert.h"
 #include "mcrl2/lts/detail/exploration.h"
 #include "mcrl2/lts/detail/counter_example.h"
 #include "mcrl2/lts/probabilistic_lts.h"
+#include "mcrl2/trace/trace.h"
+#include "mcrl2/utilities/execution_timer.h"
 
 namespace mcrl2 {
 
@@ -44,15 +51,23 @@ class lps2lts_algorithm
     std::unique_ptr<NextStateGenerator> m_generator;
 
     atermpp::indexed_set<lps::state> m_state_numbers;
+    compressed_state_table m_compressed_state_numbers; // Used instead of m_state_numbers if m_options.compress_states is set.
     atermpp::indexed_set<process::action_list> m_action_label_numbers;
     std::size_t m_number_of_states = 0;
     std::size_t m_number_of_transitions = 0;
     std::size_t m_level = 0;
 
+    // If m_options.trace is set, the predecessors are stored for constructing traces.
+    detail::predecessor_table m_predecessors;
+    std::size_t m_number_of_traces = 0;
+
     // TODO: the details of writing the computed LTS (in two different formats!?) should not be hard coded like this
     lts_lts_t m_output_lts;
     std::ofstream m_aut_file;
 
+    // If m_options.telemetry_filename is set, the progress is written to it.
+    std::unique_ptr<detail::exploration_telemetry> m_telemetry;
+
     volatile bool m_must_abort = false;
 
   public:
@@ -63,14 +78,24 @@ class lps2lts_algorithm
 
     bool generate_lts(const lts_generation_options& options)
     {
-      if (!initialise_lts_generation(options))
       {
-        return false;
+        utilities::scoped_timer timing("initialise");
+        if (!initialise_lts_generation(options))
+        {
+          return false;
+        }
       }
 
       on_start_exploration();
 
-      m_state_numbers.put(m_generator->initial_state());
+      if (!m_options.external_memory)
+      {
+        put_state(m_generator->initial_state());
+      }
+      if (m_options.trace)
+      {
+        m_predecessors.push_back(0, 0); // The initial state is its own predecessor.
+      }
       m_number_of_states = 1;
 
       mCRL2log(log::verbose) << "generating state space with '" << es_breadth << "' strategy...\n";
@@ -80,7 +105,17 @@ class lps2lts_algorithm
         return true;
       }
 
-      generate_lts_breadth_first();
+      {
+        utilities::scoped_timer timing("explore");
+        if (m_options.external_memory)
+        {
+          generate_lts_external_memory();
+        }
+        else
+        {
+          generate_lts_breadth_first();
+        }
+      }
 
       mCRL2log(log::verbose) << "done with state space generation ("
                              << m_level - 1 << " level" << ((m_level == 2) ? "" : "s") << ", "
@@ -88,12 +123,31 @@ class lps2lts_algorithm
                              << " and " << m_number_of_transitions << " transition"
                              << ((m_number_of_transitions == 1) ? "" : "s") << ")"
                              << std::endl;
+      if (m_options.compress_states)
+      {
+        mCRL2log(log::verbose) << "the compressed state table uses " << m_compressed_state_numbers.memory_usage() << " bytes" << std::endl;
+      }
 
-      on_end_exploration();
+      {
+        utilities::scoped_timer timing("save");
+        on_end_exploration();
+      }
 
       return true;
     }
 
+    /// \brief Returns the number of states that have been generated.
+    std::size_t number_of_states() const
+    {
+      return m_number_of_states;
+    }
+
+    /// \brief Returns the number of transitions that have been generated.
+    std::size_t number_of_transitions() const
+    {
+      return m_number_of_transitions;
+    }
+
     void abort()
     {
       // Stops the exploration algorithm if it is running by making sure
@@ -223,7 +277,25 @@ class lps2lts_algorithm
     bool initialise_lts_generation(const lts_generation_options& options)
     {
       m_options = options;
-      m_state_numbers = atermpp::indexed_set<lps::state>(m_options.initial_table_size, 50);
+      if (m_options.external_memory && m_options.outformat != lts_aut && m_options.outformat != lts_none)
+      {
+        throw mcrl2::runtime_error("external memory exploration only supports the aut format");
+      }
+      if (m_options.external_memory && m_options.trace)
+      {
+        throw mcrl2::runtime_error("saving traces is not supported in combination with external memory exploration");
+      }
+      m_predecessors.clear();
+      m_number_of_traces = 0;
+      if (m_options.compress_states)
+      {
+        m_state_numbers = atermpp::indexed_set<lps::state>();
+        m_compressed_state_numbers = compressed_state_table(m_options.specification.process().process_parameters().size(), m_options.initial_table_size);
+      }
+      else
+      {
+        m_state_numbers = atermpp::indexed_set<lps::state>(m_options.initial_table_size, 50);
+      }
       m_number_of_states = 0;
       m_number_of_transitions = 0;
       m_level = 1;
@@ -253,7 +325,7 @@ class lps2lts_algorithm
         rewriter = data::rewriter(lpsspec.data(), m_options.strat);
       }
 
-      bool compute_actions = m_options.outformat != lts_none;
+      bool compute_actions = m_options.outformat != lts_none || m_options.detect_action || m_options.trace;
       if (!compute_actions)
       {
         for (auto& summand: lpsspec.process().action_summands())
@@ -262,6 +334,11 @@ class lps2lts_algorithm
         }
       }
       m_generator = std::make_unique<NextStateGenerator>(lpsspec, rewriter);
+      m_telemetry.reset();
+      if (!m_options.telemetry_filename.empty())
+      {
+        m_telemetry = std::make_unique<detail::exploration_telemetry>(m_options.telemetry_filename, m_options.telemetry_interval, m_generator->summand_count());
+      }
 
       if (m_options.detect_deadlock)
       {
@@ -302,9 +379,29 @@ class lps2lts_algorithm
       return false;
     }
 
-    std::pair<std::size_t, bool> add_target_state(const lps::state& source_state, const lps::state& target_state)
+    std::pair<std::size_t, bool> put_state(const lps::state& s)
+    {
+      return m_options.compress_states ? m_compressed_state_numbers.put(s) : m_state_numbers.put(s);
+    }
+
+    lps::state get_state(std::size_t index) const
+    {
+      return m_options.compress_states ? m_compressed_state_numbers.get(index) : m_state_numbers.get(index);
+    }
+
+    std::size_t state_index(const lps::state& s) const
+    {
+      return m_options.compress_states ? m_compressed_state_numbers.index(s) : static_cast<std::size_t>(m_state_numbers.index(s));
+    }
+
+    std::size_t stored_state_count() const
+    {
+      return m_options.compress_states ? m_compressed_state_numbers.size() : m_state_numbers.size();
+    }
+
+    std::pair<std::size_t, bool> add_target_state(const lps::state& target_state)
     {
-      std::pair<std::size_t, bool> target_state_number = m_state_numbers.put(target_state);
+      std::pair<std::size_t, bool> target_state_number = put_state(target_state);
       if (target_state_number.second) // The state is new.
       {
         m_number_of_states++;
@@ -313,10 +410,13 @@ class lps2lts_algorithm
       return target_state_number;
     }
 
-    bool add_transition(const lps::state& source_state, const lps::next_state_generator::transition& transition)
+    bool add_transition(std::size_t source_state_number, const lps::next_state_generator::transition& transition)
     {
-      std::size_t source_state_number = m_state_numbers[source_state];
-      const std::pair<std::size_t, bool> target_state_number = add_target_state(source_state, transition.target_state);
+      const std::pair<std::size_t, bool> target_state_number = add_target_state(transition.target_state);
+      if (target_state_number.second && m_options.trace)
+      {
+        m_predecessors.push_back(source_state_number, transition.summand_index);
+      }
       on_transition(source_state_number, transition.action, target_state_number.first);
       m_number_of_transitions++;
       return target_state_number.second;
@@ -358,6 +458,7 @@ class lps2lts_algorithm
 #endif
 
     void generate_transitions(const lps::state& state,
+                              std::size_t state_number,
                               std::vector<lps::next_state_generator::transition>& transitions,
                               lps::next_state_generator::enumerator_queue& enumeration_queue
     )
@@ -367,9 +468,33 @@ class lps2lts_algorithm
       {
         enumeration_queue.clear();
         auto end = m_generator->end();
-        for (auto i = m_generator->begin(state, &enumeration_queue); i != end; ++i)
+        if (m_telemetry)
+        {
+          // Generate the transitions per summand, to measure them separately.
+          for (std::size_t summand_index = 0; summand_index < m_generator->summand_count(); summand_index++)
+          {
+            detail::exploration_telemetry::summand_statistics& statistics = m_telemetry->summand(summand_index);
+            const std::size_t size = transitions.size();
+            const auto start = std::chrono::steady_clock::now();
+            for (auto i = m_generator->begin(state, summand_index, &enumeration_queue); i != end; ++i)
+            {
+              transitions.push_back(*i);
+            }
+            statistics.time += std::chrono::steady_clock::now() - start;
+            statistics.calls++;
+            statistics.solutions += transitions.size() - size;
+            if (transitions.size() == size)
+            {
+              statistics.calls_without_solutions++;
+            }
+          }
+        }
+        else
         {
-          transitions.push_back(*i);
+          for (auto i = m_generator->begin(state, &enumeration_queue); i != end; ++i)
+          {
+            transitions.push_back(*i);
+          }
         }
       }
       catch (mcrl2::runtime_error& e)
@@ -384,7 +509,30 @@ class lps2lts_algorithm
 
       if (m_options.detect_deadlock && transitions.empty())
       {
-        mCRL2log(log::info) << "deadlock-detect: deadlock found (state index: " << m_state_numbers.index(state) << ").\n";
+        mCRL2log(log::info) << "deadlock-detect: deadlock found (state index: " << state_number << ").\n";
+        if (m_options.trace)
+        {
+          save_trace(state_number, m_options.trace_prefix + "_dlk_" + std::to_string(m_number_of_traces) + ".trc");
+        }
+      }
+
+      if (m_options.detect_action)
+      {
+        for (const lps::next_state_generator::transition& t: transitions)
+        {
+          for (const process::action& a: t.action.actions())
+          {
+            if (m_options.trace_actions.count(a.label().name()) > 0)
+            {
+              mCRL2log(log::info) << "detect: action '" << lps::pp(t.action) << "' found (state index: " << state_number << ").\n";
+              if (m_options.trace)
+              {
+                save_trace(state_number, m_options.trace_prefix + "_act_" + std::to_string(m_number_of_traces) + "_" + std::string(a.label().name()) + ".trc", &t);
+              }
+              break;
+            }
+          }
+        }
       }
 
       if (m_options.detect_nondeterminism)
@@ -392,9 +540,78 @@ class lps2lts_algorithm
         lps::next_state_generator::transition nondeterministic_transition;
         if (is_nondeterministic(transitions, nondeterministic_transition))
         {
-          mCRL2log(log::info) << "Nondeterministic state found (state index: " << m_state_numbers.index(state) << ").\n";
+          mCRL2log(log::info) << "Nondeterministic state found (state index: " << state_number << ").\n";
+        }
+      }
+    }
+
+    // Saves a trace from the initial state to the state with the given number, extended with
+    // the transition last if it is not null. The actions of the trace are recomputed using the
+    // summand indices in the predecessor table.
+    void save_trace(std::size_t state_number, const std::string& filename, const lps::next_state_generator::transition* last = nullptr)
+    {
+      if (m_number_of_traces >= m_options.max_traces)
+      {
+        return;
+      }
+      trace::Trace trace(m_options.specification.data(), m_options.specification.action_labels());
+      std::vector<std::size_t> path = m_predecessors.path(state_number);
+      lps::state source = get_state(path.front());
+      trace.setState(source);
+      lps::next_state_generator::enumerator_queue enumeration_queue;
+      for (auto i = path.begin() + 1; i != path.end(); ++i)
+      {
+        lps::state target = get_state(*i);
+        auto end = m_generator->end();
+        auto j = m_generator->begin(source, m_predecessors.summand_index(*i), &enumeration_queue);
+        while (j != end && j->target_state != target)
+        {
+          ++j;
+        }
+        if (j == end)
+        {
+          throw mcrl2::runtime_error("could not reconstruct the transition from state " + std::to_string(*(i - 1)) + " to state " + std::to_string(*i));
         }
+        trace.addAction(j->action);
+        trace.setState(target);
+        source = target;
+      }
+      if (last != nullptr)
+      {
+        trace.addAction(last->action);
+        trace.setState(last->target_state);
+      }
+      trace.save(filename);
+      m_number_of_traces++;
+      mCRL2log(log::info) << "trace saved to '" << filename << "'.\n";
+    }
+
+    // Writes a line of progress information, if telemetry is enabled and the interval has passed or final is set.
+    void write_telemetry(std::size_t explored, bool final)
+    {
+      if (!m_telemetry || (!final && !m_telemetry->is_due()))
+      {
+        return;
+      }
+      if (m_options.external_memory)
+      {
+        m_telemetry->write(m_number_of_states, m_number_of_transitions, explored, m_level, nullptr, final);
+        return;
+      }
+      detail::exploration_telemetry::state_table_statistics table;
+      if (m_options.compress_states)
+      {
+        table.size = m_compressed_state_numbers.size();
+        table.buckets = m_compressed_state_numbers.bucket_count();
+        table.bytes = m_compressed_state_numbers.memory_usage();
+      }
+      else
+      {
+        table.size = m_state_numbers.size();
+        table.buckets = m_state_numbers.bucket_count();
+        table.bytes = m_state_numbers.memory_usage();
       }
+      m_telemetry->write(m_number_of_states, m_number_of_transitions, explored, m_level, &table, final);
     }
 
     void generate_lts_breadth_first()
@@ -406,14 +623,14 @@ class lps2lts_algorithm
       time_t last_log_time = time(nullptr) - 1, new_log_time;
       lps::next_state_generator::enumerator_queue enumeration_queue;
 
-      while (!m_must_abort && (current_state < m_state_numbers.size()) && (current_state < m_options.max_states))
+      while (!m_must_abort && (current_state < stored_state_count()) && (current_state < m_options.max_states))
       {
-        lps::state state = m_state_numbers.get(current_state);
-        generate_transitions(state, transitions, enumeration_queue);
+        lps::state state = get_state(current_state);
+        generate_transitions(state, current_state, transitions, enumeration_queue);
 
         for (const lps::next_state_generator::transition& t: transitions)
         {
-          add_transition(state, t);
+          add_transition(current_state, t);
         }
         transitions.clear();
 
@@ -421,10 +638,15 @@ class lps2lts_algorithm
         if (current_state == start_level_seen)
         {
           mCRL2log(log::debug) << "Number of states at level " << m_level << " is " << m_number_of_states - start_level_seen << "\n";
+          if (m_telemetry)
+          {
+            m_telemetry->add_level(m_level, m_number_of_states - start_level_seen, m_number_of_transitions - start_level_transitions);
+          }
           m_level++;
           start_level_seen = m_number_of_states;
           start_level_transitions = m_number_of_transitions;
         }
+        write_telemetry(current_state, false);
 
         if (!m_options.suppress_progress_messages && time(&new_log_time) > last_log_time)
         {
@@ -443,6 +665,152 @@ class lps2lts_algorithm
       {
         mCRL2log(log::verbose) << "explored the maximum number (" << m_options.max_states << ") of states, terminating." << std::endl;
       }
+      write_telemetry(current_state, true);
+    }
+
+    // Breadth first exploration in which the states are stored on disk. The states of a level are
+    // stored in a file, sorted on their compressed form. Duplicate detection is delayed until a level
+    // has been generated: the transitions of the level are sorted on their target state and merged with
+    // the sorted file of visited states. This assigns numbers to the new states, and resolves the target
+    // numbers of the transitions, which are then written to the AUT file.
+    void generate_lts_external_memory()
+    {
+      typedef detail::record_word word;
+      const std::size_t width = m_options.specification.process().process_parameters().size();
+      const std::size_t state_record_size = width + 2;      // the compressed state, and its number
+      const std::size_t transition_record_size = width + 4; // the compressed target state, the source number and the action number
+
+      detail::temporary_file_manager files(m_options.temporary_directory);
+      parameter_value_tables values(width);
+      std::unordered_map<std::string, std::size_t> action_numbers;
+      std::vector<std::string> action_labels;
+
+      std::vector<word> record(transition_record_size);
+      values.compress(m_generator->initial_state(), record.data());
+      detail::set_record_number(record.data() + width, 0);
+      std::string current_level = files.create();
+      std::string visited = files.create();
+      for (const std::string& filename: { current_level, visited })
+      {
+        detail::record_writer out(filename, state_record_size);
+        out.write(record.data());
+        out.close();
+      }
+      std::size_t current_level_size = 1;
+      std::size_t explored = 0;
+
+      std::vector<lps::next_state_generator::transition> transitions;
+      lps::next_state_generator::enumerator_queue enumeration_queue;
+      while (!m_must_abort && current_level_size > 0 && m_number_of_states < m_options.max_states)
+      {
+        std::size_t start_level_states = m_number_of_states;
+        std::size_t start_level_transitions = m_number_of_transitions;
+
+        // Generate the transitions of the current level.
+        detail::record_sorter sorter(files, transition_record_size, width, m_options.memory_budget, false);
+        for (detail::record_reader in(current_level, state_record_size); in.valid() && !m_must_abort; in.next())
+        {
+          std::size_t source_state_number = detail::get_record_number(in.current() + width);
+          generate_transitions(values.decompress(in.current()), source_state_number, transitions, enumeration_queue);
+          explored++;
+          for (const lps::next_state_generator::transition& t: transitions)
+          {
+            std::size_t action_number = 0;
+            if (m_options.outformat == lts_aut)
+            {
+              auto i = action_numbers.insert(std::make_pair(lps::pp(t.action), action_labels.size()));
+              if (i.second)
+              {
+                action_labels.push_back(i.first->first);
+              }
+              action_number = i.first->second;
+            }
+            values.compress(t.target_state, record.data());
+            detail::set_record_number(record.data() + width, source_state_number);
+            detail::set_record_number(record.data() + width + 2, action_number);
+            sorter.push(record.data());
+            m_number_of_transitions++;
+          }
+          transitions.clear();
+          write_telemetry(explored, false);
+        }
+        std::vector<std::string> runs = sorter.finish();
+
+        // Merge the transitions with the visited states, and number the new states.
+        std::string next_level = files.create();
+        std::string next_visited = files.create();
+        {
+          detail::record_merger in(runs, transition_record_size, width, false);
+          detail::record_reader old(visited, state_record_size);
+          detail::record_writer level_out(next_level, state_record_size);
+          detail::record_writer visited_out(next_visited, state_record_size);
+          std::vector<word> new_state(state_record_size);
+          bool has_new_state = false;
+          for (; in.valid(); in.next())
+          {
+            const word* t = in.current();
+            while (old.valid() && detail::compare_records(old.current(), t, width) < 0)
+            {
+              visited_out.write(old.current());
+              old.next();
+            }
+            std::size_t target_state_number;
+            if (old.valid() && detail::compare_records(old.current(), t, width) == 0)
+            {
+              target_state_number = detail::get_record_number(old.current() + width);
+            }
+            else if (has_new_state && detail::compare_records(new_state.data(), t, width) == 0)
+            {
+              target_state_number = detail::get_record_number(new_state.data() + width);
+            }
+            else
+            {
+              target_state_number = m_number_of_states++;
+              std::copy(t, t + width, new_state.begin());
+              detail::set_record_number(new_state.data() + width, target_state_number);
+              has_new_state = true;
+              level_out.write(new_state.data());
+              visited_out.write(new_state.data());
+            }
+            if (m_options.outformat == lts_aut)
+            {
+              m_aut_file << "(" << detail::get_record_number(t + width) << ",\""
+                         << action_labels[detail::get_record_number(t + width + 2)] << "\"," << target_state_number << ")\n";
+            }
+          }
+          for (; old.valid(); old.next())
+          {
+            visited_out.write(old.current());
+          }
+          current_level_size = level_out.size();
+          level_out.close();
+          visited_out.close();
+        }
+        files.remove(runs);
+        files.remove(current_level);
+        files.remove(visited);
+        current_level = next_level;
+        visited = next_visited;
+
+        mCRL2log(log::debug) << "Number of states at level " << m_level << " is " << m_number_of_states - start_level_states << "\n";
+        if (m_telemetry)
+        {
+          m_telemetry->add_level(m_level, m_number_of_states - start_level_states, m_number_of_transitions - start_level_transitions);
+        }
+        m_level++;
+        if (!m_options.suppress_progress_messages)
+        {
+          mCRL2log(log::status) << m_number_of_states << "st, " << m_number_of_transitions << "tr"
+                                << ". Last level: " << m_level << ", " << m_number_of_states - start_level_states << "st, "
+                                << m_number_of_transitions - start_level_transitions << "tr.\n";
+        }
+      }
+
+      if (m_number_of_states >= m_options.max_states && current_level_size > 0)
+      {
+        mCRL2log(log::verbose) << "explored at least the maximum number (" << m_options.max_states << ") of states, terminating." << std::endl;
+      }
+      write_telemetry(explored, true);
     }
 };
 
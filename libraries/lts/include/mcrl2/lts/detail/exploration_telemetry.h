@@ -0,0 +1,162 @@
+// Author(s): Wieger Wesselink
+// Copyright: see the accompanying file COPYING or copy at
+// https://github.com/mCRL2org/mCRL2/blob/master/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file mcrl2/lts/detail/exploration_telemetry.h
+/// \brief Machine readable progress information of state space exploration.
+
+#ifndef MCRL2_LTS_DETAIL_EXPLORATION_TELEMETRY_H
+#define MCRL2_LTS_DETAIL_EXPLORATION_TELEMETRY_H
+
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include "mcrl2/atermpp/aterm.h"
+#include "mcrl2/data/detail/rewrite_profile.h"
+#include "mcrl2/utilities/exception.h"
+
+namespace mcrl2 {
+
+namespace lts {
+
+namespace detail {
+
+/// \brief Writes the progress of an exploration as lines with a JSON object to a file. A line is written
+/// at most once per interval, and at the end of the exploration. Each line contains the totals up till
+/// that moment, except for the levels, of which only the ones that were completed since the previous
+/// line are included. The file may be a device like /dev/stderr or /dev/fd/3.
+class exploration_telemetry
+{
+  public:
+    struct summand_statistics
+    {
+      std::size_t calls = 0;                    // The number of states for which the summand was explored.
+      std::size_t solutions = 0;                // The number of transitions generated by the summand.
+      std::size_t calls_without_solutions = 0;  // The number of states in which the condition had no solutions.
+      std::chrono::steady_clock::duration time = std::chrono::steady_clock::duration::zero();
+    };
+
+    struct level_statistics
+    {
+      std::size_t level;
+      std::size_t states;
+      std::size_t transitions;
+    };
+
+    /// \brief The sizes of the table of visited states.
+    struct state_table_statistics
+    {
+      std::size_t size = 0;
+      std::size_t buckets = 0;
+      std::size_t bytes = 0;
+    };
+
+  protected:
+    std::ofstream m_out;
+    std::chrono::steady_clock::duration m_interval;
+    std::chrono::steady_clock::time_point m_start;
+    std::chrono::steady_clock::time_point m_last;
+    std::vector<summand_statistics> m_summands;
+    std::vector<level_statistics> m_levels;
+
+    static double seconds(std::chrono::steady_clock::duration d)
+    {
+      return std::chrono::duration<double>(d).count();
+    }
+
+  public:
+    exploration_telemetry(const std::string& filename, std::size_t interval_milliseconds, std::size_t summand_count)
+      : m_out(filename),
+        m_interval(std::chrono::milliseconds(interval_milliseconds)),
+        m_start(std::chrono::steady_clock::now()),
+        m_last(m_start),
+        m_summands(summand_count)
+    {
+      if (!m_out.good())
+      {
+        throw mcrl2::runtime_error("Could not write to filename " + filename);
+      }
+    }
+
+    summand_statistics& summand(std::size_t i)
+    {
+      return m_summands[i];
+    }
+
+    /// \brief Records that a level is completed.
+    void add_level(std::size_t level, std::size_t states, std::size_t transitions)
+    {
+      m_levels.push_back(level_statistics{ level, states, transitions });
+    }
+
+    /// \brief Returns true if the interval has passed since the last line was written.
+    bool is_due() const
+    {
+      return std::chrono::steady_clock::now() - m_last >= m_interval;
+    }
+
+    /// \brief Writes a line.
+    /// \param explored The number of states of which the outgoing transitions have been generated.
+    /// \param table The statistics of the table of visited states, or nullptr if it is not kept in memory.
+    void write(std::size_t states, std::size_t transitions, std::size_t explored, std::size_t level,
+               const state_table_statistics* table, bool final)
+    {
+      m_last = std::chrono::steady_clock::now();
+      m_out << std::setprecision(6)
+            << "{\"time\": " << seconds(m_last - m_start) << ", \"final\": " << (final ? "true" : "false")
+            << ", \"states\": " << states << ", \"transitions\": " << transitions
+            << ", \"explored\": " << explored << ", \"level\": " << level;
+
+      m_out << ", \"levels\": [";
+      for (auto i = m_levels.begin(); i != m_levels.end(); ++i)
+      {
+        m_out << (i == m_levels.begin() ? "" : ", ")
+              << "{\"level\": " << i->level << ", \"states\": " << i->states << ", \"transitions\": " << i->transitions << "}";
+      }
+      m_out << "]";
+      m_levels.clear();
+
+      if (table)
+      {
+        m_out << ", \"state_table\": {\"size\": " << table->size << ", \"buckets\": " << table->buckets
+              << ", \"load_factor\": " << (table->buckets == 0 ? 0.0 : static_cast<double>(table->size) / table->buckets)
+              << ", \"bytes\": " << table->bytes << "}";
+      }
+
+      const atermpp::detail::aterm_heap_statistics heap = atermpp::detail::heap_statistics();
+      m_out << ", \"aterm_heap\": {\"terms\": " << heap.terms << ", \"bytes\": " << heap.bytes
+            << ", \"garbage_collections\": " << heap.garbage_collections
+            << ", \"garbage_collection_time\": " << heap.garbage_collection_time << "}";
+
+      const data::detail::rewrite_profile* profile = data::detail::active_rewrite_profile();
+      if (profile)
+      {
+        m_out << ", \"rewrite_calls\": " << profile->rewrite_calls;
+      }
+
+      m_out << ", \"summands\": [";
+      for (std::size_t i = 0; i < m_summands.size(); i++)
+      {
+        const summand_statistics& s = m_summands[i];
+        m_out << (i == 0 ? "" : ", ")
+              << "{\"index\": " << i << ", \"calls\": " << s.calls << ", \"solutions\": " << s.solutions
+              << ", \"condition_false_rate\": " << (s.calls == 0 ? 0.0 : static_cast<double>(s.calls_without_solutions) / s.calls)
+              << ", \"time\": " << seconds(s.time) << "}";
+      }
+      m_out << "]}" << std::endl;
+    }
+};
+
+} // namespace detail
+
+} // namespace lts
+
+} // namespace mcrl2
+
+#endif // MCRL2_LTS_DETAIL_EXPLORATION_TELEMETRY_H
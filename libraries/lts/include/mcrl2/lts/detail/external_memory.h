@@ -0,0 +1,396 @@
+// Author(s): Wieger Wesselink
+// Copyright: see the accompanying file COPYING or copy at
+// https://github.com/mCRL2org/mCRL2/blob/master/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file mcrl2/lts/detail/external_memory.h
+/// \brief Files of fixed size records, and sorting of such records with a bounded amount of memory.
+
+#ifndef MCRL2_LTS_DETAIL_EXTERNAL_MEMORY_H
+#define MCRL2_LTS_DETAIL_EXTERNAL_MEMORY_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+#include "mcrl2/utilities/exception.h"
+
+namespace mcrl2 {
+
+namespace lts {
+
+namespace detail {
+
+/// \brief A record is a fixed number of 32 bit words. Records are compared lexicographically
+/// on their first key_size words.
+typedef std::uint32_t record_word;
+
+inline
+int compare_records(const record_word* x, const record_word* y, std::size_t key_size)
+{
+  for (std::size_t i = 0; i < key_size; i++)
+  {
+    if (x[i] != y[i])
+    {
+      return x[i] < y[i] ? -1 : 1;
+    }
+  }
+  return 0;
+}
+
+/// \brief Stores the 64 bit number n in the words p[0] and p[1].
+inline
+void set_record_number(record_word* p, std::size_t n)
+{
+  p[0] = static_cast<record_word>(static_cast<std::uint64_t>(n) >> 32);
+  p[1] = static_cast<record_word>(n & 0xffffffff);
+}
+
+/// \brief Returns the 64 bit number stored in the words p[0] and p[1].
+inline
+std::size_t get_record_number(const record_word* p)
+{
+  return static_cast<std::size_t>((static_cast<std::uint64_t>(p[0]) << 32) | p[1]);
+}
+
+/// \brief Generates names for temporary files, and removes the files that are still
+/// present when it is destroyed.
+class temporary_file_manager
+{
+  protected:
+    std::string m_prefix;
+    std::size_t m_counter = 0;
+    std::set<std::string> m_files;
+
+  public:
+    /// \brief Constructor.
+    /// \param directory The directory in which the temporary files are created.
+    explicit temporary_file_manager(const std::string& directory)
+    {
+      std::random_device device;
+      m_prefix = (directory.empty() ? std::string(".") : directory) + "/mcrl3_" + std::to_string(device()) + "_";
+    }
+
+    temporary_file_manager(const temporary_file_manager&) = delete;
+    temporary_file_manager& operator=(const temporary_file_manager&) = delete;
+
+    ~temporary_file_manager()
+    {
+      for (const std::string& filename: m_files)
+      {
+        std::remove(filename.c_str());
+      }
+    }
+
+    /// \brief Returns the name of a new temporary file.
+    std::string create()
+    {
+      std::string filename = m_prefix + std::to_string(m_counter++) + ".tmp";
+      m_files.insert(filename);
+      return filename;
+    }
+
+    /// \brief Removes the temporary file with the given name.
+    void remove(const std::string& filename)
+    {
+      std::remove(filename.c_str());
+      m_files.erase(filename);
+    }
+
+    /// \brief Removes the temporary files with the given names.
+    void remove(const std::vector<std::string>& filenames)
+    {
+      for (const std::string& filename: filenames)
+      {
+        remove(filename);
+      }
+    }
+};
+
+/// \brief Writes records of a fixed size to a binary file.
+class record_writer
+{
+  protected:
+    std::vector<char> m_buffer;
+    std::ofstream m_out;
+    std::string m_filename;
+    std::size_t m_record_size;
+    std::size_t m_count = 0;
+
+  public:
+    record_writer(const std::string& filename, std::size_t record_size)
+      : m_buffer(1 << 16), m_filename(filename), m_record_size(record_size)
+    {
+      m_out.rdbuf()->pubsetbuf(m_buffer.data(), m_buffer.size());
+      m_out.open(filename, std::ios::binary | std::ios::trunc);
+      if (!m_out.is_open())
+      {
+        throw mcrl2::runtime_error("cannot open temporary file '" + filename + "' for writing");
+      }
+    }
+
+    void write(const record_word* record)
+    {
+      m_out.write(reinterpret_cast<const char*>(record), m_record_size * sizeof(record_word));
+      m_count++;
+    }
+
+    /// \brief Returns the number of records that have been written.
+    std::size_t size() const
+    {
+      return m_count;
+    }
+
+    void close()
+    {
+      m_out.close();
+      if (m_out.fail())
+      {
+        throw mcrl2::runtime_error("error while writing temporary file '" + m_filename + "'");
+      }
+    }
+};
+
+/// \brief Reads records of a fixed size from a binary file.
+class record_reader
+{
+  protected:
+    std::vector<char> m_buffer;
+    std::ifstream m_in;
+    std::vector<record_word> m_record;
+    bool m_valid = true;
+
+  public:
+    record_reader(const std::string& filename, std::size_t record_size)
+      : m_buffer(1 << 16), m_record(record_size)
+    {
+      m_in.rdbuf()->pubsetbuf(m_buffer.data(), m_buffer.size());
+      m_in.open(filename, std::ios::binary);
+      if (!m_in.is_open())
+      {
+        throw mcrl2::runtime_error("cannot open temporary file '" + filename + "' for reading");
+      }
+      next();
+    }
+
+    /// \brief Returns true if current() is a record.
+    bool valid() const
+    {
+      return m_valid;
+    }
+
+    const record_word* current() const
+    {
+      return m_record.data();
+    }
+
+    /// \brief Reads the next record.
+    void next()
+    {
+      m_in.read(reinterpret_cast<char*>(m_record.data()), m_record.size() * sizeof(record_word));
+      m_valid = m_in.gcount() == static_cast<std::streamsize>(m_record.size() * sizeof(record_word));
+    }
+};
+
+/// \brief Merges a number of files with sorted records into one sorted sequence.
+/// \details If unique is set, of each group of records with the same key only the
+/// first one is returned.
+class record_merger
+{
+  protected:
+    std::vector<std::unique_ptr<record_reader>> m_readers;
+    std::vector<std::size_t> m_heap; // the indices of the valid readers, ordered on their current record
+    std::size_t m_key_size;
+    bool m_unique;
+    std::vector<record_word> m_last;
+
+    bool greater(std::size_t i, std::size_t j) const
+    {
+      return compare_records(m_readers[i]->current(), m_readers[j]->current(), m_key_size) > 0;
+    }
+
+    void advance_top()
+    {
+      auto greater_ = [&](std::size_t i, std::size_t j) { return greater(i, j); };
+      std::pop_heap(m_heap.begin(), m_heap.end(), greater_);
+      std::size_t i = m_heap.back();
+      m_readers[i]->next();
+      if (m_readers[i]->valid())
+      {
+        std::push_heap(m_heap.begin(), m_heap.end(), greater_);
+      }
+      else
+      {
+        m_heap.pop_back();
+      }
+    }
+
+  public:
+    record_merger(const std::vector<std::string>& filenames, std::size_t record_size, std::size_t key_size, bool unique)
+      : m_key_size(key_size), m_unique(unique), m_last(key_size)
+    {
+      for (const std::string& filename: filenames)
+      {
+        m_readers.push_back(std::make_unique<record_reader>(filename, record_size));
+        if (m_readers.back()->valid())
+        {
+          m_heap.push_back(m_readers.size() - 1);
+        }
+      }
+      std::make_heap(m_heap.begin(), m_heap.end(), [&](std::size_t i, std::size_t j) { return greater(i, j); });
+    }
+
+    bool valid() const
+    {
+      return !m_heap.empty();
+    }
+
+    const record_word* current() const
+    {
+      return m_readers[m_heap.front()]->current();
+    }
+
+    void next()
+    {
+      if (!m_unique)
+      {
+        advance_top();
+        return;
+      }
+      std::copy(current(), current() + m_key_size, m_last.begin());
+      advance_top();
+      while (valid() && compare_records(current(), m_last.data(), m_key_size) == 0)
+      {
+        advance_top();
+      }
+    }
+};
+
+/// \brief Sorts records using a bounded amount of memory. Records are collected in a buffer;
+/// each time it is full, it is sorted and written to a temporary file (a run).
+class record_sorter
+{
+  protected:
+    // The maximum number of runs that is merged at once.
+    static std::size_t max_fan_in()
+    {
+      return 256;
+    }
+
+    temporary_file_manager& m_files;
+    std::size_t m_record_size;
+    std::size_t m_key_size;
+    bool m_unique;
+    std::size_t m_max_records;
+    std::vector<record_word> m_buffer;
+    std::vector<std::string> m_runs;
+
+    void flush()
+    {
+      std::size_t n = m_buffer.size() / m_record_size;
+      if (n == 0)
+      {
+        return;
+      }
+      std::vector<std::size_t> order(n);
+      for (std::size_t i = 0; i < n; i++)
+      {
+        order[i] = i * m_record_size;
+      }
+      const record_word* data = m_buffer.data();
+      std::sort(order.begin(), order.end(), [&](std::size_t x, std::size_t y)
+        {
+          return compare_records(data + x, data + y, m_key_size) < 0;
+        });
+
+      std::string filename = m_files.create();
+      record_writer out(filename, m_record_size);
+      const record_word* last = nullptr;
+      for (std::size_t i: order)
+      {
+        if (m_unique && last != nullptr && compare_records(last, data + i, m_key_size) == 0)
+        {
+          continue;
+        }
+        out.write(data + i);
+        last = data + i;
+      }
+      out.close();
+      m_runs.push_back(filename);
+      m_buffer.clear();
+    }
+
+  public:
+    /// \brief Constructor.
+    /// \param files Used for creating the runs.
+    /// \param record_size The number of words of a record.
+    /// \param key_size The number of words of a record that are used for sorting.
+    /// \param memory_budget The maximum number of bytes used for buffering records.
+    /// \param unique If true, records with equal keys are removed.
+    record_sorter(temporary_file_manager& files, std::size_t record_size, std::size_t key_size, std::size_t memory_budget, bool unique)
+      : m_files(files),
+        m_record_size(record_size),
+        m_key_size(key_size),
+        m_unique(unique)
+    {
+      // Besides the record itself, sorting takes one offset per record.
+      m_max_records = std::max(std::size_t(1), memory_budget / (record_size * sizeof(record_word) + sizeof(std::size_t)));
+    }
+
+    void push(const record_word* record)
+    {
+      m_buffer.insert(m_buffer.end(), record, record + m_record_size);
+      if (m_buffer.size() >= m_max_records * m_record_size)
+      {
+        flush();
+      }
+    }
+
+    /// \brief Writes the remaining records, and returns the names of the files with the sorted runs.
+    /// At most max_fan_in() runs are returned; if there are more, they are merged first. The caller
+    /// becomes responsible for removing the files.
+    std::vector<std::string> finish()
+    {
+      flush();
+      while (m_runs.size() > max_fan_in())
+      {
+        std::vector<std::string> runs;
+        for (std::size_t first = 0; first < m_runs.size(); first += max_fan_in())
+        {
+          std::vector<std::string> group(m_runs.begin() + first, m_runs.begin() + std::min(first + max_fan_in(), m_runs.size()));
+          std::string filename = m_files.create();
+          {
+            record_merger in(group, m_record_size, m_key_size, m_unique);
+            record_writer out(filename, m_record_size);
+            for (; in.valid(); in.next())
+            {
+              out.write(in.current());
+            }
+            out.close();
+          }
+          m_files.remove(group);
+          runs.push_back(filename);
+        }
+        m_runs = runs;
+      }
+      std::vector<std::string> result;
+      std::swap(result, m_runs);
+      return result;
+    }
+};
+
+} // namespace detail
+
+} // namespace lts
+
+} // namespace mcrl2
+
+#endif // MCRL2_LTS_DETAIL_EXTERNAL_MEMORY_H
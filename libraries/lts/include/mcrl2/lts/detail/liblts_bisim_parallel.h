@@ -0,0 +1,429 @@
+// Author(s): Wieger Wesselink
+// Copyright: see the accompanying file COPYING or copy at
+// https://github.com/mCRL2org/mCRL2/blob/master/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file mcrl2/lts/detail/liblts_bisim_parallel.h
+/// \brief Multi-threaded partition refinement for strong and (divergence-preserving)
+///        branching bisimulation, based on the signature refinement approach of
+///        S. Blom and S. Orzan.
+
+#ifndef MCRL2_LTS_DETAIL_LIBLTS_BISIM_PARALLEL_H
+#define MCRL2_LTS_DETAIL_LIBLTS_BISIM_PARALLEL_H
+
+#include <algorithm>
+#include <thread>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "mcrl2/lts/detail/liblts_merge.h"
+#include "mcrl2/lts/detail/liblts_scc.h"
+#include "mcrl2/utilities/logger.h"
+
+namespace mcrl2
+{
+namespace lts
+{
+namespace detail
+{
+
+/// \brief Returns the number of threads that is used by default for parallel bisimulation reduction.
+inline
+std::size_t default_number_of_threads()
+{
+  return std::max(1u, std::thread::hardware_concurrency());
+}
+
+/// \brief Calls f(i) for all i in [first, last), divided over at most number_of_threads threads.
+/// \details Small ranges are handled by the calling thread only.
+template <typename Function>
+void parallel_for(std::size_t first, std::size_t last, std::size_t number_of_threads, Function f)
+{
+  const std::size_t minimum_chunk_size = 1024;
+  const std::size_t n = last - first;
+  const std::size_t thread_count = std::min(number_of_threads, n / minimum_chunk_size);
+  if (thread_count <= 1)
+  {
+    for (std::size_t i = first; i < last; ++i)
+    {
+      f(i);
+    }
+    return;
+  }
+
+  const std::size_t chunk_size = (n + thread_count - 1) / thread_count;
+  auto run = [&f, first, last, chunk_size](std::size_t k)
+  {
+    const std::size_t begin = first + k * chunk_size;
+    const std::size_t end = std::min(last, begin + chunk_size);
+    for (std::size_t i = begin; i < end; ++i)
+    {
+      f(i);
+    }
+  };
+  std::vector<std::thread> threads;
+  for (std::size_t k = 1; k < thread_count; ++k)
+  {
+    threads.emplace_back(run, k);
+  }
+  run(0);
+  for (std::thread& t: threads)
+  {
+    t.join();
+  }
+}
+
+/// \brief Computes (branching) bisimulation equivalence classes by signature refinement, using multiple threads.
+/// \details In each round the signature of every state is computed with respect to the current partition, and
+/// states are put in the same block if they were in the same block and have equal signatures. The signatures
+/// are computed in parallel. For branching bisimulation the signature of a state includes the signatures of its
+/// inert tau successors. Therefore the states are divided into layers, such that the tau successors of a state
+/// are in an earlier layer, and the layers are processed one after another. This requires that the LTS contains
+/// no tau cycles, other than tau self loops that indicate divergence.
+/// The blocks are numbered in the order in which they are first encountered when traversing the states in
+/// increasing order. Hence the result does not depend on the number of threads.
+template <class LTS_TYPE>
+class bisim_partitioner_parallel
+{
+  public:
+    typedef std::pair<std::size_t, std::size_t> signature_element; // (action label, target block)
+    typedef std::vector<signature_element> signature_type;
+
+  protected:
+    LTS_TYPE& m_lts;
+    bool m_branching;
+    bool m_preserve_divergence;
+    std::size_t m_number_of_threads;
+
+    // The transitions of state s are at positions [m_offsets[s], m_offsets[s + 1]) of m_labels and m_targets.
+    // The hidden label map has been applied to the labels.
+    std::vector<std::size_t> m_offsets;
+    std::vector<std::size_t> m_labels;
+    std::vector<std::size_t> m_targets;
+
+    // The states of layer k are at positions [m_layer_offsets[k], m_layer_offsets[k + 1]) of m_order.
+    std::vector<std::size_t> m_order;
+    std::vector<std::size_t> m_layer_offsets;
+
+    std::vector<std::size_t> m_partition;
+    std::size_t m_block_count = 1;
+    std::vector<signature_type> m_signatures;
+    std::vector<std::size_t> m_hashes;
+
+    bool is_tau(std::size_t label) const
+    {
+      return m_lts.is_tau(label);
+    }
+
+    // Returns true if the transition s -label-> t is inert with respect to the current partition. With
+    // divergence preservation a tau self loop is not inert, since it indicates that s is divergent.
+    bool is_inert(std::size_t s, std::size_t label, std::size_t t) const
+    {
+      return m_branching && is_tau(label) && m_partition[s] == m_partition[t] && (s != t || !m_preserve_divergence);
+    }
+
+    void compute_transitions()
+    {
+      const std::size_t n = m_lts.num_states();
+      m_offsets.assign(n + 1, 0);
+      for (const transition& t: m_lts.get_transitions())
+      {
+        m_offsets[t.from() + 1]++;
+      }
+      for (std::size_t s = 0; s < n; ++s)
+      {
+        m_offsets[s + 1] += m_offsets[s];
+      }
+      m_labels.resize(m_lts.get_transitions().size());
+      m_targets.resize(m_lts.get_transitions().size());
+      std::vector<std::size_t> position(m_offsets.begin(), m_offsets.end() - 1);
+      for (const transition& t: m_lts.get_transitions())
+      {
+        std::size_t& i = position[t.from()];
+        m_labels[i] = m_lts.apply_hidden_label_map(t.label());
+        m_targets[i] = t.to();
+        ++i;
+      }
+    }
+
+    // Assigns to each state its layer, which is 0 if it has no tau successors, and one more than the
+    // maximum layer of its tau successors otherwise. Tau self loops are ignored.
+    void compute_layers()
+    {
+      const std::size_t n = m_lts.num_states();
+      const std::size_t undefined = std::size_t(-1);
+      std::vector<std::size_t> layer(n, m_branching ? undefined : 0);
+      std::vector<std::pair<std::size_t, std::size_t> > stack; // (state, position of the next transition to visit)
+      for (std::size_t root = 0; root < n; ++root)
+      {
+        if (layer[root] != undefined)
+        {
+          continue;
+        }
+        layer[root] = 0;
+        stack.emplace_back(root, m_offsets[root]);
+        while (!stack.empty())
+        {
+          std::size_t s = stack.back().first;
+          std::size_t& i = stack.back().second;
+          if (i == m_offsets[s + 1])
+          {
+            stack.pop_back();
+            if (!stack.empty())
+            {
+              std::size_t p = stack.back().first;
+              layer[p] = std::max(layer[p], layer[s] + 1);
+            }
+            continue;
+          }
+          std::size_t t = m_targets[i];
+          if (is_tau(m_labels[i++]) && t != s)
+          {
+            if (layer[t] == undefined)
+            {
+              layer[t] = 0;
+              stack.emplace_back(t, m_offsets[t]);
+            }
+            else
+            {
+              layer[s] = std::max(layer[s], layer[t] + 1);
+            }
+          }
+        }
+      }
+
+      // Sort the states on their layer, using a counting sort.
+      std::size_t layer_count = n == 0 ? 0 : *std::max_element(layer.begin(), layer.end()) + 1;
+      m_layer_offsets.assign(layer_count + 1, 0);
+      for (std::size_t s = 0; s < n; ++s)
+      {
+        m_layer_offsets[layer[s] + 1]++;
+      }
+      for (std::size_t k = 0; k < layer_count; ++k)
+      {
+        m_layer_offsets[k + 1] += m_layer_offsets[k];
+      }
+      m_order.resize(n);
+      std::vector<std::size_t> position(m_layer_offsets.begin(), m_layer_offsets.end() - 1);
+      for (std::size_t s = 0; s < n; ++s)
+      {
+        m_order[position[layer[s]]++] = s;
+      }
+    }
+
+    void compute_signature(std::size_t s)
+    {
+      signature_type& sig = m_signatures[s];
+      sig.clear();
+      for (std::size_t i = m_offsets[s]; i < m_offsets[s + 1]; ++i)
+      {
+        std::size_t t = m_targets[i];
+        if (!is_inert(s, m_labels[i], t))
+        {
+          sig.emplace_back(m_labels[i], m_partition[t]);
+        }
+        else if (s != t)
+        {
+          // The signature of t has been computed before, since t is in an earlier layer.
+          sig.insert(sig.end(), m_signatures[t].begin(), m_signatures[t].end());
+        }
+      }
+      std::sort(sig.begin(), sig.end());
+      sig.erase(std::unique(sig.begin(), sig.end()), sig.end());
+
+      std::size_t h = m_partition[s];
+      for (const signature_element& e: sig)
+      {
+        h = h * 1000003 ^ e.first;
+        h = h * 1000003 ^ e.second;
+      }
+      m_hashes[s] = h;
+    }
+
+    // Computes the signatures, and the partition induced by them. Returns true if the number of blocks has increased.
+    bool refine()
+    {
+      for (std::size_t k = 0; k + 1 < m_layer_offsets.size(); ++k)
+      {
+        parallel_for(m_layer_offsets[k], m_layer_offsets[k + 1], m_number_of_threads, [&](std::size_t i)
+          {
+            compute_signature(m_order[i]);
+          });
+      }
+
+      const std::size_t n = m_lts.num_states();
+      std::vector<std::size_t> partition(n);
+      std::unordered_multimap<std::size_t, std::size_t> representatives; // maps hashes to the first state of a block
+      representatives.reserve(m_block_count);
+      std::size_t block_count = 0;
+      for (std::size_t s = 0; s < n; ++s)
+      {
+        auto range = representatives.equal_range(m_hashes[s]);
+        auto i = range.first;
+        for (; i != range.second; ++i)
+        {
+          std::size_t r = i->second;
+          if (m_partition[r] == m_partition[s] && m_signatures[r] == m_signatures[s])
+          {
+            partition[s] = partition[r];
+            break;
+          }
+        }
+        if (i == range.second)
+        {
+          partition[s] = block_count++;
+          representatives.emplace(m_hashes[s], s);
+        }
+      }
+
+      m_partition.swap(partition);
+      bool result = block_count != m_block_count;
+      m_block_count = block_count;
+      return result;
+    }
+
+  public:
+    /// \brief Constructor. The equivalence classes are computed immediately.
+    /// \param l The LTS. For branching bisimulation it may not contain tau cycles, apart from tau self loops.
+    /// \param branching If true, branching bisimulation is computed, otherwise strong bisimulation.
+    /// \param preserve_divergence If true, divergence is preserved by branching bisimulation.
+    /// \param number_of_threads The maximum number of threads that is used.
+    bisim_partitioner_parallel(LTS_TYPE& l, bool branching, bool preserve_divergence, std::size_t number_of_threads)
+      : m_lts(l),
+        m_branching(branching),
+        m_preserve_divergence(preserve_divergence),
+        m_number_of_threads(std::max(std::size_t(1), number_of_threads)),
+        m_partition(l.num_states(), 0),
+        m_block_count(l.num_states() == 0 ? 0 : 1),
+        m_signatures(l.num_states()),
+        m_hashes(l.num_states())
+    {
+      compute_transitions();
+      compute_layers();
+      std::size_t iterations = 0;
+      while (refine())
+      {
+        mCRL2log(log::verbose) << "parallel bisimulation: iteration " << ++iterations << ", " << m_block_count << " blocks" << std::endl;
+      }
+      m_signatures = std::vector<signature_type>();
+    }
+
+    /// \brief Returns the number of equivalence classes.
+    std::size_t num_eq_classes() const
+    {
+      return m_block_count;
+    }
+
+    /// \brief Returns the equivalence class of state s.
+    std::size_t get_eq_class(std::size_t s) const
+    {
+      return m_partition[s];
+    }
+
+    /// \brief Returns true if s and t are in the same equivalence class.
+    bool in_same_class(std::size_t s, std::size_t t) const
+    {
+      return m_partition[s] == m_partition[t];
+    }
+
+    /// \brief Replaces the LTS by its quotient with respect to the computed equivalence.
+    /// \details Inert transitions are removed; with divergence preservation tau self loops are kept.
+    /// The state labels of an equivalence class are concatenated.
+    void replace_transition_system()
+    {
+      std::vector<transition> transitions;
+      transitions.reserve(m_labels.size());
+      for (std::size_t s = 0; s < m_lts.num_states(); ++s)
+      {
+        for (std::size_t i = m_offsets[s]; i < m_offsets[s + 1]; ++i)
+        {
+          if (!is_inert(s, m_labels[i], m_targets[i]))
+          {
+            transitions.emplace_back(m_partition[s], m_labels[i], m_partition[m_targets[i]]);
+          }
+        }
+      }
+      auto less = [](const transition& x, const transition& y)
+      {
+        return std::make_tuple(x.from(), x.label(), x.to()) < std::make_tuple(y.from(), y.label(), y.to());
+      };
+      auto equal = [](const transition& x, const transition& y)
+      {
+        return x.from() == y.from() && x.label() == y.label() && x.to() == y.to();
+      };
+      std::sort(transitions.begin(), transitions.end(), less);
+      transitions.erase(std::unique(transitions.begin(), transitions.end(), equal), transitions.end());
+      m_lts.clear_transitions();
+      for (const transition& t: transitions)
+      {
+        m_lts.add_transition(t);
+      }
+
+      if (m_lts.has_state_info())
+      {
+        std::vector<typename LTS_TYPE::state_label_t> new_labels(m_block_count);
+        for (std::size_t i = m_lts.num_states(); i > 0; )
+        {
+          --i;
+          new_labels[m_partition[i]] = m_lts.state_label(i) + new_labels[m_partition[i]];
+        }
+        m_lts.set_num_states(m_block_count);
+        for (std::size_t i = 0; i < m_block_count; ++i)
+        {
+          m_lts.set_state_label(i, new_labels[i]);
+        }
+      }
+      else
+      {
+        m_lts.set_num_states(m_block_count);
+      }
+      m_lts.set_initial_state(m_partition[m_lts.initial_state()]);
+    }
+};
+
+/// \brief Reduces l modulo (divergence-preserving) branching or strong bisimulation, using multiple threads.
+/// \details The result does not depend on the number of threads.
+template <class LTS_TYPE>
+void bisimulation_reduce_parallel(LTS_TYPE& l, bool branching = false, bool preserve_divergence = false,
+                                  std::size_t number_of_threads = default_number_of_threads())
+{
+  // First, remove tau loops in case of branching bisimulation.
+  if (branching)
+  {
+    scc_reduce(l, preserve_divergence, number_of_threads);
+  }
+  bisim_partitioner_parallel<LTS_TYPE> partitioner(l, branching, preserve_divergence, number_of_threads);
+  partitioner.replace_transition_system();
+}
+
+/// \brief Checks whether the initial states of l1 and l2 are (divergence-preserving) branching or strong
+/// bisimilar, using multiple threads. Both LTSs are modified.
+template <class LTS_TYPE>
+bool destructive_bisimulation_compare_parallel(LTS_TYPE& l1, LTS_TYPE& l2, bool branching = false, bool preserve_divergence = false,
+                                               std::size_t number_of_threads = default_number_of_threads())
+{
+  std::size_t init_l2 = l2.initial_state() + l1.num_states();
+  detail::merge(l1, l2);
+  l2.clear(); // No use for l2 anymore.
+
+  // First remove tau loops in case of branching bisimulation.
+  if (branching)
+  {
+    scc_partitioner<LTS_TYPE> scc_part(l1, number_of_threads);
+    scc_part.replace_transition_system(preserve_divergence);
+    init_l2 = scc_part.get_eq_class(init_l2);
+  }
+
+  bisim_partitioner_parallel<LTS_TYPE> partitioner(l1, branching, preserve_divergence, number_of_threads);
+  return partitioner.in_same_class(l1.initial_state(), init_l2);
+}
+
+} // namespace detail
+} // namespace lts
+} // namespace mcrl2
+
+#endif // MCRL2_LTS_DETAIL_LIBLTS_BISIM_PARALLEL_H
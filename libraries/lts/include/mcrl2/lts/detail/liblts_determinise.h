@@ -0,0 +1,226 @@
+// Author(s): Wieger Wesselink
+// Copyright: see the accompanying file COPYING or copy at
+// https://github.com/mCRL2org/mCRL2/blob/master/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file mcrl2/lts/detail/liblts_determinise.h
+/// \brief Determinisation of an LTS by the subset construction, in which the subsets of a
+///        breadth first level are processed in parallel.
+
+#ifndef MCRL2_LTS_DETAIL_LIBLTS_DETERMINISE_H
+#define MCRL2_LTS_DETAIL_LIBLTS_DETERMINISE_H
+
+#include <algorithm>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "mcrl2/lts/detail/liblts_bisim_parallel.h"
+#include "mcrl2/utilities/logger.h"
+
+namespace mcrl2
+{
+namespace lts
+{
+namespace detail
+{
+
+/// \brief A 128 bit hash value of a set of states, consisting of two independent 64 bit hashes.
+struct subset_hash
+{
+  std::uint64_t first = 0;
+  std::uint64_t second = 0;
+};
+
+inline
+std::uint64_t mix_subset_hash(std::uint64_t x)
+{
+  // The finaliser of splitmix64.
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+  return x ^ (x >> 31);
+}
+
+/// \brief Returns the hash of the sorted sequence of states [first, last).
+inline
+subset_hash compute_subset_hash(const std::size_t* first, const std::size_t* last)
+{
+  subset_hash result;
+  result.first = 0x9e3779b97f4a7c15ULL;
+  result.second = 0xc2b2ae3d27d4eb4fULL;
+  for (const std::size_t* i = first; i != last; ++i)
+  {
+    result.first = mix_subset_hash(result.first ^ *i);
+    result.second = mix_subset_hash(result.second + 0x9e3779b97f4a7c15ULL * (*i + 1));
+  }
+  return result;
+}
+
+/// \brief Stores the sets of states that are the states of the deterministic LTS. The sets
+/// are stored as sorted sequences in one array, and are found using their 128 bit hash.
+/// The first half of the hash is the key of the index, the second half is compared
+/// before the elements are compared.
+class subset_store
+{
+  protected:
+    std::vector<std::size_t> m_offsets = { 0 };
+    std::vector<std::size_t> m_elements;
+    std::vector<std::uint64_t> m_second_hashes;
+    std::unordered_multimap<std::uint64_t, std::size_t> m_index;
+
+  public:
+    /// \brief Returns the number of sets.
+    std::size_t size() const
+    {
+      return m_offsets.size() - 1;
+    }
+
+    const std::size_t* begin(std::size_t i) const
+    {
+      return m_elements.data() + m_offsets[i];
+    }
+
+    const std::size_t* end(std::size_t i) const
+    {
+      return m_elements.data() + m_offsets[i + 1];
+    }
+
+    /// \brief Returns the number of the set [first, last) with hash h, and true if it was not stored before.
+    std::pair<std::size_t, bool> insert(const std::size_t* first, const std::size_t* last, const subset_hash& h)
+    {
+      auto range = m_index.equal_range(h.first);
+      for (auto i = range.first; i != range.second; ++i)
+      {
+        const std::size_t j = i->second;
+        if (m_second_hashes[j] == h.second && std::equal(first, last, begin(j), end(j)))
+        {
+          return std::make_pair(j, false);
+        }
+      }
+      const std::size_t result = size();
+      m_elements.insert(m_elements.end(), first, last);
+      m_offsets.push_back(m_elements.size());
+      m_second_hashes.push_back(h.second);
+      m_index.emplace(h.first, result);
+      return std::make_pair(result, true);
+    }
+};
+
+/// \brief Computes the deterministic LTS of l by the subset construction. The sets are explored
+/// level by level in breadth first order. For all sets of a level the successor sets are computed
+/// in parallel, after which they are numbered sequentially. The resulting numbering of the states
+/// is the breadth first order, and does not depend on the number of threads.
+/// \details Hidden labels are treated as tau.
+template <class LTS_TYPE>
+void subset_construction(LTS_TYPE& l, std::size_t number_of_threads = default_number_of_threads())
+{
+  typedef std::pair<std::size_t, std::size_t> edge; // (label, target)
+
+  // The successor sets of one set, grouped by label.
+  struct successor_sets
+  {
+    std::vector<std::size_t> labels;
+    std::vector<std::size_t> offsets;
+    std::vector<std::size_t> elements;
+    std::vector<subset_hash> hashes;
+  };
+
+  // Store the outgoing transitions per state, sorted on label and target.
+  const std::size_t n = l.num_states();
+  std::vector<std::size_t> offsets(n + 1, 0);
+  for (const transition& t: l.get_transitions())
+  {
+    offsets[t.from() + 1]++;
+  }
+  for (std::size_t s = 0; s < n; ++s)
+  {
+    offsets[s + 1] += offsets[s];
+  }
+  std::vector<edge> edges(l.num_transitions());
+  {
+    std::vector<std::size_t> position(offsets.begin(), offsets.end() - 1);
+    for (const transition& t: l.get_transitions())
+    {
+      edges[position[t.from()]++] = edge(l.apply_hidden_label_map(t.label()), t.to());
+    }
+  }
+  const std::size_t initial_state = l.initial_state();
+  l.clear_transitions();
+  l.clear_state_labels();
+
+  subset_store subsets;
+  subsets.insert(&initial_state, &initial_state + 1, compute_subset_hash(&initial_state, &initial_state + 1));
+  std::vector<transition> transitions;
+  std::vector<std::size_t> frontier = { 0 };
+  std::vector<std::size_t> next_frontier;
+  std::size_t level = 0;
+
+  while (!frontier.empty())
+  {
+    std::vector<successor_sets> successors(frontier.size());
+    parallel_for(0, frontier.size(), number_of_threads, [&](std::size_t i)
+    {
+      std::vector<edge> out;
+      for (const std::size_t* s = subsets.begin(frontier[i]); s != subsets.end(frontier[i]); ++s)
+      {
+        out.insert(out.end(), edges.begin() + offsets[*s], edges.begin() + offsets[*s + 1]);
+      }
+      std::sort(out.begin(), out.end());
+      out.erase(std::unique(out.begin(), out.end()), out.end());
+
+      successor_sets& result = successors[i];
+      for (auto j = out.begin(); j != out.end(); )
+      {
+        const std::size_t label = j->first;
+        result.labels.push_back(label);
+        result.offsets.push_back(result.elements.size());
+        for (; j != out.end() && j->first == label; ++j)
+        {
+          result.elements.push_back(j->second);
+        }
+      }
+      result.offsets.push_back(result.elements.size());
+      for (std::size_t k = 0; k < result.labels.size(); ++k)
+      {
+        result.hashes.push_back(compute_subset_hash(result.elements.data() + result.offsets[k],
+                                                    result.elements.data() + result.offsets[k + 1]));
+      }
+    });
+
+    next_frontier.clear();
+    for (std::size_t i = 0; i < frontier.size(); ++i)
+    {
+      const successor_sets& succ = successors[i];
+      for (std::size_t k = 0; k < succ.labels.size(); ++k)
+      {
+        std::pair<std::size_t, bool> p = subsets.insert(succ.elements.data() + succ.offsets[k],
+                                                        succ.elements.data() + succ.offsets[k + 1],
+                                                        succ.hashes[k]);
+        if (p.second)
+        {
+          next_frontier.push_back(p.first);
+        }
+        transitions.emplace_back(frontier[i], succ.labels[k], p.first);
+      }
+    }
+    frontier.swap(next_frontier);
+    mCRL2log(log::debug) << "determinisation: level " << ++level << ", generated " << subsets.size()
+                         << " states and " << transitions.size() << " transitions" << std::endl;
+  }
+
+  l.set_num_states(subsets.size(), false); // remove the state values, and reset the number of states.
+  l.set_initial_state(0);
+  for (const transition& t: transitions)
+  {
+    l.add_transition(t);
+  }
+}
+
+} // namespace detail
+} // namespace lts
+} // namespace mcrl2
+
+#endif // MCRL2_LTS_DETAIL_LIBLTS_DETERMINISE_H
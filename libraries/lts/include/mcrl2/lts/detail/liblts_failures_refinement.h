@@ -100,6 +100,7 @@ namespace detail
       std::vector<std::vector<transition> > m_sorted_transitions;
       std::vector<bool> m_divergent;
       std::vector<action_label_set> m_enabled_actions;
+      mutable std::map<set_of_states, set_of_states> m_stable_tau_reachable_states;
       
     private:
       void calculate_weak_property_cache(const bool weak_reduction)
@@ -160,6 +161,12 @@ namespace detail
       {
         return m_enabled_actions[s];
       }
+
+      /// \brief A cache for the stable states that are reachable via tau steps from a set of states.
+      std::map<set_of_states, set_of_states>& stable_tau_reachable_states() const
+      {
+        return m_stable_tau_reachable_states;
+      }
   };
 
   template < class LTS_TYPE >
@@ -176,13 +183,15 @@ namespace detail
                  const bool weak_reduction,
                  const LTS_TYPE& l);
 
-  template < class LTS_TYPE >
+  template < class IMPL_CACHE, class IMPL_LTS_TYPE, class SPEC_LTS_TYPE >
   bool refusals_contained_in(
               const state_type impl, 
               const set_of_states& spec, 
-              const lts_cache<LTS_TYPE>& weak_property_cache,
+              const IMPL_CACHE& impl_cache,
+              const lts_cache<SPEC_LTS_TYPE>& spec_cache,
               label_type& culprit,
-              const LTS_TYPE& l,
+              const IMPL_LTS_TYPE& impl_lts,
+              const SPEC_LTS_TYPE& spec_lts,
               const bool provide_a_counter_example);
 
   /* Construct a path to state s using the backward map, and return it in result */
@@ -202,10 +211,10 @@ namespace detail
     }
   }
 
-  template < class LTS_TYPE >
+  template < class CACHE, class LTS_TYPE >
   std::vector<label_type> find_path_to_stable_state_without_action_in_impl(const label_type offending_action, 
                                                                            const state_type s, 
-                                                                           const lts_cache<LTS_TYPE>& lts_cache,
+                                                                           const CACHE& lts_cache,
                                                                            const LTS_TYPE& l,
                                                                            const bool find_trace_with_taus)
   {
@@ -261,6 +270,131 @@ namespace detail
 
 enum refinement_type { trace, failures, failures_divergence };
 
+namespace detail
+{
+  /* This function contains the antichain algorithm of the paper mentioned above. It checks whether
+   * state impl_init of the implementation is included in state spec_init of the specification.
+   * The implementation is accessed via impl_cache, which offers the same functions as lts_cache,
+   * and impl, which is used to interpret its action labels. The hidden action labels of impl
+   * must be the hidden action labels of spec, or labels that do not occur in spec.
+   * Both sides may be the same transition system. */
+  template < class IMPL_CACHE, class IMPL_LTS_TYPE, class SPEC_LTS_TYPE, class COUNTER_EXAMPLE_CONSTRUCTOR >
+  bool antichain_refinement_check(
+                          const IMPL_CACHE& impl_cache,
+                          const IMPL_LTS_TYPE& impl,
+                          const state_type impl_init,
+                          const lts_cache<SPEC_LTS_TYPE>& spec_cache,
+                          const SPEC_LTS_TYPE& spec,
+                          const state_type spec_init,
+                          const refinement_type refinement,
+                          const bool weak_reduction,
+                          COUNTER_EXAMPLE_CONSTRUCTOR& generate_counter_example)
+  {
+    std::deque< state_states_counter_example_index_triple < COUNTER_EXAMPLE_CONSTRUCTOR > > 
+                working(  // let working be a stack containg the triple (init1,{s|init2-->s},root_index);
+                      { state_states_counter_example_index_triple< COUNTER_EXAMPLE_CONSTRUCTOR >(
+                                    impl_init, 
+                                    collect_reachable_states_via_taus(spec_init,spec_cache,weak_reduction),
+                                    generate_counter_example.root_index() ) });
+                                                        // let antichain := emptyset;
+    anti_chain_type anti_chain;
+    antichain_insert(anti_chain, working.front());      // antichain := antichain united with (impl,spec); 
+                                                        // This line occurs at another place in the code than in 
+                                                        // the original algorithm, where insertion in the anti-chain
+                                                        // was too late, causing too many impl-spec pairs to be investigated. 
+    while (working.size()>0)                            // while working!=empty
+    {
+      state_states_counter_example_index_triple < COUNTER_EXAMPLE_CONSTRUCTOR > impl_spec;   // pop (impl,spec) from working;
+      impl_spec.swap(working.front());  
+      working.pop_front();     // At this point it could be checked whether impl_spec still exists in anti_chain. 
+                               // Small scale experiments show that this is a little bit more expensive than doing the explicit check below. 
+    
+      if (refinement==failures_divergence && impl_cache.diverges(impl_spec.state()))
+                                                        // if impl diverges
+      {
+        bool spec_diverges=false;
+        for(const state_type s: impl_spec.states())       // if spec does not diverge
+        {
+          if (spec_cache.diverges(s))
+          {
+            spec_diverges=true;
+            break;
+          }
+        }
+        if (!spec_diverges)
+        {
+          generate_counter_example.save_counter_example(impl_spec.counter_example_index(),impl);
+          return false;                                 // return false; 
+        }
+      }
+      else 
+      {
+        if (refinement==failures || refinement==failures_divergence)
+        { 
+          label_type offending_action=std::size_t(-1);
+          // if refusals(impl) not contained in refusals(spec) then 
+          if (!refusals_contained_in(impl_spec.state(),
+                                     impl_spec.states(),
+                                     impl_cache,
+                                     spec_cache,
+                                     offending_action,
+                                     impl,
+                                     spec,
+                                     !generate_counter_example.is_dummy()))   
+          {
+            std::vector<label_type> counter_example_extension;
+            if (offending_action!=std::size_t(-1))
+            { 
+              counter_example_extension = 
+                         find_path_to_stable_state_without_action_in_impl(offending_action, 
+                                                                          impl_spec.state(),
+                                                                          impl_cache,
+                                                                          impl, 
+                                                                          failures_divergence || weak_reduction);
+            }
+            generate_counter_example.save_counter_example(impl_spec.counter_example_index(),impl, counter_example_extension);
+            return false;                               // return false; 
+          }
+        }
+      
+        for(const transition& t: impl_cache.transitions(impl_spec.state()))
+        {
+          const typename COUNTER_EXAMPLE_CONSTRUCTOR::index_type new_counterexample_index=
+                 generate_counter_example.add_transition(t.label(),impl_spec.counter_example_index());
+          set_of_states spec_prime;
+          if (impl.is_tau(impl.apply_hidden_label_map(t.label())) && weak_reduction)                   // if e=tau then
+          {
+            spec_prime=impl_spec.states();        // spec' := spec;
+          }
+          else
+          {                                           // spec' := {s' | exists s in spec. s-e->s'};
+            for(const state_type s: impl_spec.states())  
+            {
+              set_of_states reachable_states_from_s_via_e=
+                      collect_reachable_states_via_an_action(s,impl.apply_hidden_label_map(t.label()),spec_cache,weak_reduction,spec);
+              spec_prime.insert(reachable_states_from_s_via_e.begin(),reachable_states_from_s_via_e.end());
+            }
+          }
+          if (spec_prime.empty())                     // if spec'={} then
+          {
+            generate_counter_example.save_counter_example(new_counterexample_index,impl);
+            return false;                             //    return false;  
+          }
+                                                      // if (impl',spec') in antichain is not true then
+          const state_states_counter_example_index_triple < COUNTER_EXAMPLE_CONSTRUCTOR > 
+                            impl_spec_counterex(t.to(),spec_prime,new_counterexample_index);
+          if (antichain_insert(anti_chain, impl_spec_counterex))   
+          {
+            working.push_back(impl_spec_counterex);   // push(impl,spec') into working;
+          }
+        }
+      }
+    
+    }
+    return true;                                      // return true;
+  }
+} // namespace detail
+
 /* This function checks using algorithms in the paper mentioned above that
  * whether transition system l1 is included in transition system l2, in the
  * sense of trace inclusions, failures inclusion and divergence failures 
@@ -268,7 +402,6 @@ enum refinement_type { trace, failures, failures_divergence };
  * are included. When generate_counter_example is set, a labelled transition 
  * system is generated that can act as a counterexample. It consists of a 
  * trace, followed by outgoing transitions representing a refusal set. */
-
 template < class LTS_TYPE, class COUNTER_EXAMPLE_CONSTRUCTOR = detail::dummy_counter_example_constructor >
 bool destructive_refinement_checker(
                         LTS_TYPE& l1, 
@@ -303,109 +436,11 @@ bool destructive_refinement_checker(
   }
 
   const detail::lts_cache<LTS_TYPE> weak_property_cache(l1,weak_reduction);
-  std::deque< detail::state_states_counter_example_index_triple < COUNTER_EXAMPLE_CONSTRUCTOR > > 
-              working(  // let working be a stack containg the triple (init1,{s|init2-->s},root_index);
-                    { detail::state_states_counter_example_index_triple< COUNTER_EXAMPLE_CONSTRUCTOR >(
-                                  l1.initial_state(), 
-                                  detail::collect_reachable_states_via_taus(init_l2,weak_property_cache,weak_reduction),
-                                  generate_counter_example.root_index() ) });
-                                                      // let antichain := emptyset;
-  detail::anti_chain_type anti_chain;
-  detail::antichain_insert(anti_chain, working.front());   // antichain := antichain united with (impl,spec); 
-                                                           // This line occurs at another place in the code than in 
-                                                           // the original algorithm, where insertion in the anti-chain
-                                                           // was too late, causing too many impl-spec pairs to be investigated. 
-  while (working.size()>0)                            // while working!=empty
-  {
-    detail::state_states_counter_example_index_triple < COUNTER_EXAMPLE_CONSTRUCTOR > impl_spec;   // pop (impl,spec) from working;
-    impl_spec.swap(working.front());  
-    working.pop_front();     // At this point it could be checked whether impl_spec still exists in anti_chain. 
-                             // Small scale experiments show that this is a little bit more expensive than doing the explicit check below. 
-    
-    if (refinement==failures_divergence && weak_property_cache.diverges(impl_spec.state()))
-                                                      // if impl diverges
-    {
-      bool spec_diverges=false;
-      for(const detail::state_type s: impl_spec.states())       // if spec does not diverge
-      {
-        if (weak_property_cache.diverges(s))
-        {
-          spec_diverges=true;
-          break;
-        }
-      }
-      if (!spec_diverges)
-      {
-        generate_counter_example.save_counter_example(impl_spec.counter_example_index(),l1);
-        return false;                                 // return false; 
-      }
-    }
-    else 
-    {
-      if (refinement==failures || refinement==failures_divergence)
-      { 
-        detail::label_type offending_action=std::size_t(-1);
-        // if refusals(impl) not contained in refusals(spec) then 
-        if (!detail::refusals_contained_in(impl_spec.state(),
-                                           impl_spec.states(),
-                                           weak_property_cache,
-                                           offending_action,
-                                           l1,
-                                           !generate_counter_example.is_dummy()))   
-        {
-          std::vector<detail::label_type> counter_example_extension;
-          if (offending_action!=std::size_t(-1))
-          { 
-            counter_example_extension = 
-                       detail::find_path_to_stable_state_without_action_in_impl(offending_action, 
-                                                                                impl_spec.state(),
-                                                                                weak_property_cache,
-                                                                                l1, 
-                                                                                failures_divergence || weak_reduction);
-          }
-          generate_counter_example.save_counter_example(impl_spec.counter_example_index(),l1, counter_example_extension);
-          return false;                               // return false; 
-        }
-      }
-      
-      for(const transition& t: weak_property_cache.transitions(impl_spec.state()))
-      {
-        const typename COUNTER_EXAMPLE_CONSTRUCTOR::index_type new_counterexample_index=
-               generate_counter_example.add_transition(t.label(),impl_spec.counter_example_index());
-        detail::set_of_states spec_prime;
-        if (l1.is_tau(l1.apply_hidden_label_map(t.label())) && weak_reduction)                   // if e=tau then
-        {
-          spec_prime=impl_spec.states();        // spec' := spec;
-        }
-        else
-        {                                           // spec' := {s' | exists s in spec. s-e->s'};
-          for(const detail::state_type s: impl_spec.states())  
-          {
-            detail::set_of_states reachable_states_from_s_via_e=
-                    detail::collect_reachable_states_via_an_action(s,l1.apply_hidden_label_map(t.label()),weak_property_cache,weak_reduction,l1);
-            spec_prime.insert(reachable_states_from_s_via_e.begin(),reachable_states_from_s_via_e.end());
-          }
-        }
-        if (spec_prime.empty())                     // if spec'={} then
-        {
-          generate_counter_example.save_counter_example(new_counterexample_index,l1);
-          return false;                             //    return false;  
-        }
-                                                    // if (impl',spec') in antichain is not true then
-        const detail::state_states_counter_example_index_triple < COUNTER_EXAMPLE_CONSTRUCTOR > 
-                          impl_spec_counterex(t.to(),spec_prime,new_counterexample_index);
-        if (detail::antichain_insert(anti_chain, impl_spec_counterex))   
-        {
-          working.push_back(impl_spec_counterex);   // push(impl,spec') into working;
-        }
-      }
-    }
-    
-  }
-  return true;                                      // return true;
+  return detail::antichain_refinement_check(weak_property_cache, l1, l1.initial_state(),
+                                            weak_property_cache, l1, init_l2,
+                                            refinement, weak_reduction, generate_counter_example);
 }
 
-
 namespace detail
 {
   /* This function generates the set of states reachable from s within labelled
@@ -532,7 +567,7 @@ namespace detail
         const set_of_states& states, 
         const lts_cache<LTS_TYPE>& weak_property_cache)
   {
-    static std::map<set_of_states, set_of_states> cache;
+    std::map<set_of_states, set_of_states>& cache=weak_property_cache.stable_tau_reachable_states();
     const std::map<set_of_states, set_of_states>::const_iterator i=cache.find(states);
     if (i!=cache.end())
     {
@@ -592,16 +627,18 @@ namespace detail
      If enable(t') is not included in enable(s'), their is a problematic action a. This action is returned as "culprit".
      It can be used to construct an extended counterexample. 
   */
-  template < class LTS_TYPE >
+  template < class IMPL_CACHE, class IMPL_LTS_TYPE, class SPEC_LTS_TYPE >
   bool refusals_contained_in(
               const state_type impl, 
               const set_of_states& spec, 
-              const lts_cache<LTS_TYPE>& weak_property_cache,
+              const IMPL_CACHE& impl_cache,
+              const lts_cache<SPEC_LTS_TYPE>& spec_cache,
               label_type& culprit,
-              const LTS_TYPE& l,
+              const IMPL_LTS_TYPE& impl_lts,
+              const SPEC_LTS_TYPE& spec_lts,
               const bool provide_a_counter_example)
   {
-    if (!weak_property_cache.stable(impl)) return true; // Checking in case of instability is not necessary, but rather time consuming. 
+    if (!impl_cache.stable(impl)) return true; // Checking in case of instability is not necessary, but rather time consuming. 
 
     // This function calculates whether refusals(impl) are not included in the refusals(spec).
     // This is equivalent to:
@@ -609,7 +646,7 @@ namespace detail
     // from any of the states in spec: enable(s'')\enable(s') is not empty.
 
     // First calculate the refusal sets reachable from spec.
-    const set_of_states& tau_reachable_states_of_the_specification=calculate_tau_reachable_states(spec,weak_property_cache);
+    const set_of_states& tau_reachable_states_of_the_specification=calculate_tau_reachable_states(spec,spec_cache);
 
     // Now walk through the tau-reachable stable states s' of impl.
     static std::unordered_set<state_type> visited;
@@ -623,11 +660,11 @@ namespace detail
     {
       const state_type current_state=todo_stack.top();
       todo_stack.pop();
-      if (weak_property_cache.stable(current_state))
+      if (impl_cache.stable(current_state))
       {
         // Put the outgoing action labels in a set and put these in the result.
        
-        const action_label_set& impl_enabled_action_set=weak_property_cache.action_labels(current_state);
+        const action_label_set& impl_enabled_action_set=impl_cache.action_labels(current_state);
 
         bool success=false;
         // Compare the obtained enable set of s' with all those of the specification.
@@ -636,7 +673,7 @@ namespace detail
         {
           // Check whether the enabled actions of spec are included in the enabled actions of impl.
           // This is equivalent to checking that all spec_action_labels are in the impl_enabled_action_set.
-          const action_label_set& spec_action_labels=weak_property_cache.action_labels(s);
+          const action_label_set& spec_action_labels=spec_cache.action_labels(s);
           // Warning: std::includes checks whether the second range is included in the first. 
           bool inclusion_success=std::includes(impl_enabled_action_set.begin(), impl_enabled_action_set.end(),
                                                spec_action_labels.begin(), spec_action_labels.end());
@@ -671,7 +708,7 @@ namespace detail
               mCRL2log(log::verbose) << "A stable acceptance set of the left process is:\n";
               for(const label_type a: impl_enabled_action_set)
               {
-                mCRL2log(log::verbose) << l.action_label(a) << "\n";
+                mCRL2log(log::verbose) << impl_lts.action_label(a) << "\n";
               }
             }
             // Print the acceptance sets of the specification. 
@@ -685,11 +722,11 @@ namespace detail
               mCRL2log(log::verbose) << "Below all corresponding stable acceptance sets of the right process are provided:\n";
               for(const state_type s: tau_reachable_states_of_the_specification)
               {
-                const action_label_set& spec_action_labels=weak_property_cache.action_labels(s);
+                const action_label_set& spec_action_labels=spec_cache.action_labels(s);
                 mCRL2log(log::verbose) << "An acceptance set of the right process is:\n";
                 for(const label_type a: spec_action_labels)
                 {
-                  mCRL2log(log::verbose) << l.action_label(a) << "\n";
+                  mCRL2log(log::verbose) << spec_lts.action_label(a) << "\n";
                 }
               }
             }
@@ -706,7 +743,7 @@ namespace detail
       {
         // Put the states reachable in one tau step onto the todo stack, if they have not 
         // been visited yet. 
-        for(const state_type s: weak_property_cache.tau_reachable_states(current_state)) 
+        for(const state_type s: impl_cache.tau_reachable_states(current_state)) 
         {
           if (visited.insert(s).second) // s is a new state.
           {
@@ -0,0 +1,262 @@
+// Author(s): Wieger Wesselink
+// Copyright: see the accompanying file COPYING or copy at
+// https://github.com/mCRL2org/mCRL2/blob/master/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file mcrl2/lts/detail/liblts_onthefly_refinement.h
+/// \brief Antichain based trace and failures refinement checking of an LPS against an LTS, where the
+///        state space of the LPS is explored on the fly.
+
+#ifndef MCRL2_LTS_DETAIL_LIBLTS_ONTHEFLY_REFINEMENT_H
+#define MCRL2_LTS_DETAIL_LIBLTS_ONTHEFLY_REFINEMENT_H
+
+#include <algorithm>
+#include <deque>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "mcrl2/atermpp/indexed_set.h"
+#include "mcrl2/lps/detail/instantiate_global_variables.h"
+#include "mcrl2/lps/next_state_generator.h"
+#include "mcrl2/lps/one_point_rule_rewrite.h"
+#include "mcrl2/lps/resolve_name_clashes.h"
+#include "mcrl2/lts/action_label_string.h"
+#include "mcrl2/lts/detail/liblts_failures_refinement.h"
+
+namespace mcrl2
+{
+namespace lts
+{
+namespace detail
+{
+
+/// \brief Explores the state space of an LPS on demand, and offers the same functions as lts_cache
+/// for the states that are encountered. The successors of a state are computed the first time they
+/// are needed. The initial state of the LPS has number 0.
+/// \details The action labels of the transitions are numbered such that they can be compared with those
+/// of a specification LTS: a multi-action whose text is equal to the text of an action label of the
+/// specification gets the number of that label after applying the hidden label map of the specification.
+/// The other multi-actions get numbers beyond those of the specification. Hence apply_hidden_label_map
+/// is the identity.
+class lps_cache
+{
+  protected:
+    lps::specification m_specification;
+    std::unique_ptr<lps::next_state_generator> m_generator;
+    bool m_weak_reduction;
+
+    // The fields below are computed lazily, hence they are mutable.
+    mutable lps::next_state_generator::enumerator_queue m_enumeration_queue;
+    mutable atermpp::indexed_set<lps::state> m_states;
+    mutable std::deque<bool> m_explored;
+    mutable std::deque<std::vector<transition> > m_transitions;
+    mutable std::deque<std::vector<state_type> > m_tau_reachable_states;
+    mutable std::deque<action_label_set> m_enabled_actions;
+    mutable std::deque<signed char> m_divergent; // -1 means that it has not been computed yet
+    mutable std::unordered_map<std::string, label_type> m_label_numbers;
+    mutable std::vector<action_label_string> m_action_labels;
+
+    state_type put_state(const lps::state& s) const
+    {
+      std::pair<std::size_t, bool> p = m_states.put(s);
+      if (p.second)
+      {
+        m_explored.push_back(false);
+        m_transitions.emplace_back();
+        m_tau_reachable_states.emplace_back();
+        m_enabled_actions.emplace_back();
+        m_divergent.push_back(-1);
+      }
+      return p.first;
+    }
+
+    label_type label_number(const lps::multi_action& a) const
+    {
+      std::string text = lps::pp(a);
+      auto i = m_label_numbers.find(text);
+      if (i != m_label_numbers.end())
+      {
+        return i->second;
+      }
+      label_type result = m_action_labels.size();
+      m_action_labels.push_back(action_label_string(text));
+      m_label_numbers[text] = result;
+      return result;
+    }
+
+    void explore(const state_type s) const
+    {
+      if (m_explored[s])
+      {
+        return;
+      }
+      m_explored[s] = true;
+      const lps::state state = m_states.get(s);
+      std::vector<transition> transitions;
+      m_enumeration_queue.clear();
+      auto end = m_generator->end();
+      for (auto i = m_generator->begin(state, &m_enumeration_queue); i != end; ++i)
+      {
+        transitions.emplace_back(s, label_number(i->action), put_state(i->target_state));
+      }
+      for (const transition& t: transitions)
+      {
+        if (m_weak_reduction && is_tau(t.label()))
+        {
+          m_tau_reachable_states[s].push_back(t.to());
+        }
+        m_enabled_actions[s].insert(t.label());
+      }
+      m_transitions[s].swap(transitions);
+    }
+
+  public:
+    /// \brief Constructor.
+    /// \param lpsspec The LPS that is explored.
+    /// \param strategy The rewrite strategy used for exploring the LPS.
+    /// \param spec The specification whose action labels are used.
+    /// \param weak_reduction If true, tau steps are internal.
+    template <class LTS_TYPE>
+    lps_cache(const lps::specification& lpsspec, data::rewrite_strategy strategy, const LTS_TYPE& spec, const bool weak_reduction)
+      : m_specification(lpsspec),
+        m_weak_reduction(weak_reduction)
+    {
+      for (label_type i = 0; i < spec.num_action_labels(); ++i)
+      {
+        const std::string text = pp(spec.action_label(i));
+        m_action_labels.push_back(action_label_string(text));
+        m_label_numbers.insert(std::make_pair(text, spec.apply_hidden_label_map(i)));
+      }
+      m_label_numbers.insert(std::make_pair(lps::pp(lps::multi_action()), spec.tau_label_index()));
+
+      lps::resolve_summand_variable_name_clashes(m_specification);
+      lps::detail::instantiate_global_variables(m_specification);
+      lps::one_point_rule_rewrite(m_specification);
+      data::rewriter rewriter(m_specification.data(), strategy);
+      m_generator = std::make_unique<lps::next_state_generator>(m_specification, rewriter);
+      put_state(m_generator->initial_state());
+    }
+
+    /// \brief Returns the number of states that have been encountered.
+    std::size_t num_states() const
+    {
+      return m_states.size();
+    }
+
+    /// \brief Returns the number of states of which the successors have been computed.
+    std::size_t num_explored_states() const
+    {
+      return std::count(m_explored.begin(), m_explored.end(), true);
+    }
+
+    bool stable(const state_type s) const
+    {
+      explore(s);
+      return m_tau_reachable_states[s].empty();
+    }
+
+    const std::vector<state_type>& tau_reachable_states(const state_type s) const
+    {
+      explore(s);
+      return m_tau_reachable_states[s];
+    }
+
+    const std::vector<transition>& transitions(const state_type s) const
+    {
+      explore(s);
+      return m_transitions[s];
+    }
+
+    /// \brief Returns true if s is on a cycle of tau steps.
+    bool diverges(const state_type s) const
+    {
+      if (m_divergent[s] < 0)
+      {
+        bool result = false;
+        std::unordered_set<state_type> visited;
+        std::vector<state_type> todo = { s };
+        while (!todo.empty() && !result)
+        {
+          const state_type u = todo.back();
+          todo.pop_back();
+          for (const state_type v: tau_reachable_states(u))
+          {
+            if (v == s)
+            {
+              result = true;
+              break;
+            }
+            if (visited.insert(v).second)
+            {
+              todo.push_back(v);
+            }
+          }
+        }
+        m_divergent[s] = result ? 1 : 0;
+      }
+      return m_divergent[s] == 1;
+    }
+
+    const action_label_set& action_labels(const state_type s) const
+    {
+      explore(s);
+      return m_enabled_actions[s];
+    }
+
+    bool is_tau(const label_type a) const
+    {
+      return a == 0;
+    }
+
+    label_type apply_hidden_label_map(const label_type a) const
+    {
+      return a;
+    }
+
+    const action_label_string& action_label(const label_type a) const
+    {
+      return m_action_labels[a];
+    }
+};
+
+} // namespace detail
+
+/* This function checks whether the process of the LPS implementation is included in the transition
+ * system specification, in the sense of trace inclusion, failures inclusion or divergence failures
+ * inclusion, as destructive_refinement_checker does. The state space of the implementation is not
+ * generated beforehand, but explored while the antichain algorithm runs, and the exploration stops
+ * at the first counterexample. The specification is reduced modulo (divergence preserving) branching
+ * or strong bisimulation first, which does not change its traces or failures. If a counterexample is
+ * requested, it consists of the multi-actions of the implementation. */
+template < class LTS_TYPE, class COUNTER_EXAMPLE_CONSTRUCTOR = detail::dummy_counter_example_constructor >
+bool lps_refinement_checker(
+                        const lps::specification& implementation,
+                        LTS_TYPE& specification,
+                        const refinement_type refinement,
+                        const bool weak_reduction,
+                        const data::rewrite_strategy strategy = data::jitty,
+                        COUNTER_EXAMPLE_CONSTRUCTOR generate_counter_example = detail::dummy_counter_example_constructor())
+{
+  const bool preserve_divergence=weak_reduction && (refinement!=trace);
+  specification.clear_state_labels();
+  detail::bisimulation_reduce_gjkw(specification, weak_reduction, preserve_divergence);
+
+  const detail::lts_cache<LTS_TYPE> spec_cache(specification, weak_reduction);
+  const detail::lps_cache impl_cache(implementation, strategy, specification, weak_reduction);
+  const bool result = detail::antichain_refinement_check(impl_cache, impl_cache, 0,
+                                                         spec_cache, specification, specification.initial_state(),
+                                                         refinement, weak_reduction, generate_counter_example);
+  mCRL2log(log::verbose) << "explored " << impl_cache.num_explored_states() << " of the "
+                         << impl_cache.num_states() << " encountered states of the implementation" << std::endl;
+  return result;
+}
+
+} // namespace lts
+} // namespace mcrl2
+
+#endif // MCRL2_LTS_DETAIL_LIBLTS_ONTHEFLY_REFINEMENT_H
@@ -10,13 +10,16 @@
 
 #ifndef _LIBLTS_PBISIM_BEM_H
 #define _LIBLTS_PBISIM_BEM_H
+#include <algorithm>
+#include <cassert>
 #include <cmath>
 #include <vector>
-#include <map>
 #include <list>
+#include <iterator>
 #include <deque>
 #include <unordered_map>
 #include "mcrl2/utilities/execution_timer.h"
+#include "mcrl2/utilities/hash_utility.h"
 #include "mcrl2/utilities/logger.h"
 #include "mcrl2/lts/lts_aut.h"
 #include "mcrl2/lts/detail/liblts_plts_merge.h"
@@ -82,21 +85,25 @@ class prob_bisim_partitioner_bem
     * \pre The bisimulation equivalence classes have been computed. */
     void replace_transitions()
     {
-      std::set < transition > resulting_transitions;
+      std::vector<transition> resulting_transitions;
 
       const std::vector<transition>& trans = aut.get_transitions();
+      resulting_transitions.reserve(trans.size());
       for (const transition& t : trans)
       {
-        resulting_transitions.insert(
-          transition(
+        resulting_transitions.emplace_back(
             get_eq_class(t.from()),
             t.label(),
-            get_eq_step_class(t.to())));
+            get_eq_step_class(t.to()));
       }
+      std::sort(resulting_transitions.begin(), resulting_transitions.end());
+      resulting_transitions.erase(std::unique(resulting_transitions.begin(), resulting_transitions.end()),
+                                  resulting_transitions.end());
+
       // Remove the old transitions
       aut.clear_transitions();
 
-      // Copy the transitions from the set into the transition system.
+      // Copy the transitions from the vector into the transition system.
       for (const transition& t : resulting_transitions)
       {
         aut.add_transition(t);
@@ -155,23 +162,27 @@ class prob_bisim_partitioner_bem
   struct distribution_type
   {
     distribution_key_type key;
-    std::vector< std::list<transition*> > incoming_transitions_per_label; // Incoming transitions organized per label
+    // The step classes <a,M> with this distribution in M, one per label a, with the position
+    // of this distribution in the distributions of the step class.
+    std::vector<std::pair<step_class_key_type, std::size_t> > step_classes;
+    bool reaches_splitter = false;
   };
   
   struct block_type
   {
     block_key_type key;
-    std::list<state_type> states;        // The states in the block
-    bool is_in_new_blocks;
+    std::vector<state_type> states;        // The states in the block
+    bool is_in_new_blocks = false;
+    typename std::list<block_type*>::iterator position;   // The position of the block in the state partition.
   };
 
   struct step_class_type {
     step_class_key_type key;
     label_type action;                                // action label of the pair <a,M>.
-    std::list<distribution_type*> distributions;      // The distributions in the step class <a,M>.
-    std::vector< bool > prev_states;                  // Previous states that can reach step_class <a,M>
-    bool is_in_new_step_classes;
+    std::vector<distribution_type*> distributions;    // The distributions in the step class <a,M>.
+    bool is_in_new_step_classes = false;
     std::size_t equivalent_step_class;
+    typename std::list<step_class_type*>::iterator position;   // The position of the step class in the step partition.
   };
 
   std::list<block_type*> state_partition;
@@ -183,172 +194,182 @@ class prob_bisim_partitioner_bem
   std::vector<block_key_type> block_index_of_a_state;
   std::vector<step_class_key_type> step_class_index_of_a_distribution;
 
+  // The incoming transitions of distribution d are the pairs (label, source) in incoming_transitions
+  // from position incoming_offsets[d] up to incoming_offsets[d+1], sorted on label.
+  std::vector<std::size_t> incoming_offsets;
+  std::vector<std::pair<label_type, state_type> > incoming_transitions;
+
+  // The distributions in which state s has a positive probability are in distributions_with_state
+  // from position distributions_with_state_offsets[s] up to distributions_with_state_offsets[s+1].
+  std::vector<std::size_t> distributions_with_state_offsets;
+  std::vector<distribution_key_type> distributions_with_state;
+
+  // Buffers that are used when refining. They are kept to avoid reallocation.
+  std::vector<bool> marked_states;
+  std::vector<state_type> marked_state_list;
+  std::vector<std::size_t> marked_states_per_block;
+  std::vector<block_key_type> blocks_with_marked_states;
+  std::vector<std::pair<probability_fraction_type, distribution_type*> > distributions_reaching_splitter;
+  std::vector<std::pair<step_class_key_type, std::size_t> > split_entries;
+
   LTS_TYPE& aut;
 
-  struct tree_type
+  /** \brief Stably sorts the indices in order on the value of key, which must be smaller than number_of_keys.
+   *  \return The offsets of the keys: the indices with key k are at the positions offsets[k] up to offsets[k+1]. */
+  template <class KEY>
+  static std::vector<std::size_t> counting_sort(std::vector<std::size_t>& order, const std::size_t number_of_keys, KEY key)
   {
-    std::list<state_type> states;
-    std::size_t count;
-    tree_type* left;
-    tree_type* right;
-
-    void init_node()
+    std::vector<std::size_t> offsets(number_of_keys + 1, 0);
+    for (const std::size_t i : order)
     {
-      count = 0;
-      left = NULL;
-      right = NULL;
+      offsets[key(i) + 1]++;
     }
-  };
+    for (std::size_t k = 0; k < number_of_keys; ++k)
+    {
+      offsets[k + 1] += offsets[k];
+    }
+    std::vector<std::size_t> result(order.size());
+    std::vector<std::size_t> position(offsets.begin(), offsets.end() - 1);
+    for (const std::size_t i : order)
+    {
+      result[position[key(i)]++] = i;
+    }
+    order.swap(result);
+    return offsets;
+  }
 
   /** \brief Creates the initial partition of step classes and blocks.
    *  \detail The blocks are initially partitioned based on the actions that can perform.
    *          The step classes are partitioned based on the action that leads to the probabilistic state */
   void create_initial_partition (void) 
   {
-    std::vector< std::vector< std::list<distribution_type*> > > steps; // Representation of transition in 2-d array
-    std::vector<transition>& transitions = aut.get_transitions();
-    std::vector< std::vector<bool> > distribution_per_step_class;
-    
-    distribution_per_step_class.resize(aut.num_action_labels());
-    for (std::vector<bool>& i : distribution_per_step_class)
-    {
-      i.resize(aut.num_probabilistic_states());
-    }
+    const std::vector<transition>& transitions = aut.get_transitions();
+    const std::size_t num_labels = aut.num_action_labels();
 
     //---- Preprocessing stage to transform the PLTS to the data structures suggested by Baier ---- //
 
     // Construct vector of distributions
     distributions.resize(aut.num_probabilistic_states());
-    std::size_t key = 0;
-    for (distribution_type& distribution : distributions)
+    for (distribution_key_type d = 0; d < distributions.size(); d++)
     {
-      distribution.key = key;
-      distribution.incoming_transitions_per_label.resize(aut.num_action_labels());
-      key++;
+      distributions[d].key = d;
     }
 
-    // Initialize the Steps bi-dimientional array
-    steps.resize(aut.num_states());
-    for (std::size_t i = 0; i < steps.size(); i++)
+    // Order the transitions on their source, and on their label, keeping the original order otherwise.
+    std::vector<std::size_t> transitions_by_source(transitions.size());
+    for (std::size_t i = 0; i < transitions.size(); i++)
     {
-      steps[i].resize(aut.num_action_labels());
+      transitions_by_source[i] = i;
     }
-
-    for (transition& t : transitions)
+    const std::vector<std::size_t> source_offsets = counting_sort(transitions_by_source, aut.num_states(),
+                                                       [&](std::size_t i) { return transitions[i].from(); });
+    std::vector<std::size_t> transitions_by_label(transitions_by_source);
+    const std::vector<std::size_t> label_offsets = counting_sort(transitions_by_label, num_labels,
+                                                       [&](std::size_t i) { return transitions[i].label(); });
+
+    // Store the incoming transitions of each distribution.
+    incoming_offsets.assign(distributions.size() + 1, 0);
+    for (const transition& t : transitions)
     {
-      steps[t.from()][t.label()].push_back(&distributions[t.to()]);
-      distributions[t.to()].incoming_transitions_per_label[t.label()].push_back(&t);
+      incoming_offsets[t.to() + 1]++;
     }
-
-    //---- Start the initialization process (page 207. Fig. 10. Baier) ---- //
-
-    // Initially there are as many step classes as lables
-    step_classes.resize(aut.num_action_labels());
-
-    for (step_class_type& sc : step_classes)
+    for (distribution_key_type d = 0; d < distributions.size(); d++)
     {
-      sc.prev_states.resize(aut.num_states());
+      incoming_offsets[d + 1] += incoming_offsets[d];
+    }
+    incoming_transitions.resize(transitions.size());
+    {
+      std::vector<std::size_t> position(incoming_offsets.begin(), incoming_offsets.end() - 1);
+      for (const std::size_t i : transitions_by_label)
+      {
+        const transition& t = transitions[i];
+        incoming_transitions[position[t.to()]++] = std::make_pair(t.label(), t.from());
+      }
     }
 
-    // create tree structure to group action states based on the outgoing transitions
-    std::size_t max_block_size = 0;
-    tree_type* max_block;
-    std::deque<tree_type> tree_nodes;
-    std::vector<tree_type*> leaves;
-    tree_type v0;
-    v0.init_node();
-    tree_nodes.push_back(v0);
-
-    // For all s in S do
+    // Store for each state the distributions in which it occurs.
+    distributions_with_state_offsets.assign(aut.num_states() + 1, 0);
+    for (distribution_key_type d = 0; d < distributions.size(); d++)
+    {
+      for (const typename LTS_TYPE::probabilistic_state_t::state_probability_pair& prob_pair : aut.probabilistic_state(d))
+      {
+        distributions_with_state_offsets[prob_pair.state() + 1]++;
+      }
+    }
     for (state_type s = 0; s < aut.num_states(); s++)
     {
-      // (1) Create pointer to root of the tree
-      tree_type* v = &tree_nodes[0];
-
-      // (2) Construct tree
-      for (std::size_t i = 0; i < aut.num_action_labels(); i++)
+      distributions_with_state_offsets[s + 1] += distributions_with_state_offsets[s];
+    }
+    distributions_with_state.resize(distributions_with_state_offsets.back());
+    {
+      std::vector<std::size_t> position(distributions_with_state_offsets.begin(), distributions_with_state_offsets.end() - 1);
+      for (distribution_key_type d = 0; d < distributions.size(); d++)
       {
-        step_classes[i].key = i;
-        step_classes[i].action = i;
-        if (steps[s][i].size() > 0)
-        {
-          for (distribution_type* d : steps[s][i])
-          {
-            if (distribution_per_step_class[i][d->key] == false)
-            {
-              step_classes[i].distributions.push_back(d);
-              distribution_per_step_class[i][d->key] = true;
-            }
-          }
-          
-          step_classes[i].prev_states[s] = true;
-
-          if (v->left == NULL)
-          {
-            // create left node
-            tree_type w;
-            w.init_node();
-            tree_nodes.push_back(w);
-            v->left = &tree_nodes.back();
-
-            // add new node to the leaf nodes if it is a leaf
-            if (i == aut.num_action_labels() - 1)
-            {
-              leaves.push_back(v->left);
-            }
-
-          }
-          v = v->left;
-        }
-        else
+        for (const typename LTS_TYPE::probabilistic_state_t::state_probability_pair& prob_pair : aut.probabilistic_state(d))
         {
-          if (v->right == NULL)
-          {
-            // create left node
-            tree_type w;
-            w.init_node();
-            tree_nodes.push_back(w);
-            v->right = &tree_nodes.back();
-
-            // add new node to the leaf nodes if it is a leaf
-            if (i == aut.num_action_labels() - 1)
-            {
-              leaves.push_back(v->right);
-            }
-          }
-          v = v->right;
+          distributions_with_state[position[prob_pair.state()]++] = d;
         }
       }
+    }
 
-      // (3) Add the state to the leaf and increment its state counter
-      v->states.push_back(s);
-      v->count++;
+    //---- Start the initialization process (page 207. Fig. 10. Baier) ---- //
 
-      // (4) Keep track of the leave containing more states
-      if (v->count > max_block_size)
+    // Initially there are as many step classes as labels. The distributions of a step class
+    // are ordered on the source state of the first transition that reaches them.
+    step_classes.resize(num_labels);
+    std::vector<label_type> last_label(distributions.size(), num_labels);
+    for (label_type a = 0; a < num_labels; a++)
+    {
+      step_class_type& sc = step_classes[a];
+      sc.key = a;
+      sc.action = a;
+      for (std::size_t i = label_offsets[a]; i < label_offsets[a + 1]; i++)
       {
-        max_block = v;
-        max_block_size = v->count;
+        distribution_type& d = distributions[transitions[transitions_by_label[i]].to()];
+        if (last_label[d.key] != a)
+        {
+          last_label[d.key] = a;
+          d.step_classes.emplace_back(a, sc.distributions.size());
+          sc.distributions.push_back(&d);
+        }
       }
     }
 
-    // insert all states of the leaves to blocks
-    blocks.resize(leaves.size());
-
-    key = 0;
-    std::size_t larger_key = 0;
-    for (tree_type* leaf_ptr : leaves)
+    // Group the states on the set of actions that they can perform, numbering the blocks
+    // in the order in which they are encountered. Instead of the binary tree of Baier, the
+    // blocks are found by hashing the sorted vector of actions.
+    std::unordered_map<std::vector<label_type>, block_key_type> block_of_actions;
+    std::vector<label_type> actions;
+    std::size_t max_block_size = 0;
+    block_key_type larger_key = 0;
+    block_index_of_a_state.resize(aut.num_states());
+    for (state_type s = 0; s < aut.num_states(); s++)
     {
-      block_type& block = blocks[key];
-      block.key = key;
-      block.states.splice(block.states.end(), leaf_ptr->states);
+      actions.clear();
+      for (std::size_t i = source_offsets[s]; i < source_offsets[s + 1]; i++)
+      {
+        actions.push_back(transitions[transitions_by_source[i]].label());
+      }
+      std::sort(actions.begin(), actions.end());
+      actions.erase(std::unique(actions.begin(), actions.end()), actions.end());
 
-      if (leaf_ptr == max_block)
+      std::pair<typename std::unordered_map<std::vector<label_type>, block_key_type>::iterator, bool> p =
+                                                                   block_of_actions.emplace(actions, blocks.size());
+      if (p.second)
       {
-        larger_key = key;
+        blocks.emplace_back();
+        blocks.back().key = p.first->second;
       }
+      block_type& b = blocks[p.first->second];
+      b.states.push_back(s);
+      block_index_of_a_state[s] = b.key;
 
-      key++;
+      // Keep track of the block containing more states
+      if (b.states.size() > max_block_size)
+      {
+        larger_key = b.key;
+        max_block_size = b.states.size();
+      }
     }
 
     // Add all blocks to the state partition.
@@ -360,12 +381,14 @@ class prob_bisim_partitioner_bem
         // Push the non-larger blocks to the front of the list. This are the so called new blocks
         b.is_in_new_blocks = true;
         state_partition.push_front(&b);
+        b.position = state_partition.begin();
       }
       else
       {
         // push the larger block to the end of the list
         b.is_in_new_blocks = false;
         state_partition.push_back(&b);
+        b.position = std::prev(state_partition.end());
       }
     }
     
@@ -376,19 +399,12 @@ class prob_bisim_partitioner_bem
       if (sc.distributions.size() > 0)
       { 
         step_partition.push_front(&sc);
+        sc.position = step_partition.begin();
         sc.is_in_new_step_classes = true;
       }
     }
 
-    block_index_of_a_state.resize(aut.num_states());
-    for (const block_type& b : blocks)
-    {
-      for (const state_type s : b.states)
-      {
-        block_index_of_a_state[s] = b.key;
-      }
-    }
-
+    marked_states.assign(aut.num_states(), false);
   }
 
   /** \brief Calculates the probability to reach block b from distribution d.
@@ -413,34 +429,30 @@ class prob_bisim_partitioner_bem
     return prob_to_block;
   }
 
-  typename LTS_TYPE::probabilistic_state_t calculate_new_probabilistic_state(typename LTS_TYPE::probabilistic_state_t ps)
+  typename LTS_TYPE::probabilistic_state_t calculate_new_probabilistic_state(const typename LTS_TYPE::probabilistic_state_t& ps)
   {
     typename LTS_TYPE::probabilistic_state_t new_prob_state;
-    static std::map<state_type, probability_fraction_type> prob_state_map;
-    prob_state_map.clear();
+    std::vector<std::pair<state_type, probability_fraction_type> > prob_state_vector;
 
-    /* Iterate over all state probability pairs in the selected probabilistic state*/
+    /* Collect the equivalence classes of the states in the selected probabilistic state */
     for (const typename LTS_TYPE::probabilistic_state_t::state_probability_pair& sp_pair : ps)
     {
-      /* Check the resulting action state in the final State partition */
-      state_type new_state = get_eq_class(sp_pair.state());
-
-      if (prob_state_map.count(new_state) == 0)
-      {
-        /* The state is not yet in the mapping. Add the state with its probability*/
-        prob_state_map[new_state] = sp_pair.probability();
-      }
-      else
-      {
-        /* The state is already in the mapping. Sum up probabilities */
-        prob_state_map[new_state] = prob_state_map[new_state] + sp_pair.probability();
-      }
+      prob_state_vector.emplace_back(get_eq_class(sp_pair.state()), sp_pair.probability());
     }
+    std::sort(prob_state_vector.begin(), prob_state_vector.end(),
+              [](const std::pair<state_type, probability_fraction_type>& p1,
+                 const std::pair<state_type, probability_fraction_type>& p2) { return p1.first < p2.first; });
 
-    /* Add all the state probabilities pairs in the mapping to its actual data type*/
-    for (const std::pair<state_type, probability_fraction_type>& i : prob_state_map)
+    /* Add the states with the sum of their probabilities to the new probabilistic state */
+    for (std::size_t i = 0; i < prob_state_vector.size(); )
     {
-      new_prob_state.add(i.first, i.second);
+      const state_type new_state = prob_state_vector[i].first;
+      probability_fraction_type probability = prob_state_vector[i].second;
+      for (i++; i < prob_state_vector.size() && prob_state_vector[i].first == new_state; i++)
+      {
+        probability = probability + prob_state_vector[i].second;
+      }
+      new_prob_state.add(new_state, probability);
     }
 
     return new_prob_state;
@@ -448,27 +460,101 @@ class prob_bisim_partitioner_bem
 
   typename LTS_TYPE::probabilistic_state_t calculate_equivalent_probabilistic_state(step_class_type& sc)
   {
-    typename LTS_TYPE::probabilistic_state_t equivalent_prob_state;
-
     /* Select the first probabilistic state of the step class */
     distribution_type* d = sc.distributions.front();
+    return calculate_new_probabilistic_state(aut.probabilistic_state(d->key));
+  }
 
-    typename LTS_TYPE::probabilistic_state_t old_prob_state = aut.probabilistic_state(d->key);
+  /** \brief Removes distribution d from the distributions of step class sc, by moving
+   *         the last distribution of sc to its position. */
+  void remove_from_step_class(distribution_type& d, step_class_type& sc)
+  {
+    const std::size_t position = position_in_step_class(d, sc.key);
+    distribution_type* last = sc.distributions.back();
+    sc.distributions[position] = last;
+    position_in_step_class(*last, sc.key) = position;
+    sc.distributions.pop_back();
+  }
 
-    equivalent_prob_state = calculate_new_probabilistic_state(old_prob_state);
+  /** \brief Adds distribution d, that was in step class old_key, to step class sc. */
+  void move_to_step_class(distribution_type& d, const step_class_key_type old_key, step_class_type& sc)
+  {
+    for (std::pair<step_class_key_type, std::size_t>& p : d.step_classes)
+    {
+      if (p.first == old_key)
+      {
+        p = std::make_pair(sc.key, sc.distributions.size());
+        sc.distributions.push_back(&d);
+        return;
+      }
+    }
+    assert(false);
+  }
 
-    return equivalent_prob_state;
+  std::size_t& position_in_step_class(distribution_type& d, const step_class_key_type sc_key)
+  {
+    for (std::pair<step_class_key_type, std::size_t>& p : d.step_classes)
+    {
+      if (p.first == sc_key)
+      {
+        return p.second;
+      }
+    }
+    assert(false);
+    return d.step_classes.front().second;
+  }
+
+  /** \brief Marks the states that have an a-transition to some distribution in the step class <a,M>,
+  *          and counts the marked states per block. */
+  void mark_states_that_reach(const step_class_type& sc)
+  {
+    marked_states_per_block.resize(blocks.size(), 0);
+    const std::pair<label_type, state_type> lowest(sc.action, 0);
+    for (const distribution_type* d : sc.distributions)
+    {
+      const typename std::vector<std::pair<label_type, state_type> >::const_iterator end =
+                                                            incoming_transitions.cbegin() + incoming_offsets[d->key + 1];
+      for (typename std::vector<std::pair<label_type, state_type> >::const_iterator i =
+             std::lower_bound(incoming_transitions.cbegin() + incoming_offsets[d->key], end, lowest);
+           i != end && i->first == sc.action; ++i)
+      {
+        const state_type s = i->second;
+        if (!marked_states[s])
+        {
+          marked_states[s] = true;
+          marked_state_list.push_back(s);
+          const block_key_type b = block_index_of_a_state[s];
+          if (marked_states_per_block[b]++ == 0)
+          {
+            blocks_with_marked_states.push_back(b);
+          }
+        }
+      }
+    }
+  }
+
+  void unmark_states()
+  {
+    for (const state_type s : marked_state_list)
+    {
+      marked_states[s] = false;
+    }
+    marked_state_list.clear();
+    for (const block_key_type b : blocks_with_marked_states)
+    {
+      marked_states_per_block[b] = 0;
+    }
+    blocks_with_marked_states.clear();
   }
 
   /** \brief  Two-phased partitioning algorithm described in page 204. Fig 9. Baier.
   *   \detail Refinement of state partition and step partition until no new blocks/step classes
-  *           are in front of the partition lists
+  *           are in front of the partition lists. Instead of traversing the whole partitions,
+  *           only the distributions that can reach the splitter block, and the blocks with a state
+  *           that can reach the splitter step class are visited, as the others are not split.
   */
   void refine_partition_until_it_becomes_stable (void) 
   {
-    std::list<step_class_type*> step_partition_old;
-    std::list<block_type*> state_partition_old;
-
     // Repeat until no new blocks in front of the partition lists
     while (state_partition.front()->is_in_new_blocks == true || step_partition.front()->is_in_new_step_classes == true)
     { 
@@ -477,114 +563,121 @@ class prob_bisim_partitioner_bem
       {
         // Choose a new block in front of the state partition and change it to the back of the list
         block_type* c_block = state_partition.front();
-        state_partition.pop_front();
-        state_partition.push_back(c_block);
+        state_partition.splice(state_partition.end(), state_partition, state_partition.begin());
         c_block->is_in_new_blocks = false;
 
-        // swap elements of step_partition (M) to step_partition_old (M_old)
-        step_partition_old.swap(step_partition);
-
-        // vector to add the new step classes
-        static std::vector<typename std::list<step_class_type*>::iterator> pending_new_step_classes;
-        pending_new_step_classes.clear();
-
-        // iterate over all step classes
-        for (typename std::list<step_class_type*>::iterator sc_iter = step_partition_old.begin(); 
-          sc_iter != step_partition_old.end(); ++sc_iter)
+        // Compute the probability to reach c_block of the distributions that can reach it. All
+        // other distributions have probability zero, and stay in their step classes.
+        distributions_reaching_splitter.clear();
+        for (const state_type s : c_block->states)
         {
-          step_class_type* sc_ptr = *sc_iter;
-
-          // Mapping to sort the distributions based on its probability to reach a block, instead of using
-          // an ordered balanced tree as suggsted in Baier
-          static std::map< probability_fraction_type, std::list<distribution_type*> > distributions_ordered_by_prob;
-          distributions_ordered_by_prob.clear();
+          for (std::size_t i = distributions_with_state_offsets[s]; i < distributions_with_state_offsets[s + 1]; i++)
+          {
+            distribution_type& d = distributions[distributions_with_state[i]];
+            if (!d.reaches_splitter)
+            {
+              d.reaches_splitter = true;
+              distributions_reaching_splitter.emplace_back(probability_to_block(d, *c_block), &d);
+            }
+          }
+        }
 
-          // Iterate over all distributions d of the step class and add probability to block to vector
-          for (distribution_type* d : sc_ptr->distributions)
+        // Group these distributions per step class on their probability, instead of using an
+        // ordered balanced tree as suggested in Baier.
+        split_entries.clear();
+        for (std::size_t j = 0; j < distributions_reaching_splitter.size(); j++)
+        {
+          distribution_type* d = distributions_reaching_splitter[j].second;
+          d->reaches_splitter = false;
+          if (!(distributions_reaching_splitter[j].first == probability_fraction_type::zero()))
+          {
+            for (const std::pair<step_class_key_type, std::size_t>& p : d->step_classes)
+            {
+              split_entries.emplace_back(p.first, j);
+            }
+          }
+        }
+        std::sort(split_entries.begin(), split_entries.end(),
+                  [this](const std::pair<step_class_key_type, std::size_t>& e1, const std::pair<step_class_key_type, std::size_t>& e2)
+                  {
+                    if (e1.first != e2.first)
+                    {
+                      return e1.first < e2.first;
+                    }
+                    const probability_fraction_type& p1 = distributions_reaching_splitter[e1.second].first;
+                    const probability_fraction_type& p2 = distributions_reaching_splitter[e2.second].first;
+                    if (p1 < p2 || p2 < p1)
+                    {
+                      return p1 < p2;
+                    }
+                    return e1.second < e2.second;
+                  });
+
+        for (std::size_t i = 0; i < split_entries.size(); )
+        {
+          const step_class_key_type sc_key = split_entries[i].first;
+          step_class_type* sc_ptr = &step_classes[sc_key];
+
+          // Count the groups with the same positive probability, and check whether there are
+          // distributions with probability zero in this step class.
+          std::size_t end = i;
+          std::size_t number_of_probabilities = 0;
+          for (; end < split_entries.size() && split_entries[end].first == sc_key; end++)
           {
-            probability_fraction_type probability = probability_to_block(*d, *c_block);
-            distributions_ordered_by_prob[probability].push_back(d);
+            if (end == i || distributions_reaching_splitter[split_entries[end - 1].second].first <
+                            distributions_reaching_splitter[split_entries[end].second].first)
+            {
+              number_of_probabilities++;
+            }
           }
+          const bool has_zero_probabilities = end - i < sc_ptr->distributions.size();
 
-          // if there are multiple elements in the distributions_ordered_by_prob then we have to 
-          // add them to the step partition as a new step class
-          if (distributions_ordered_by_prob.size() >= 2)
+          // if there are multiple probabilities then we have to split the step class. The distributions
+          // with probability zero remain in the current step class, or if there are none, the distributions
+          // with the smallest probability. The other groups become new step classes.
+          if (number_of_probabilities + (has_zero_probabilities ? 1 : 0) >= 2)
           {
-            step_class_type* new_step_class_ptr;
+            // add to the front of the step partition (as a new step class) if not yet there
+            if (sc_ptr->is_in_new_step_classes == false)
+            {
+              step_partition.splice(step_partition.begin(), step_partition, sc_ptr->position);
+              sc_ptr->is_in_new_step_classes = true;
+            }
 
-            step_classes.resize(step_classes.size() + distributions_ordered_by_prob.size() - 1);
-            // iterate over mapping
-            std::size_t new_class_count = 0;
-            for (std::pair< probability_fraction_type, std::list<distribution_type*> > ordered_dist : distributions_ordered_by_prob)
+            for (std::size_t j = i; j < end; j++)
             {
-              std::list<distribution_type*>& distribution_list = ordered_dist.second;
-              
-              if (new_class_count == 0)
-              {
-                // if it is the first element of the mapping then we do not create a new step class; instead, we 
-                // add its elements into the current step class that is being split.
-                sc_ptr->distributions.swap(distribution_list);
-
-                // clear the prev states of the current step class
-                for (std::size_t i = 0; i < sc_ptr->prev_states.size(); i++)
-                {
-                  sc_ptr->prev_states[i] = false;
-                }
-
-                // recalculate prev states based on incoming transitions of each distribution
-                for (distribution_type* d : sc_ptr->distributions)
-                {
-                  for (transition* t_ptr : d->incoming_transitions_per_label[sc_ptr->action])
-                  {
-                    sc_ptr->prev_states[t_ptr->from()] = true;
-                  }
-                }
-
-                // add to the front of the step partition (as a new step class) if not yet added 
-                if (sc_ptr->is_in_new_step_classes == false)
-                {
-                  // since we are iterating over this step class, we save its iterator in a pending vector,
-                  // so later we can add it to the front of the step partition (outside the loop)
-                  pending_new_step_classes.push_back(sc_iter);
-                  sc_ptr->is_in_new_step_classes = true;
-                }
-              }
-              else
+              remove_from_step_class(*distributions_reaching_splitter[split_entries[j].second].second, *sc_ptr);
+            }
+
+            bool first_group = !has_zero_probabilities;
+            for (std::size_t j = i; j < end; )
+            {
+              step_class_type* target_step_class_ptr = sc_ptr;
+              if (!first_group)
               {
-                new_step_class_ptr = &step_classes[step_classes.size() - new_class_count];
+                step_classes.emplace_back();
+                target_step_class_ptr = &step_classes.back();
 
                 //init new step class
-                new_step_class_ptr->key = step_classes.size() - new_class_count;
-                new_step_class_ptr->action = sc_ptr->action;
-                new_step_class_ptr->is_in_new_step_classes = true;
-                new_step_class_ptr->prev_states.resize(aut.num_states());
-                new_step_class_ptr->distributions.swap(distribution_list);
-
-                // recalculate prev states based ont incoming transitions of each distribution
-                for (distribution_type* d : new_step_class_ptr->distributions)
-                {
-                  for (transition* t_ptr : d->incoming_transitions_per_label[new_step_class_ptr->action])
-                  {
-                    new_step_class_ptr->prev_states[t_ptr->from()] = true;
-                  }
-                }
+                target_step_class_ptr->key = step_classes.size() - 1;
+                target_step_class_ptr->action = sc_ptr->action;
+                target_step_class_ptr->is_in_new_step_classes = true;
 
-                // add new step class to step partition and new_step_classes
-                step_partition.push_front(new_step_class_ptr);
+                // add new step class to the front of the step partition
+                step_partition.push_front(target_step_class_ptr);
+                target_step_class_ptr->position = step_partition.begin();
+              }
+              first_group = false;
+
+              const probability_fraction_type& probability = distributions_reaching_splitter[split_entries[j].second].first;
+              for (; j < end && distributions_reaching_splitter[split_entries[j].second].first == probability; j++)
+              {
+                move_to_step_class(*distributions_reaching_splitter[split_entries[j].second].second, sc_key, *target_step_class_ptr);
               }
-              new_class_count++;
             }
           }
+          i = end;
         }
-
-        // Add the pending new blocks to the front of the list
-        for (typename std::list<step_class_type*>::iterator sc_iter : pending_new_step_classes)
-        {
-          step_partition.splice(step_partition.begin(), step_partition_old, sc_iter);
-        }
-
-        // move remaining step classes to the end of step partition
-        step_partition.splice(step_partition.end(), step_partition_old);
       }
 
       // Phase 2: Refinment of state_partition via Refine(X,a,M)
@@ -592,107 +685,67 @@ class prob_bisim_partitioner_bem
       {
         // Choose some step class <a,M> in new_step_classes and remove it from new_step_classes
         step_class_type* step_class = step_partition.front();
-        step_partition.pop_front();
+        step_partition.splice(step_partition.end(), step_partition, step_partition.begin());
         step_class->is_in_new_step_classes = false;
-        step_partition.push_back(step_class);
-
-        // swap elements of state_partition (X) to state_partition_old (X_old)
-        state_partition_old.swap(state_partition);
-
-        static std::vector<typename std::list<block_type*>::iterator > blocks_to_move_to_front;
-        static std::vector<block_type*> new_blocks_to_move_to_front;
-        blocks_to_move_to_front.clear();
-        new_blocks_to_move_to_front.clear();
-        // for all blocks B in X_old
-        //for (block_type* b_to_split : state_partition_old)
-        for (typename std::list<block_type*>::iterator block_iter = state_partition_old.begin(); 
-          block_iter != state_partition_old.end(); ++block_iter)
+
+        // Mark the states that can reach step class <a,M>. Only the blocks with both marked
+        // and unmarked states are split.
+        mark_states_that_reach(*step_class);
+
+        for (const block_key_type b : blocks_with_marked_states)
         {
-          block_type* b_to_split = *block_iter;
-          block_type new_block;
-          new_block.is_in_new_blocks = false;
-          block_type temp_block;
-          block_type* new_block_ptr;
-          new_block.key = blocks.size();
-
-          // iterate over all states in the block to split
-          for (state_type s : b_to_split->states)
+          block_type* b_to_split = &blocks[b];
+          const std::size_t number_of_marked_states = marked_states_per_block[b];
+          if (number_of_marked_states == b_to_split->states.size())
           {
-            // if block b can reach step class <a,M> starting from state s then we move it to antoher block
-            if (step_class->prev_states[s] == true)
-            {
-              new_block.states.push_back(s);
-            }
-            else
-            {
-              temp_block.states.push_back(s);
-            }
+            continue;
           }
 
-          // if both, the new block and temp block has elements, then we add a new block into the state partition
-          if (new_block.states.size() > 0 && temp_block.states.size() > 0)
-          {
-
-            // First update the block_index_of_a_state by iterating over all states of the new block
-            for (state_type s : new_block.states)
-            {
-              block_index_of_a_state[s] = new_block.key;
-            }
-
-            blocks.push_back(new_block);
-            new_block_ptr = &blocks.back();
+          blocks.emplace_back();
+          block_type* new_block_ptr = &blocks.back();
+          new_block_ptr->key = blocks.size() - 1;
+          new_block_ptr->states.reserve(number_of_marked_states);
 
-            // return states from temp_block to b_to_split
-            b_to_split->states.swap(temp_block.states);
-            
-            // if the current block is not currently a new block then add the smaller
-            // block (between new block and current block) to the list of new blocks; 
-            // hence, in front of state partition
-            if (b_to_split->is_in_new_blocks == false)
+          // Move the marked states, that can reach step class <a,M>, to the new block, and keep
+          // the other states in b_to_split in their original order.
+          std::size_t number_of_remaining_states = 0;
+          for (std::size_t i = 0; i < b_to_split->states.size(); i++)
+          {
+            const state_type s = b_to_split->states[i];
+            if (marked_states[s])
             {
-              if (new_block_ptr->states.size() < b_to_split->states.size())
-              {
-                new_blocks_to_move_to_front.push_back(new_block_ptr);
-                new_block_ptr->is_in_new_blocks = true;
-              }
-              else
-              {
-                b_to_split->is_in_new_blocks = true;
-                blocks_to_move_to_front.push_back(block_iter);
-
-                // add new block to the back of the state_partition list
-                state_partition.push_back(new_block_ptr);
-              }
+              new_block_ptr->states.push_back(s);
+              block_index_of_a_state[s] = new_block_ptr->key;
             }
             else
             {
-              // the current block is already in new blocks; hence, just add the new block
-              // to the front of the partition as well.
-
-              //new_blocks.push_back(new_block_ptr);
-              new_block_ptr->is_in_new_blocks = true;
-
-              // add new block to the back of the state_partition list
-              new_blocks_to_move_to_front.push_back(new_block_ptr);
+              b_to_split->states[number_of_remaining_states++] = s;
             }
           }
-        }
-
-        // move the remaning blocks to the end of state_partition
-        state_partition.splice(state_partition.begin(), state_partition_old);
-
-        // move the blocks that should be in new blocks to the begining of the list
-        for (typename std::list<block_type*>::iterator block_iter : blocks_to_move_to_front)
-        {
-          state_partition.splice(state_partition.begin(), state_partition, block_iter);
-        }
+          b_to_split->states.resize(number_of_remaining_states);
+          
+          // if the current block is not currently a new block then add the smaller
+          // block (between new block and current block) to the list of new blocks; 
+          // hence, in front of state partition
+          if (b_to_split->is_in_new_blocks == false && new_block_ptr->states.size() >= b_to_split->states.size())
+          {
+            b_to_split->is_in_new_blocks = true;
+            state_partition.splice(state_partition.begin(), state_partition, b_to_split->position);
 
-        // move the blocks that are new to the front of state_partition
-        for (block_type* block_ptr : new_blocks_to_move_to_front)
-        {
-          state_partition.push_front(block_ptr);
+            // add new block to the back of the state_partition list
+            state_partition.push_back(new_block_ptr);
+            new_block_ptr->position = std::prev(state_partition.end());
+          }
+          else
+          {
+            // the new block is smaller, or the current block is already in new blocks; 
+            // hence, add the new block to the front of the partition.
+            new_block_ptr->is_in_new_blocks = true;
+            state_partition.push_front(new_block_ptr);
+            new_block_ptr->position = state_partition.begin();
+          }
         }
-
+        unmark_states();
       }
     }
   }
@@ -10,6 +10,7 @@
 
 #ifndef _LIBLTS_PBISIM_GRV_H
 #define _LIBLTS_PBISIM_GRV_H
+#include <algorithm>
 #include <cassert>
 #include <vector>
 #include <deque>
@@ -78,21 +79,25 @@ class prob_bisim_partitioner_grv  // Called after Groote, Rivera Verduzco and de
     * \pre The bisimulation equivalence classes have been computed. */
     void replace_transitions()
     {
-      std::set<transition> resulting_transitions;
+      std::vector<transition> resulting_transitions;
 
       const std::vector<transition>& trans = aut.get_transitions();
+      resulting_transitions.reserve(trans.size());
       for (const transition& t : trans)
       {
-        resulting_transitions.insert(
-          transition(
+        resulting_transitions.emplace_back(
             get_eq_class(t.from()),
             t.label(),
-            get_eq_probabilistic_class(t.to())));
+            get_eq_probabilistic_class(t.to()));
       }
+      std::sort(resulting_transitions.begin(), resulting_transitions.end());
+      resulting_transitions.erase(std::unique(resulting_transitions.begin(), resulting_transitions.end()),
+                                  resulting_transitions.end());
+
       // Remove the old transitions
       aut.clear_transitions();
 
-      // Copy the transitions from the set into the transition system.
+      // Copy the transitions from the vector into the transition system.
       for (const transition& t : resulting_transitions)
       {
         aut.add_transition(t);
@@ -1250,33 +1255,30 @@ class prob_bisim_partitioner_grv  // Called after Groote, Rivera Verduzco and de
       return Bc;
     }
 
-    typename LTS_TYPE::probabilistic_state_t calculate_new_probabilistic_state(typename LTS_TYPE::probabilistic_state_t ps)
+    typename LTS_TYPE::probabilistic_state_t calculate_new_probabilistic_state(const typename LTS_TYPE::probabilistic_state_t& ps)
     {
       typename LTS_TYPE::probabilistic_state_t new_prob_state;
-      std::map <state_key_type, probability_fraction_type> prob_state_map;
+      std::vector<std::pair<state_key_type, probability_fraction_type> > prob_state_vector;
 
-      /* Iterate over all state probability pairs in the selected probabilistic state*/
+      /* Collect the equivalence classes of the states in the selected probabilistic state */
       for (const typename LTS_TYPE::probabilistic_state_t::state_probability_pair& sp_pair : ps)
       {
-        /* Check the resulting action state in the final State partition */
-        state_key_type new_state = get_eq_class(sp_pair.state());
-
-        if (prob_state_map.count(new_state) == 0)
-        {
-          /* The state is not yet in the mapping. Add the state with its probability*/
-          prob_state_map[new_state] = sp_pair.probability();
-        }
-        else
-        {
-          /* The state is already in the mapping. Sum up probabilities */
-          prob_state_map[new_state] = prob_state_map[new_state] + sp_pair.probability();
-        }
+        prob_state_vector.emplace_back(get_eq_class(sp_pair.state()), sp_pair.probability());
       }
+      std::sort(prob_state_vector.begin(), prob_state_vector.end(),
+                [](const std::pair<state_key_type, probability_fraction_type>& p1,
+                   const std::pair<state_key_type, probability_fraction_type>& p2) { return p1.first < p2.first; });
 
-      /* Add all the state probabilities pairs in the mapping to its actual data type*/
-      for (typename std::map<state_key_type, probability_fraction_type>::iterator i = prob_state_map.begin(); i != prob_state_map.end(); i++)
+      /* Add the states with the sum of their probabilities to the new probabilistic state */
+      for (std::size_t i = 0; i < prob_state_vector.size(); )
       {
-        new_prob_state.add(i->first, i->second);
+        const state_key_type new_state = prob_state_vector[i].first;
+        probability_fraction_type probability = prob_state_vector[i].second;
+        for (i++; i < prob_state_vector.size() && prob_state_vector[i].first == new_state; i++)
+        {
+          probability = probability + prob_state_vector[i].second;
+        }
+        new_prob_state.add(new_state, probability);
       }
 
       return new_prob_state;
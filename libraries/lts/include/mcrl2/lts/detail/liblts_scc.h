@@ -11,9 +11,9 @@
 #ifndef _LIBLTS_SCC_H
 #define _LIBLTS_SCC_H
 #include <vector>
-#include <map>
 #include <unordered_set>
 #include "mcrl2/lts/lts.h"
+#include "mcrl2/lts/detail/scc_decomposition.h"
 #include "mcrl2/utilities/logger.h"
 
 namespace mcrl2
@@ -33,17 +33,18 @@ class scc_partitioner
     /** \brief Creates an scc partitioner for an LTS.
      *  \details This scc partitioner calculates a partition
      *  of the state space of the transition system l using
-     *  a straightforward algorithm found in A.V. Aho, J.E. Hopcroft
-     *  and J.D. Ullman, Data structures and algorithms. Addison Wesley,
-     *  1987 on page 224. All states that reside on a loop of internal
+     *  the strongly connected components of its tau transitions, see
+     *  \ref scc_decomposition. All states that reside on a loop of internal
      *  actions are put in the same equivalence class. The function l.is_tau
      *  is used to determine whether an action is internal. Partitioning is
      *  done immediately when an instance of this class is created.
      *  When applying the function \ref replace_transition_system the
      *  automaton l is replaced by (aka shrinked to) the automaton modulo the
-     *  calculated partition.
-     *  \param[in] l reference to an LTS. */
-    scc_partitioner(LTS_TYPE& l);
+     *  calculated partition. The equivalence classes are numbered in the order
+     *  of their smallest state.
+     *  \param[in] l reference to an LTS.
+     *  \param[in] number_of_threads The number of threads used for computing the components. */
+    scc_partitioner(LTS_TYPE& l, std::size_t number_of_threads = 1);
 
     /** \brief Destroys this partitioner. */
     ~scc_partitioner()=default;
@@ -95,68 +96,23 @@ class scc_partitioner
     LTS_TYPE& aut;
 
     std::vector < state_type > block_index_of_a_state;
-    std::vector < state_type > dfsn2state;
     state_type equivalence_class_index;
-
-    void group_components(const state_type t,
-                          const state_type equivalence_class_index,
-                          const std::map < state_type, std::vector < state_type > >& tgt_src,
-                          std::vector < bool >& visited);
-    void dfs_numbering(const state_type t,
-                       const std::map < state_type, std::vector < state_type > >& src_tgt,
-                       std::vector < bool >& visited);
-
 };
 
 
 template < class LTS_TYPE>
-scc_partitioner<LTS_TYPE>::scc_partitioner(LTS_TYPE& l)
+scc_partitioner<LTS_TYPE>::scc_partitioner(LTS_TYPE& l, std::size_t number_of_threads)
   :aut(l)
 {
   mCRL2log(log::debug) << "Tau loop (SCC) partitioner created for " << l.num_states() << " states and " <<
               l.num_transitions() << " transitions" << std::endl;
 
-  // read and store tau transitions.
-  std::map < state_type, std::vector < state_type > > src_tgt;
-  for (const transition& t: aut.get_transitions())
-  {
-    if (aut.is_tau(l.apply_hidden_label_map(t.label())))
-    {
-      src_tgt[t.from()].push_back(t.to());
-    }
-  }
-  // Initialise the data structures
-  std::vector<bool> visited(aut.num_states(),false);
+  const csr_graph g = tau_graph(aut);
+  const scc_decomposition sccs(g, number_of_threads);
+  block_index_of_a_state = sccs.components();
+  equivalence_class_index = sccs.num_components();
 
-  // Number the states via a depth first search
-  for (state_type i=0; i<aut.num_states(); ++i)
-  {
-    dfs_numbering(i,src_tgt,visited);
-  }
-  src_tgt.clear();
-
-  std::map < state_type, std::vector < state_type > > tgt_src;
-  for (const transition& t: aut.get_transitions())
-  {
-    if (aut.is_tau(l.apply_hidden_label_map(t.label())))
-    {
-      tgt_src[t.to()].push_back(t.from());
-    }
-  }
-  equivalence_class_index=0;
-  block_index_of_a_state=std::vector < state_type >(aut.num_states(),0);
-  for (std::vector < state_type >::reverse_iterator i=dfsn2state.rbegin();
-       i!=dfsn2state.rend(); ++i)
-  {
-    if (visited[*i])  // Visited is used inversely here.
-    {
-      group_components(*i,equivalence_class_index,tgt_src,visited);
-      equivalence_class_index++;
-    }
-  }
   mCRL2log(log::debug) << "Tau loop (SCC) partitioner reduces lts to " << equivalence_class_index << " states." << std::endl;
-
-  dfsn2state.clear();
 }
 
 
@@ -231,63 +187,12 @@ bool scc_partitioner<LTS_TYPE>::in_same_class(const std::size_t s, const std::si
   return get_eq_class(s)==get_eq_class(t);
 }
 
-// Private methods of scc_partitioner
-
-template < class LTS_TYPE>
-void scc_partitioner<LTS_TYPE>::group_components(
-  const state_type t,
-  const state_type equivalence_class_index,
-  const std::map < state_type, std::vector < state_type > >& tgt_src,
-  std::vector < bool >& visited)
-{
-  if (!visited[t])
-  {
-    return;
-  }
-  {
-    visited[t] = false;
-    if (tgt_src.count(t)>0)
-    {
-      const std::vector < state_type >& sources = tgt_src.find(t)->second;
-      for (std::vector < state_type >::const_iterator i=sources.begin();
-           i!=sources.end(); ++i)
-      {
-        group_components(*i,equivalence_class_index,tgt_src,visited);
-      }
-    }
-    block_index_of_a_state[t]=equivalence_class_index;
-  }
-}
-
-template < class LTS_TYPE>
-void scc_partitioner<LTS_TYPE>::dfs_numbering(
-  const state_type t,
-  const std::map < state_type, std::vector < state_type > >& src_tgt,
-  std::vector < bool >& visited)
-{
-  if (visited[t])
-  {
-    return;
-  }
-  visited[t] = true;
-  if (src_tgt.count(t)>0)
-  {
-    const std::vector < state_type >& targets = src_tgt.find(t)->second;
-    for (std::vector < state_type >::const_iterator i=targets.begin();
-         i!=targets.end() ; ++i)
-    {
-      dfs_numbering(*i,src_tgt,visited);
-    }
-  }
-  dfsn2state.push_back(t);
-}
-
 } // namespace detail
 
 template < class LTS_TYPE>
-void scc_reduce(LTS_TYPE& l,const bool preserve_divergence_loops = false)
+void scc_reduce(LTS_TYPE& l,const bool preserve_divergence_loops = false, std::size_t number_of_threads = 1)
 {
-  detail::scc_partitioner<LTS_TYPE> scc_part(l);
+  detail::scc_partitioner<LTS_TYPE> scc_part(l, number_of_threads);
   scc_part.replace_transition_system(preserve_divergence_loops);
 }
 
@@ -0,0 +1,384 @@
+// Author(s): Wieger Wesselink
+// Copyright: see the accompanying file COPYING or copy at
+// https://github.com/mCRL2org/mCRL2/blob/master/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file mcrl2/lts/detail/liblts_sim_bit_matrix.h
+/// \brief Computation of the (ready) simulation preorder, in which the relation is stored as a
+///        matrix of bits that is updated a word at a time.
+
+#ifndef MCRL2_LTS_DETAIL_LIBLTS_SIM_BIT_MATRIX_H
+#define MCRL2_LTS_DETAIL_LIBLTS_SIM_BIT_MATRIX_H
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <map>
+#include <tuple>
+#include <vector>
+#include "mcrl2/lts/detail/liblts_bisim_parallel.h"
+#include "mcrl2/utilities/logger.h"
+
+namespace mcrl2
+{
+namespace lts
+{
+namespace detail
+{
+
+/// \brief A square matrix of bits. Each row is stored as a sequence of 64 bit words, such that
+/// operations on rows can be done a word at a time.
+class bit_matrix
+{
+  public:
+    typedef std::uint64_t word;
+
+  protected:
+    std::size_t m_size;
+    std::size_t m_words_per_row;
+    std::vector<word> m_words;
+
+  public:
+    explicit bit_matrix(std::size_t n = 0)
+      : m_size(n),
+        m_words_per_row((n + 63) / 64),
+        m_words(n * m_words_per_row, 0)
+    {}
+
+    /// \brief Returns the number of rows, which is also the number of columns.
+    std::size_t size() const
+    {
+      return m_size;
+    }
+
+    /// \brief Returns the number of words of a row.
+    std::size_t words_per_row() const
+    {
+      return m_words_per_row;
+    }
+
+    word* row(std::size_t i)
+    {
+      return m_words.data() + i * m_words_per_row;
+    }
+
+    const word* row(std::size_t i) const
+    {
+      return m_words.data() + i * m_words_per_row;
+    }
+
+    bool test(std::size_t i, std::size_t j) const
+    {
+      return (row(i)[j / 64] >> (j % 64)) & 1;
+    }
+
+    void set(std::size_t i, std::size_t j)
+    {
+      row(i)[j / 64] |= word(1) << (j % 64);
+    }
+
+    /// \brief Calls f(j) for each j such that the bit at column j of row i is set, in increasing order.
+    template <typename Function>
+    void for_each_in_row(std::size_t i, Function f) const
+    {
+      const word* r = row(i);
+      for (std::size_t k = 0; k < m_words_per_row; ++k)
+      {
+        for (word w = r[k]; w != 0; w &= w - 1)
+        {
+          f(64 * k + count_trailing_zeros(w));
+        }
+      }
+    }
+
+    static std::size_t count_trailing_zeros(word w)
+    {
+      assert(w != 0);
+#if defined(__GNUC__) || defined(__clang__)
+      return __builtin_ctzll(w);
+#else
+      std::size_t result = 0;
+      for (; (w & 1) == 0; w >>= 1)
+      {
+        ++result;
+      }
+      return result;
+#endif
+    }
+};
+
+/// \brief Computes the simulation preorder, or the ready simulation preorder, of an LTS.
+/// \details State s is simulated by state t if for each transition s -a-> s' there is a transition
+/// t -a-> t' such that s' is simulated by t'. For ready simulation s and t must moreover enable the
+/// same actions. First the LTS is reduced modulo strong bisimulation, which is contained in both
+/// preorders. Then for each equivalence class s the set of classes that simulate s is stored as a
+/// row of a bit matrix. A row is initialised with the classes that enable the right actions, and
+/// it is refined by intersecting it with the set of a-predecessors of the row of s', for each
+/// transition s -a-> s'. Rows of which a successor row has changed are refined again, until
+/// nothing changes. In each round the rows are refined in parallel, with respect to the rows of
+/// the previous round.
+template <class LTS_TYPE>
+class sim_bit_matrix
+{
+  protected:
+    typedef bit_matrix::word word;
+
+    bool m_ready;
+    std::size_t m_number_of_threads;
+
+    std::vector<std::size_t> m_class;  // m_class[s] is the strong bisimulation class of state s
+    std::size_t m_class_count = 0;
+
+    // The transitions between classes. The outgoing transitions of class s are at positions
+    // [m_out_offsets[s], m_out_offsets[s + 1]) of m_out, sorted on label and target. The incoming
+    // transitions of class t are at positions [m_in_offsets[t], m_in_offsets[t + 1]) of m_in,
+    // sorted on label and source.
+    std::vector<std::size_t> m_out_offsets;
+    std::vector<std::pair<std::size_t, std::size_t> > m_out; // (label, target)
+    std::vector<std::size_t> m_in_offsets;
+    std::vector<std::pair<std::size_t, std::size_t> > m_in;  // (label, source)
+
+    bit_matrix m_relation; // m_relation.test(s, t) holds if class t simulates class s
+
+    void compute_classes(LTS_TYPE& l)
+    {
+      bisim_partitioner_parallel<LTS_TYPE> partitioner(l, false, false, m_number_of_threads);
+      m_class_count = partitioner.num_eq_classes();
+      m_class.resize(l.num_states());
+      for (std::size_t s = 0; s < l.num_states(); ++s)
+      {
+        m_class[s] = partitioner.get_eq_class(s);
+      }
+
+      std::vector<std::tuple<std::size_t, std::size_t, std::size_t> > transitions; // (source, label, target)
+      transitions.reserve(l.get_transitions().size());
+      for (const transition& t: l.get_transitions())
+      {
+        transitions.emplace_back(m_class[t.from()], l.apply_hidden_label_map(t.label()), m_class[t.to()]);
+      }
+      std::sort(transitions.begin(), transitions.end());
+      transitions.erase(std::unique(transitions.begin(), transitions.end()), transitions.end());
+
+      m_out_offsets.assign(m_class_count + 1, 0);
+      m_in_offsets.assign(m_class_count + 1, 0);
+      for (const auto& t: transitions)
+      {
+        m_out_offsets[std::get<0>(t) + 1]++;
+        m_in_offsets[std::get<2>(t) + 1]++;
+      }
+      for (std::size_t s = 0; s < m_class_count; ++s)
+      {
+        m_out_offsets[s + 1] += m_out_offsets[s];
+        m_in_offsets[s + 1] += m_in_offsets[s];
+      }
+      m_out.resize(transitions.size());
+      m_in.resize(transitions.size());
+      std::vector<std::size_t> in_position(m_in_offsets.begin(), m_in_offsets.end() - 1);
+      for (std::size_t i = 0; i < transitions.size(); ++i)
+      {
+        // Since the transitions are sorted, the outgoing transitions are sorted on label and target.
+        m_out[i] = std::make_pair(std::get<1>(transitions[i]), std::get<2>(transitions[i]));
+        m_in[in_position[std::get<2>(transitions[i])]++] = std::make_pair(std::get<1>(transitions[i]), std::get<0>(transitions[i]));
+      }
+      for (std::size_t t = 0; t < m_class_count; ++t)
+      {
+        std::sort(m_in.begin() + m_in_offsets[t], m_in.begin() + m_in_offsets[t + 1]);
+      }
+    }
+
+    // Returns the sorted labels of the outgoing transitions of class s.
+    std::vector<std::size_t> enabled_actions(std::size_t s) const
+    {
+      std::vector<std::size_t> result;
+      for (std::size_t i = m_out_offsets[s]; i < m_out_offsets[s + 1]; ++i)
+      {
+        if (result.empty() || result.back() != m_out[i].first)
+        {
+          result.push_back(m_out[i].first);
+        }
+      }
+      return result;
+    }
+
+    // Initialises the row of s with the classes t that enable a superset of the actions of s, or the
+    // same actions in case of ready simulation.
+    void initialise_relation()
+    {
+      const std::size_t n = m_class_count;
+      const std::size_t words = m_relation.words_per_row();
+      std::map<std::vector<std::size_t>, std::vector<std::size_t> > classes_per_action_set;
+      for (std::size_t s = 0; s < n; ++s)
+      {
+        classes_per_action_set[enabled_actions(s)].push_back(s);
+      }
+
+      if (m_ready)
+      {
+        for (const auto& p: classes_per_action_set)
+        {
+          for (std::size_t s: p.second)
+          {
+            for (std::size_t t: p.second)
+            {
+              m_relation.set(s, t);
+            }
+          }
+        }
+        return;
+      }
+
+      // For each action a the set of classes that enable a.
+      std::map<std::size_t, std::vector<word> > enabled;
+      for (const auto& p: classes_per_action_set)
+      {
+        for (std::size_t a: p.first)
+        {
+          std::vector<word>& v = enabled[a];
+          v.resize(words, 0);
+          for (std::size_t t: p.second)
+          {
+            v[t / 64] |= word(1) << (t % 64);
+          }
+        }
+      }
+      for (const auto& p: classes_per_action_set)
+      {
+        std::vector<word> r(words, ~word(0));
+        if (n % 64 != 0)
+        {
+          r[words - 1] = (word(1) << (n % 64)) - 1;
+        }
+        for (std::size_t a: p.first)
+        {
+          const std::vector<word>& v = enabled[a];
+          for (std::size_t k = 0; k < words; ++k)
+          {
+            r[k] &= v[k];
+          }
+        }
+        for (std::size_t s: p.second)
+        {
+          std::copy(r.begin(), r.end(), m_relation.row(s));
+        }
+      }
+    }
+
+    // Computes in result the set of classes that have an a-transition to a class in the row of t.
+    void compute_predecessors(std::size_t a, std::size_t t, std::vector<word>& result) const
+    {
+      std::fill(result.begin(), result.end(), 0);
+      m_relation.for_each_in_row(t, [&](std::size_t u)
+        {
+          auto first = m_in.begin() + m_in_offsets[u];
+          auto last = m_in.begin() + m_in_offsets[u + 1];
+          for (auto i = std::lower_bound(first, last, std::make_pair(a, std::size_t(0))); i != last && i->first == a; ++i)
+          {
+            result[i->second / 64] |= word(1) << (i->second % 64);
+          }
+        });
+    }
+
+    // Computes the refined row of s in result. Returns true if it differs from the current row.
+    bool refine_row(std::size_t s, std::vector<word>& result) const
+    {
+      const std::size_t words = m_relation.words_per_row();
+      const word* current = m_relation.row(s);
+      result.assign(current, current + words);
+      std::vector<word> predecessors(words);
+      for (std::size_t i = m_out_offsets[s]; i < m_out_offsets[s + 1]; ++i)
+      {
+        compute_predecessors(m_out[i].first, m_out[i].second, predecessors);
+        for (std::size_t k = 0; k < words; ++k)
+        {
+          result[k] &= predecessors[k];
+        }
+      }
+      return !std::equal(result.begin(), result.end(), current);
+    }
+
+    void compute_relation()
+    {
+      const std::size_t n = m_class_count;
+      m_relation = bit_matrix(n);
+      initialise_relation();
+
+      std::vector<std::size_t> todo(n);
+      for (std::size_t s = 0; s < n; ++s)
+      {
+        todo[s] = s;
+      }
+      std::vector<bool> in_todo(n, false);
+      std::size_t iterations = 0;
+      while (!todo.empty())
+      {
+        std::vector<std::vector<word> > rows(todo.size());
+        std::vector<char> changed(todo.size(), 0);
+        parallel_for(0, todo.size(), m_number_of_threads, [&](std::size_t i)
+          {
+            changed[i] = refine_row(todo[i], rows[i]);
+          });
+
+        std::vector<std::size_t> next;
+        for (std::size_t i = 0; i < todo.size(); ++i)
+        {
+          if (!changed[i])
+          {
+            continue;
+          }
+          const std::size_t s = todo[i];
+          std::copy(rows[i].begin(), rows[i].end(), m_relation.row(s));
+          for (std::size_t j = m_in_offsets[s]; j < m_in_offsets[s + 1]; ++j)
+          {
+            const std::size_t u = m_in[j].second;
+            if (!in_todo[u])
+            {
+              in_todo[u] = true;
+              next.push_back(u);
+            }
+          }
+        }
+        for (std::size_t u: next)
+        {
+          in_todo[u] = false;
+        }
+        std::sort(next.begin(), next.end());
+        todo.swap(next);
+        mCRL2log(log::debug) << "simulation bit matrix: iteration " << ++iterations << ", " << todo.size() << " rows to refine" << std::endl;
+      }
+    }
+
+  public:
+    /// \brief Constructor. The preorder is computed immediately.
+    /// \param l The LTS. It is not changed, but it cannot be const for the bisimulation reduction.
+    /// \param ready If true, the ready simulation preorder is computed, otherwise the simulation preorder.
+    /// \param number_of_threads The maximum number of threads that is used.
+    sim_bit_matrix(LTS_TYPE& l, bool ready, std::size_t number_of_threads = default_number_of_threads())
+      : m_ready(ready),
+        m_number_of_threads(std::max(std::size_t(1), number_of_threads))
+    {
+      compute_classes(l);
+      mCRL2log(log::verbose) << "simulation bit matrix: " << m_class_count << " strong bisimulation classes" << std::endl;
+      compute_relation();
+    }
+
+    /// \brief Returns true if state s is simulated by state t.
+    bool in_preorder(std::size_t s, std::size_t t) const
+    {
+      return m_relation.test(m_class[s], m_class[t]);
+    }
+
+    /// \brief Returns true if the states s and t simulate each other.
+    bool in_same_class(std::size_t s, std::size_t t) const
+    {
+      return in_preorder(s, t) && in_preorder(t, s);
+    }
+};
+
+} // namespace detail
+} // namespace lts
+} // namespace mcrl2
+
+#endif // MCRL2_LTS_DETAIL_LIBLTS_SIM_BIT_MATRIX_H
@@ -7,16 +7,21 @@
 // http://www.boost.org/LICENSE_1_0.txt)
 //
 /// \file lts/detail/liblts_weak_bisim.h
-/// \brief This file defines an algorithm for weak bisimulation, by
-///        calculating the transitive tau closure and apply strong
-///        bisimulation afterwards. In order to apply this algorithm
-///        it is advisable to first apply a branching bisimulation reduction.
+/// \brief This file defines an algorithm for weak bisimulation. It first
+///        applies branching bisimulation reduction, which removes tau cycles,
+///        and subsequently refines the partition using weak signatures that
+///        are computed from the tau-acyclic graph, without adding the
+///        transitions of the transitive tau closure to the LTS.
 
 #ifndef _LIBLTS_WEAK_BISIM_H
 #define _LIBLTS_WEAK_BISIM_H
+#include <algorithm>
 #include <cmath>
+#include <tuple>
+#include <unordered_map>
 #include <vector>
 #include <map>
+#include "mcrl2/utilities/hash_utility.h"
 #include "mcrl2/utilities/logger.h"
 #include "mcrl2/lts/lts.h"
 #include "mcrl2/lts/detail/liblts_scc.h"
@@ -34,7 +39,355 @@ namespace lts
 namespace detail
 {
 
+/// \brief Computes weak bisimulation equivalence classes by signature refinement.
+/// \details The weak signature of a state s with respect to a partition is the set of pairs (a, B)
+/// such that s =a=> t for some state t in block B, where =tau=> is a sequence of zero or more tau steps,
+/// and =a=> for a visible action a is =tau=> -a-> =tau=>. Two states are weakly bisimilar if and only if
+/// they have the same weak signature with respect to the partition of weak bisimulation.
+/// The LTS may not contain tau cycles, including tau self loops. The states are then processed in
+/// an order such that the tau successors of a state come first. In each round first the set of blocks
+/// that can be reached by =tau=> is computed for each state, and then the weak signatures, where the
+/// signature of a state is the union of the signatures of its tau successors and the pairs induced by its
+/// visible transitions. In this way no transitions of the transitive tau closure are added to the LTS.
+/// The sets of blocks and the signatures are interned, and for each state only their numbers are stored.
+/// They are computed once for every combination of the numbers of the successors of a state. Hence the
+/// memory used in a round is linear in the size of the LTS plus the total size of the distinct signatures.
+/// States with the same signature, like the states on a tau path to a common state, share it. In the worst
+/// case, when many states have large and different signatures, this is still quadratic.
+template <class LTS_TYPE>
+class weak_bisim_partitioner
+{
+  public:
+    typedef std::pair<std::size_t, std::size_t> signature_element; // (action label, target block)
+    typedef std::vector<signature_element> signature_type;
+
+  protected:
+    LTS_TYPE& m_lts;
+
+    // The transitions of state s are at positions [m_offsets[s], m_offsets[s + 1]) of m_labels and m_targets.
+    // The hidden label map has been applied to the labels.
+    std::vector<std::size_t> m_offsets;
+    std::vector<std::size_t> m_labels;
+    std::vector<std::size_t> m_targets;
+
+    // The states, such that the tau successors of a state precede it.
+    std::vector<std::size_t> m_order;
+
+    std::vector<std::size_t> m_partition;
+    std::size_t m_block_count = 1;
+
+    // Stores every distinct value once, and numbers the values consecutively.
+    template <typename T>
+    class interning_table
+    {
+      protected:
+        std::unordered_map<T, std::size_t> m_indices;
+        std::vector<const T*> m_values;
+
+      public:
+        // Returns the number of x.
+        std::size_t insert(T&& x)
+        {
+          auto i = m_indices.emplace(std::move(x), m_values.size());
+          if (i.second)
+          {
+            m_values.push_back(&i.first->first);
+          }
+          return i.first->second;
+        }
+
+        const T& operator[](std::size_t i) const
+        {
+          return *m_values[i];
+        }
+    };
+
+    // The label that is used in signatures for =tau=>. It is larger than all action labels,
+    // so in a sorted signature the corresponding elements are at the end.
+    static std::size_t tau()
+    {
+      return std::size_t(-1);
+    }
+
+    bool is_tau(std::size_t label) const
+    {
+      return m_lts.is_tau(label);
+    }
+
+    void compute_transitions()
+    {
+      const std::size_t n = m_lts.num_states();
+      m_offsets.assign(n + 1, 0);
+      for (const transition& t: m_lts.get_transitions())
+      {
+        m_offsets[t.from() + 1]++;
+      }
+      for (std::size_t s = 0; s < n; ++s)
+      {
+        m_offsets[s + 1] += m_offsets[s];
+      }
+      m_labels.resize(m_lts.get_transitions().size());
+      m_targets.resize(m_lts.get_transitions().size());
+      std::vector<std::size_t> position(m_offsets.begin(), m_offsets.end() - 1);
+      for (const transition& t: m_lts.get_transitions())
+      {
+        std::size_t& i = position[t.from()];
+        m_labels[i] = m_lts.apply_hidden_label_map(t.label());
+        m_targets[i] = t.to();
+        assert(!is_tau(m_labels[i]) || t.from() != t.to());
+        ++i;
+      }
+    }
+
+    // Computes a post order of a depth first search over the tau transitions.
+    void compute_order()
+    {
+      const std::size_t n = m_lts.num_states();
+      std::vector<bool> visited(n, false);
+      std::vector<std::pair<std::size_t, std::size_t> > stack; // (state, position of the next transition to visit)
+      m_order.reserve(n);
+      for (std::size_t root = 0; root < n; ++root)
+      {
+        if (visited[root])
+        {
+          continue;
+        }
+        visited[root] = true;
+        stack.emplace_back(root, m_offsets[root]);
+        while (!stack.empty())
+        {
+          std::size_t s = stack.back().first;
+          std::size_t& i = stack.back().second;
+          if (i == m_offsets[s + 1])
+          {
+            m_order.push_back(s);
+            stack.pop_back();
+            continue;
+          }
+          std::size_t t = m_targets[i];
+          if (is_tau(m_labels[i++]) && !visited[t])
+          {
+            visited[t] = true;
+            stack.emplace_back(t, m_offsets[t]);
+          }
+        }
+      }
+    }
+
+    // Computes the signatures, and the partition induced by them. Returns true if the number of blocks has increased.
+    bool refine()
+    {
+      const std::size_t n = m_lts.num_states();
+
+      // For each state s the set of blocks that can be reached from s by =tau=>. It only depends on the
+      // block of s and the sets of its tau successors, so it is computed once for every such key.
+      interning_table<std::vector<std::size_t> > block_sets;
+      std::unordered_map<std::vector<std::size_t>, std::size_t> block_set_keys;
+      std::vector<std::size_t> tau_reachable(n);
+      std::vector<std::size_t> key;
+      for (std::size_t s: m_order)
+      {
+        key.assign(1, m_partition[s]);
+        for (std::size_t i = m_offsets[s]; i < m_offsets[s + 1]; ++i)
+        {
+          if (is_tau(m_labels[i]))
+          {
+            // The set of t has been computed before, since t precedes s in m_order.
+            key.push_back(tau_reachable[m_targets[i]]);
+          }
+        }
+        std::sort(key.begin() + 1, key.end());
+        key.erase(std::unique(key.begin() + 1, key.end()), key.end());
+        auto j = block_set_keys.find(key);
+        if (j != block_set_keys.end())
+        {
+          tau_reachable[s] = j->second;
+          continue;
+        }
+
+        std::vector<std::size_t> blocks(1, m_partition[s]);
+        for (auto k = key.begin() + 1; k != key.end(); ++k)
+        {
+          const std::vector<std::size_t>& target_blocks = block_sets[*k];
+          blocks.insert(blocks.end(), target_blocks.begin(), target_blocks.end());
+        }
+        std::sort(blocks.begin(), blocks.end());
+        blocks.erase(std::unique(blocks.begin(), blocks.end()), blocks.end());
+        tau_reachable[s] = block_sets.insert(std::move(blocks));
+        block_set_keys.emplace(key, tau_reachable[s]);
+      }
+
+      // Likewise the signature of s only depends on the set of blocks of s, the signatures of its tau
+      // successors and the pairs (a, set of blocks of t) of its visible transitions s -a-> t.
+      interning_table<signature_type> signatures;
+      std::unordered_map<std::vector<std::size_t>, std::size_t> signature_keys;
+      std::vector<std::size_t> signature_ids(n);
+      std::vector<std::pair<std::size_t, std::size_t> > visible;
+      for (std::size_t s: m_order)
+      {
+        key.assign(1, tau_reachable[s]);
+        visible.clear();
+        for (std::size_t i = m_offsets[s]; i < m_offsets[s + 1]; ++i)
+        {
+          std::size_t t = m_targets[i];
+          if (is_tau(m_labels[i]))
+          {
+            key.push_back(signature_ids[t]);
+          }
+          else
+          {
+            visible.emplace_back(m_labels[i], tau_reachable[t]);
+          }
+        }
+        std::sort(key.begin() + 1, key.end());
+        key.erase(std::unique(key.begin() + 1, key.end()), key.end());
+        std::size_t tau_successor_count = key.size() - 1;
+        std::sort(visible.begin(), visible.end());
+        visible.erase(std::unique(visible.begin(), visible.end()), visible.end());
+        key.push_back(tau()); // separates the tau successors from the visible transitions
+        for (const auto& v: visible)
+        {
+          key.push_back(v.first);
+          key.push_back(v.second);
+        }
+        auto j = signature_keys.find(key);
+        if (j != signature_keys.end())
+        {
+          signature_ids[s] = j->second;
+          continue;
+        }
+
+        signature_type sig;
+        for (std::size_t b: block_sets[tau_reachable[s]])
+        {
+          sig.emplace_back(tau(), b);
+        }
+        for (std::size_t k = 1; k <= tau_successor_count; ++k)
+        {
+          const signature_type& target_sig = signatures[key[k]];
+          sig.insert(sig.end(), target_sig.begin(), target_sig.end());
+        }
+        for (const auto& v: visible)
+        {
+          for (std::size_t b: block_sets[v.second])
+          {
+            sig.emplace_back(v.first, b);
+          }
+        }
+        std::sort(sig.begin(), sig.end());
+        sig.erase(std::unique(sig.begin(), sig.end()), sig.end());
+        signature_ids[s] = signatures.insert(std::move(sig));
+        signature_keys.emplace(key, signature_ids[s]);
+      }
+
+      // The new block of s is determined by the pair (old block of s, signature of s).
+      std::vector<std::size_t> partition(n);
+      std::unordered_map<std::pair<std::size_t, std::size_t>, std::size_t> blocks;
+      blocks.reserve(m_block_count);
+      for (std::size_t s = 0; s < n; ++s)
+      {
+        partition[s] = blocks.emplace(std::make_pair(m_partition[s], signature_ids[s]), blocks.size()).first->second;
+      }
+
+      m_partition.swap(partition);
+      bool result = blocks.size() != m_block_count;
+      m_block_count = blocks.size();
+      return result;
+    }
+
+  public:
+    /// \brief Constructor. The equivalence classes are computed immediately.
+    /// \param l The LTS. It may not contain tau cycles, including tau self loops.
+    explicit weak_bisim_partitioner(LTS_TYPE& l)
+      : m_lts(l),
+        m_partition(l.num_states(), 0),
+        m_block_count(l.num_states() == 0 ? 0 : 1)
+    {
+      compute_transitions();
+      compute_order();
+      std::size_t iterations = 0;
+      while (refine())
+      {
+        mCRL2log(log::verbose) << "weak bisimulation: iteration " << ++iterations << ", " << m_block_count << " blocks" << std::endl;
+      }
+    }
+
+    /// \brief Returns the number of equivalence classes.
+    std::size_t num_eq_classes() const
+    {
+      return m_block_count;
+    }
+
+    /// \brief Returns the equivalence class of state s.
+    std::size_t get_eq_class(std::size_t s) const
+    {
+      return m_partition[s];
+    }
+
+    /// \brief Returns true if s and t are in the same equivalence class.
+    bool in_same_class(std::size_t s, std::size_t t) const
+    {
+      return m_partition[s] == m_partition[t];
+    }
+
+    /// \brief Replaces the LTS by its quotient with respect to the computed equivalence.
+    /// \details Tau transitions within an equivalence class are removed. The state labels of an
+    /// equivalence class are concatenated.
+    void replace_transition_system()
+    {
+      std::vector<transition> transitions;
+      transitions.reserve(m_labels.size());
+      for (std::size_t s = 0; s < m_lts.num_states(); ++s)
+      {
+        for (std::size_t i = m_offsets[s]; i < m_offsets[s + 1]; ++i)
+        {
+          if (!is_tau(m_labels[i]) || m_partition[s] != m_partition[m_targets[i]])
+          {
+            transitions.emplace_back(m_partition[s], m_labels[i], m_partition[m_targets[i]]);
+          }
+        }
+      }
+      auto less = [](const transition& x, const transition& y)
+      {
+        return std::make_tuple(x.from(), x.label(), x.to()) < std::make_tuple(y.from(), y.label(), y.to());
+      };
+      auto equal = [](const transition& x, const transition& y)
+      {
+        return x.from() == y.from() && x.label() == y.label() && x.to() == y.to();
+      };
+      std::sort(transitions.begin(), transitions.end(), less);
+      transitions.erase(std::unique(transitions.begin(), transitions.end(), equal), transitions.end());
+      m_lts.clear_transitions();
+      for (const transition& t: transitions)
+      {
+        m_lts.add_transition(t);
+      }
+
+      if (m_lts.has_state_info())
+      {
+        std::vector<typename LTS_TYPE::state_label_t> new_labels(m_block_count);
+        for (std::size_t i = m_lts.num_states(); i > 0; )
+        {
+          --i;
+          new_labels[m_partition[i]] = m_lts.state_label(i) + new_labels[m_partition[i]];
+        }
+        m_lts.set_num_states(m_block_count);
+        for (std::size_t i = 0; i < m_block_count; ++i)
+        {
+          m_lts.set_state_label(i, new_labels[i]);
+        }
+      }
+      else
+      {
+        m_lts.set_num_states(m_block_count);
+      }
+      m_lts.set_initial_state(m_partition[m_lts.initial_state()]);
+    }
+};
+
 /** \brief Reduce LTS l with respect to (divergence-preserving) weak bisimulation.
+ * \details Divergence is preserved by replacing tau self loops by a fresh visible action before the
+ *          weak signatures are computed.
  * \param[in/out] l The transition system that is reduced.
  * \param[in] preserve_divergences Indicates whether loops of internal actions on states must be preserved. If false
  *            these are removed. If true these are preserved.  */
@@ -44,18 +397,19 @@ void weak_bisimulation_reduce(
   const bool preserve_divergences = false)
 {
   bisimulation_reduce_gjkw(l, true, preserve_divergences);
-  //< Apply branching bisimulation to l.
+  //< Apply branching bisimulation to l. This also removes tau cycles.
 
   std::size_t divergence_label;
   if (preserve_divergences)
   {
     divergence_label=mark_explicit_divergence_transitions(l);
   } 
-  reflexive_transitive_tau_closure(l);                        // Apply transitive tau closure to l.
-  bisimulation_reduce_gjkw(l, false, false);                  // Apply strong bisimulation to l.
-  scc_reduce(l);                                              // Remove tau loops.
+  {
+    weak_bisim_partitioner<LTS_TYPE> partitioner(l);
+    partitioner.replace_transition_system();
+  }
   remove_redundant_transitions(l);                            // Remove transitions s -a-> s' if also s-a->-tau->s' or s-tau->-a->s' is present.
-                                                              // Note that this is correct, because l is reduced modulo strong bisimulation and
+                                                              // Note that this is correct, because l is reduced modulo weak bisimulation and
                                                               // does not contain tau loops. 
   if (preserve_divergences)
   {
@@ -66,8 +420,8 @@ void weak_bisimulation_reduce(
 
 /** \brief Checks whether the initial states of two LTSs are weakly bisimilar.
  * \details The LTSs l1 and l2 are not usable anymore after this call.
- *          The space consumption is O(n) and running time is dominated by the
- *          transitive closure (after branching bisimulation).
+ *          The space consumption is O(n) plus the size of the weak signatures
+ *          (after branching bisimulation).
  * \param[in/out] l1 A first transition system.
  * \param[in/out] l2 A second transistion system.
  * \param[preserve_divergences] If true and branching is true, preserve tau loops on states.
@@ -88,8 +442,8 @@ bool destructive_weak_bisimulation_compare(
  *  \details The LTSs l1 and l2 are first duplicated and subsequently
  *           reduced modulo bisimulation. If memory space is a concern, one could consider to
  *           use destructive_weak_bisimulation_compare.  The running time
- *           of this routine is dominated by the transitive closure
- *           (after branching bisimulation).  It uses O(m+n) memory
+ *           of this routine is dominated by the computation of the weak
+ *           signatures (after branching bisimulation).  It uses O(m+n) memory
  *           in addition to the copies of l1 and l2, where n is the
  *           number of states and m is the number of transitions.
  * \param[in/out] l1 A first transition system.
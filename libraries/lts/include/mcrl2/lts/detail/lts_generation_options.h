@@ -13,6 +13,8 @@
 #ifndef MCRL2_LTS_DETAIL_LTS_GENERATION_OPTIONS_H
 #define MCRL2_LTS_DETAIL_LTS_GENERATION_OPTIONS_H
 
+#include <set>
+#include "mcrl2/core/identifier_string.h"
 #include "mcrl2/data/rewrite_strategy.h"
 #include "mcrl2/lps/specification.h"
 #include "mcrl2/lts/detail/exploration_strategy.h"
@@ -49,6 +51,23 @@ class lts_generation_options
     bool detect_nondeterminism = false;
     bool use_enumeration_caching = false;
 
+    // Settings for saving traces to deadlocks and to transitions with certain actions.
+    bool trace = false;
+    std::size_t max_traces = default_max_traces;
+    std::string trace_prefix;
+    bool detect_action = false;
+    std::set<core::identifier_string> trace_actions;
+    bool compress_states = false;
+
+    // Settings for external memory exploration, in which the states are stored on disk.
+    bool external_memory = false;
+    std::size_t memory_budget = 256UL * 1024UL * 1024UL; // The number of bytes used for sorting states in memory.
+    std::string temporary_directory = ".";
+
+    // Settings for writing machine readable progress information in JSON format.
+    std::string telemetry_filename; // If empty, no progress information is written.
+    std::size_t telemetry_interval = 1000; // The minimal number of milliseconds between two lines.
+
     /// \brief Constructor
     lts_generation_options() = default;
 
@@ -0,0 +1,111 @@
+// Author(s): Wieger Wesselink
+// Copyright: see the accompanying file COPYING or copy at
+// https://github.com/mCRL2org/mCRL2/blob/master/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file mcrl2/lts/detail/predecessor_table.h
+/// \brief Stores for each state the state and the summand by which it was first reached.
+
+#ifndef MCRL2_LTS_DETAIL_PREDECESSOR_TABLE_H
+#define MCRL2_LTS_DETAIL_PREDECESSOR_TABLE_H
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace mcrl2 {
+
+namespace lts {
+
+namespace detail {
+
+/// \brief Stores for each state number the number of a predecessor state and the index of the summand
+/// of the transition between them. Together these form a spanning tree of the explored states, from
+/// which a path to a state can be reconstructed. The entries are stored in pages of a fixed size, such
+/// that the table can grow without copying. An entry takes 12 bytes.
+class predecessor_table
+{
+  protected:
+    // The number of entries of a page.
+    static std::size_t page_size()
+    {
+      return 1 << 16;
+    }
+
+    struct page
+    {
+      std::uint64_t predecessors[1 << 16];
+      std::uint32_t summands[1 << 16];
+    };
+
+    std::vector<std::unique_ptr<page> > m_pages;
+    std::size_t m_size = 0;
+
+  public:
+    /// \brief Adds an entry for the next state number.
+    void push_back(std::size_t predecessor, std::size_t summand_index)
+    {
+      if (m_size == m_pages.size() * page_size())
+      {
+        m_pages.push_back(std::unique_ptr<page>(new page));
+      }
+      page& p = *m_pages[m_size / page_size()];
+      p.predecessors[m_size % page_size()] = predecessor;
+      p.summands[m_size % page_size()] = static_cast<std::uint32_t>(summand_index);
+      m_size++;
+    }
+
+    /// \brief Returns the predecessor of state k.
+    std::size_t predecessor(std::size_t k) const
+    {
+      assert(k < m_size);
+      return static_cast<std::size_t>(m_pages[k / page_size()]->predecessors[k % page_size()]);
+    }
+
+    /// \brief Returns the index of the summand of the transition from predecessor(k) to state k.
+    std::size_t summand_index(std::size_t k) const
+    {
+      assert(k < m_size);
+      return m_pages[k / page_size()]->summands[k % page_size()];
+    }
+
+    /// \brief Returns the states on the path from the root to state k, where the root is the first state
+    /// that is its own predecessor.
+    std::vector<std::size_t> path(std::size_t k) const
+    {
+      std::vector<std::size_t> result;
+      result.push_back(k);
+      while (predecessor(k) != k)
+      {
+        k = predecessor(k);
+        result.push_back(k);
+      }
+      std::reverse(result.begin(), result.end());
+      return result;
+    }
+
+    /// \brief Returns the number of entries.
+    std::size_t size() const
+    {
+      return m_size;
+    }
+
+    void clear()
+    {
+      m_pages.clear();
+      m_size = 0;
+    }
+};
+
+} // namespace detail
+
+} // namespace lts
+
+} // namespace mcrl2
+
+#endif // MCRL2_LTS_DETAIL_PREDECESSOR_TABLE_H
@@ -0,0 +1,516 @@
+// Author(s): Wieger Wesselink
+// Copyright: see the accompanying file COPYING or copy at
+// https://github.com/mCRL2org/mCRL2/blob/master/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file mcrl2/lts/detail/scc_decomposition.h
+/// \brief Decomposition of a graph into strongly connected components, both sequentially
+///        and in parallel. It is used for finding the tau loops of an LTS.
+
+#ifndef MCRL2_LTS_DETAIL_SCC_DECOMPOSITION_H
+#define MCRL2_LTS_DETAIL_SCC_DECOMPOSITION_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "mcrl2/lts/transition.h"
+
+namespace mcrl2
+{
+namespace lts
+{
+namespace detail
+{
+
+/// \brief A directed graph with vertices 0, ..., n-1, in which the successors of a vertex are stored
+/// consecutively in one array (compressed sparse row format). The predecessors are stored in
+/// the same way.
+class csr_graph
+{
+  protected:
+    std::vector<std::size_t> m_successor_offsets;
+    std::vector<std::size_t> m_successors;
+    std::vector<std::size_t> m_predecessor_offsets;
+    std::vector<std::size_t> m_predecessors;
+
+    static void fill(std::size_t n,
+                     const std::vector<std::pair<std::size_t, std::size_t> >& edges,
+                     bool reversed,
+                     std::vector<std::size_t>& offsets,
+                     std::vector<std::size_t>& targets)
+    {
+      offsets.assign(n + 1, 0);
+      for (const auto& e: edges)
+      {
+        offsets[(reversed ? e.second : e.first) + 1]++;
+      }
+      for (std::size_t v = 0; v < n; ++v)
+      {
+        offsets[v + 1] += offsets[v];
+      }
+      targets.resize(edges.size());
+      std::vector<std::size_t> position(offsets.begin(), offsets.end() - 1);
+      for (const auto& e: edges)
+      {
+        if (reversed)
+        {
+          targets[position[e.second]++] = e.first;
+        }
+        else
+        {
+          targets[position[e.first]++] = e.second;
+        }
+      }
+    }
+
+  public:
+    /// \brief Constructor.
+    /// \param n The number of vertices.
+    /// \param edges The edges of the graph.
+    csr_graph(std::size_t n, const std::vector<std::pair<std::size_t, std::size_t> >& edges)
+    {
+      fill(n, edges, false, m_successor_offsets, m_successors);
+      fill(n, edges, true, m_predecessor_offsets, m_predecessors);
+    }
+
+    std::size_t num_vertices() const
+    {
+      return m_successor_offsets.size() - 1;
+    }
+
+    const std::size_t* successors_begin(std::size_t v) const
+    {
+      return m_successors.data() + m_successor_offsets[v];
+    }
+
+    const std::size_t* successors_end(std::size_t v) const
+    {
+      return m_successors.data() + m_successor_offsets[v + 1];
+    }
+
+    const std::size_t* predecessors_begin(std::size_t v) const
+    {
+      return m_predecessors.data() + m_predecessor_offsets[v];
+    }
+
+    const std::size_t* predecessors_end(std::size_t v) const
+    {
+      return m_predecessors.data() + m_predecessor_offsets[v + 1];
+    }
+};
+
+/// \brief Returns the graph of the tau transitions of l, after applying the hidden label map.
+template <class LTS_TYPE>
+csr_graph tau_graph(const LTS_TYPE& l)
+{
+  std::vector<std::pair<std::size_t, std::size_t> > edges;
+  for (const transition& t: l.get_transitions())
+  {
+    if (l.is_tau(l.apply_hidden_label_map(t.label())))
+    {
+      edges.emplace_back(t.from(), t.to());
+    }
+  }
+  return csr_graph(l.num_states(), edges);
+}
+
+/// \brief Computes the strongly connected components of a graph.
+/// \details With one thread an iterative version of Tarjan's algorithm is used. With more threads, first
+/// the vertices without predecessors or successors are removed repeatedly (trimming), after which the
+/// remaining vertices are split by the forward-backward algorithm: the vertices that are both reachable
+/// from and can reach a pivot form a component, and the three remaining parts are handled as independent
+/// tasks by a pool of threads. Small tasks are finished with Tarjan's algorithm. The components are
+/// numbered in the order of their smallest vertex, hence the result does not depend on the number of threads.
+class scc_decomposition
+{
+  protected:
+    static std::size_t undefined()
+    {
+      return std::numeric_limits<std::size_t>::max();
+    }
+
+    // Tasks with fewer vertices than this are handled using Tarjan's algorithm.
+    static std::size_t minimum_task_size()
+    {
+      return 1024;
+    }
+
+    struct task
+    {
+      std::size_t color;
+      std::vector<std::size_t> vertices;
+    };
+
+    const csr_graph& m_graph;
+    std::vector<std::size_t> m_component;      // first the root of the component, then the component number
+    std::vector<std::size_t> m_component_size;
+    std::vector<bool> m_on_cycle;              // per component
+    std::size_t m_number_of_components = 0;
+
+    // Used by the parallel algorithm. A vertex takes part in the task with its color.
+    std::vector<std::atomic<std::size_t> > m_color;
+    std::atomic<std::size_t> m_next_color{1};
+
+    // Used by Tarjan's algorithm. An index of 0 means that the vertex has not been visited.
+    std::vector<std::size_t> m_index;
+    std::vector<std::size_t> m_low;
+
+    // Applies Tarjan's algorithm to the vertices v for which in_scope(v) holds. Each component
+    // gets its root as number.
+    template <typename Predicate>
+    void tarjan(const std::vector<std::size_t>& roots, Predicate in_scope)
+    {
+      std::size_t index = 1;
+      std::vector<std::size_t> scc_stack;
+      std::vector<std::pair<std::size_t, const std::size_t*> > dfs_stack;
+      for (std::size_t root: roots)
+      {
+        if (m_index[root] != 0)
+        {
+          continue;
+        }
+        m_index[root] = m_low[root] = index++;
+        scc_stack.push_back(root);
+        dfs_stack.emplace_back(root, m_graph.successors_begin(root));
+        while (!dfs_stack.empty())
+        {
+          const std::size_t v = dfs_stack.back().first;
+          const std::size_t* i = dfs_stack.back().second;
+          if (i != m_graph.successors_end(v))
+          {
+            dfs_stack.back().second++;
+            const std::size_t w = *i;
+            if (!in_scope(w))
+            {
+              continue;
+            }
+            if (m_index[w] == 0)
+            {
+              m_index[w] = m_low[w] = index++;
+              scc_stack.push_back(w);
+              dfs_stack.emplace_back(w, m_graph.successors_begin(w));
+            }
+            else if (m_component[w] == undefined())
+            {
+              // w is on the scc stack
+              m_low[v] = std::min(m_low[v], m_index[w]);
+            }
+            continue;
+          }
+          dfs_stack.pop_back();
+          if (!dfs_stack.empty())
+          {
+            const std::size_t u = dfs_stack.back().first;
+            m_low[u] = std::min(m_low[u], m_low[v]);
+          }
+          if (m_low[v] == m_index[v])
+          {
+            std::size_t w;
+            do
+            {
+              w = scc_stack.back();
+              scc_stack.pop_back();
+              m_component[w] = v;
+            }
+            while (w != v);
+          }
+        }
+      }
+    }
+
+    // Removes vertices without predecessors or successors in the part of the graph that has not
+    // been removed yet. They form a component on their own. Returns the remaining vertices.
+    std::vector<std::size_t> trim()
+    {
+      const std::size_t n = m_graph.num_vertices();
+      std::vector<std::size_t> in_degree(n, 0);
+      std::vector<std::size_t> out_degree(n, 0);
+      std::vector<std::size_t> todo;
+      for (std::size_t v = 0; v < n; ++v)
+      {
+        for (const std::size_t* i = m_graph.successors_begin(v); i != m_graph.successors_end(v); ++i)
+        {
+          if (*i != v)
+          {
+            out_degree[v]++;
+            in_degree[*i]++;
+          }
+        }
+      }
+      for (std::size_t v = 0; v < n; ++v)
+      {
+        if (in_degree[v] == 0 || out_degree[v] == 0)
+        {
+          m_component[v] = v;
+          todo.push_back(v);
+        }
+      }
+      while (!todo.empty())
+      {
+        const std::size_t v = todo.back();
+        todo.pop_back();
+        for (const std::size_t* i = m_graph.successors_begin(v); i != m_graph.successors_end(v); ++i)
+        {
+          const std::size_t w = *i;
+          if (w != v && m_component[w] == undefined() && --in_degree[w] == 0)
+          {
+            m_component[w] = w;
+            todo.push_back(w);
+          }
+        }
+        for (const std::size_t* i = m_graph.predecessors_begin(v); i != m_graph.predecessors_end(v); ++i)
+        {
+          const std::size_t w = *i;
+          if (w != v && m_component[w] == undefined() && --out_degree[w] == 0)
+          {
+            m_component[w] = w;
+            todo.push_back(w);
+          }
+        }
+      }
+      std::vector<std::size_t> result;
+      for (std::size_t v = 0; v < n; ++v)
+      {
+        if (m_component[v] == undefined())
+        {
+          result.push_back(v);
+        }
+      }
+      return result;
+    }
+
+    std::size_t color(std::size_t v) const
+    {
+      return m_color[v].load(std::memory_order_relaxed);
+    }
+
+    void set_color(std::size_t v, std::size_t c)
+    {
+      m_color[v].store(c, std::memory_order_relaxed);
+    }
+
+    // Splits the vertices of t using the forward-backward algorithm, and returns the remaining tasks.
+    std::vector<task> forward_backward(const task& t)
+    {
+      if (t.vertices.size() < minimum_task_size())
+      {
+        const std::size_t c = t.color;
+        tarjan(t.vertices, [&](std::size_t v) { return color(v) == c; });
+        return {};
+      }
+
+      const std::size_t c = t.color;
+      const std::size_t forward_color = m_next_color++;
+      const std::size_t backward_color = m_next_color++;
+      const std::size_t pivot = t.vertices.front();
+
+      // Forward reachability from the pivot.
+      std::vector<std::size_t> todo = { pivot };
+      set_color(pivot, forward_color);
+      while (!todo.empty())
+      {
+        const std::size_t v = todo.back();
+        todo.pop_back();
+        for (const std::size_t* i = m_graph.successors_begin(v); i != m_graph.successors_end(v); ++i)
+        {
+          if (color(*i) == c)
+          {
+            set_color(*i, forward_color);
+            todo.push_back(*i);
+          }
+        }
+      }
+
+      // Backward reachability from the pivot. The vertices in both sets form the component of the pivot.
+      const std::size_t component_color = m_next_color++;
+      todo.push_back(pivot);
+      set_color(pivot, component_color);
+      while (!todo.empty())
+      {
+        const std::size_t v = todo.back();
+        todo.pop_back();
+        for (const std::size_t* i = m_graph.predecessors_begin(v); i != m_graph.predecessors_end(v); ++i)
+        {
+          const std::size_t w = *i;
+          if (color(w) == forward_color)
+          {
+            set_color(w, component_color);
+            todo.push_back(w);
+          }
+          else if (color(w) == c)
+          {
+            set_color(w, backward_color);
+            todo.push_back(w);
+          }
+        }
+      }
+
+      std::vector<task> result = { task{forward_color, {}}, task{backward_color, {}}, task{c, {}} };
+      for (std::size_t v: t.vertices)
+      {
+        const std::size_t cv = color(v);
+        if (cv == component_color)
+        {
+          m_component[v] = pivot;
+        }
+        else
+        {
+          result[cv == forward_color ? 0 : (cv == backward_color ? 1 : 2)].vertices.push_back(v);
+        }
+      }
+      result.erase(std::remove_if(result.begin(), result.end(), [](const task& t) { return t.vertices.empty(); }), result.end());
+      return result;
+    }
+
+    void run_parallel(std::size_t number_of_threads)
+    {
+      task initial_task{0, trim()};
+      if (initial_task.vertices.empty())
+      {
+        return;
+      }
+      for (std::size_t v = 0; v < m_graph.num_vertices(); ++v)
+      {
+        if (m_component[v] != undefined())
+        {
+          set_color(v, undefined());
+        }
+      }
+
+      std::mutex mutex;
+      std::condition_variable condition;
+      std::vector<task> tasks;
+      tasks.push_back(std::move(initial_task));
+      std::size_t busy = 0;
+
+      auto worker = [&]()
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true)
+        {
+          condition.wait(lock, [&]() { return !tasks.empty() || busy == 0; });
+          if (tasks.empty())
+          {
+            return;
+          }
+          task t = std::move(tasks.back());
+          tasks.pop_back();
+          busy++;
+          lock.unlock();
+          std::vector<task> new_tasks = forward_backward(t);
+          lock.lock();
+          busy--;
+          for (task& u: new_tasks)
+          {
+            tasks.push_back(std::move(u));
+          }
+          condition.notify_all();
+        }
+      };
+
+      std::vector<std::thread> threads;
+      for (std::size_t k = 1; k < number_of_threads; ++k)
+      {
+        threads.emplace_back(worker);
+      }
+      worker();
+      for (std::thread& t: threads)
+      {
+        t.join();
+      }
+    }
+
+  public:
+    /// \brief Computes the strongly connected components of g.
+    /// \param g A graph, which must stay alive during the lifetime of this object.
+    /// \param number_of_threads The number of threads that is used.
+    explicit scc_decomposition(const csr_graph& g, std::size_t number_of_threads = 1)
+      : m_graph(g),
+        m_component(g.num_vertices(), undefined()),
+        m_index(g.num_vertices(), 0),
+        m_low(g.num_vertices(), 0)
+    {
+      const std::size_t n = g.num_vertices();
+      if (number_of_threads <= 1)
+      {
+        std::vector<std::size_t> roots(n);
+        for (std::size_t v = 0; v < n; ++v)
+        {
+          roots[v] = v;
+        }
+        tarjan(roots, [](std::size_t) { return true; });
+      }
+      else
+      {
+        m_color = std::vector<std::atomic<std::size_t> >(n);
+        run_parallel(number_of_threads);
+        m_color.clear();
+      }
+      m_index.clear();
+      m_index.shrink_to_fit();
+      m_low.clear();
+      m_low.shrink_to_fit();
+
+      // Number the components in the order of their smallest vertex.
+      std::vector<std::size_t> number(n, undefined());
+      for (std::size_t v = 0; v < n; ++v)
+      {
+        std::size_t& k = number[m_component[v]];
+        if (k == undefined())
+        {
+          k = m_number_of_components++;
+          m_component_size.push_back(0);
+        }
+        m_component[v] = k;
+        m_component_size[k]++;
+      }
+
+      m_on_cycle.resize(m_number_of_components, false);
+      for (std::size_t v = 0; v < n; ++v)
+      {
+        const std::size_t k = m_component[v];
+        m_on_cycle[k] = m_on_cycle[k] || m_component_size[k] > 1 ||
+                        std::find(g.successors_begin(v), g.successors_end(v), v) != g.successors_end(v);
+      }
+    }
+
+    /// \brief Returns the number of components.
+    std::size_t num_components() const
+    {
+      return m_number_of_components;
+    }
+
+    /// \brief Returns the number of the component of v, which is in the range [0, num_components()).
+    std::size_t component(std::size_t v) const
+    {
+      return m_component[v];
+    }
+
+    /// \brief Returns the components of all vertices.
+    const std::vector<std::size_t>& components() const
+    {
+      return m_component;
+    }
+
+    /// \brief Returns true if v lies on a cycle, i.e., if its component has more than
+    /// one vertex, or if v has an edge to itself.
+    bool on_cycle(std::size_t v) const
+    {
+      return m_on_cycle[m_component[v]];
+    }
+};
+
+} // namespace detail
+} // namespace lts
+} // namespace mcrl2
+
+#endif // MCRL2_LTS_DETAIL_SCC_DECOMPOSITION_H
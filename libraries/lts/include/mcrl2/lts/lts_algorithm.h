@@ -34,15 +34,17 @@
 #include "mcrl2/lts/lts_utilities.h"
 #include "mcrl2/lts/detail/liblts_bisim.h"
 #include "mcrl2/lts/detail/liblts_bisim_gjkw.h"
+#include "mcrl2/lts/detail/liblts_bisim_parallel.h"
 #include "mcrl2/lts/detail/liblts_weak_bisim.h"
 #include "mcrl2/lts/detail/liblts_add_an_action_loop.h"
 #include "mcrl2/lts/detail/liblts_scc.h"
 #include "mcrl2/lts/detail/liblts_sim.h"
 #include "mcrl2/lts/detail/liblts_ready_sim.h"
+#include "mcrl2/lts/detail/liblts_sim_bit_matrix.h"
+#include "mcrl2/lts/detail/liblts_determinise.h"
 #include "mcrl2/lts/detail/liblts_failures_refinement.h"
 #include "mcrl2/lts/detail/liblts_tau_star_reduce.h"
 #include "mcrl2/utilities/exception.h"
-#include "mcrl2/lts/detail/tree_set.h"
 #include "mcrl2/lts/lts_equivalence.h"
 #include "mcrl2/lts/lts_preorder.h"
 #include "mcrl2/lts/sigref.h"
@@ -109,6 +111,10 @@ bool destructive_compare(LTS_TYPE& l1,
     {
       return detail::destructive_bisimulation_compare(l1,l2, false,false,generate_counter_examples);
     }
+    case lts_eq_bisim_parallel:
+    {
+      return detail::destructive_bisimulation_compare_parallel(l1,l2, false,false);
+    }
     case lts_eq_branching_bisim:
     {
       if (generate_counter_examples) 
@@ -122,6 +128,10 @@ bool destructive_compare(LTS_TYPE& l1,
     {
       return detail::destructive_bisimulation_compare(l1,l2, true,false,generate_counter_examples);
     }
+    case lts_eq_branching_bisim_parallel:
+    {
+      return detail::destructive_bisimulation_compare_parallel(l1,l2, true,false);
+    }
     case lts_eq_divergence_preserving_branching_bisim:
     {
       if (generate_counter_examples) 
@@ -135,6 +145,10 @@ bool destructive_compare(LTS_TYPE& l1,
     {
       return detail::destructive_bisimulation_compare(l1,l2, true,true,generate_counter_examples);
     }
+    case lts_eq_divergence_preserving_branching_bisim_parallel:
+    {
+      return detail::destructive_bisimulation_compare_parallel(l1,l2, true,true);
+    }
     case lts_eq_weak_bisim:
     {
       if (generate_counter_examples)
@@ -555,6 +569,11 @@ void reduce(LTS_TYPE& l,lts_equivalence eq)
       s.run();
       return;
     }
+    case lts_eq_bisim_parallel:
+    {
+      detail::bisimulation_reduce_parallel(l,false,false);
+      return;
+    }
     case lts_eq_branching_bisim:
     {
       detail::bisimulation_reduce_gjkw(l,true,false);
@@ -571,6 +590,11 @@ void reduce(LTS_TYPE& l,lts_equivalence eq)
       s.run();
       return;
     }
+    case lts_eq_branching_bisim_parallel:
+    {
+      detail::bisimulation_reduce_parallel(l,true,false);
+      return;
+    }
     case lts_eq_divergence_preserving_branching_bisim:
     {
       detail::bisimulation_reduce_gjkw(l,true,true);
@@ -587,6 +611,11 @@ void reduce(LTS_TYPE& l,lts_equivalence eq)
       s.run();
       return;
     }
+    case lts_eq_divergence_preserving_branching_bisim_parallel:
+    {
+      detail::bisimulation_reduce_parallel(l,true,true);
+      return;
+    }
     case lts_eq_weak_bisim:
     {
       detail::weak_bisimulation_reduce(l,false);
@@ -780,6 +809,16 @@ bool destructive_compare(LTS_TYPE& l1, LTS_TYPE& l2, const lts_preorder pre, con
 
       return rsp.in_preorder(l1.initial_state(),init_l2);
     }    
+    case lts_pre_sim_bit_matrix:
+    case lts_pre_ready_sim_bit_matrix:
+    {
+      const std::size_t init_l2 = l2.initial_state() + l1.num_states();
+      detail::merge(l1,l2);
+      l2.clear();
+
+      detail::sim_bit_matrix<LTS_TYPE> sbm(l1, pre==lts_pre_ready_sim_bit_matrix);
+      return sbm.in_preorder(l1.initial_state(),init_l2);
+    }
     case lts_pre_trace:
     {
       // Preprocessing: reduce modulo strong bisimulation equivalence.
@@ -889,115 +928,10 @@ bool is_deterministic(const LTS_TYPE& l)
 }
 
 
-namespace detail
-{
-inline
-void get_trans(std::multimap < transition::size_type, std::pair < transition::size_type, transition::size_type > > &begin,
-                      tree_set_store& tss,
-                      std::size_t d,
-                      std::vector<transition> &d_trans)
-{
-  if (!tss.is_set_empty(d))
-  {
-    if (tss.is_set_empty(tss.get_set_child_right(d)))
-    {
-      for (std::multimap < transition::size_type, std::pair < transition::size_type, transition::size_type > > :: const_iterator
-           j=begin.lower_bound(tss.get_set_child_left(d)); j!=begin.upper_bound(tss.get_set_child_left(d)); ++j)
-      {
-        d_trans.push_back(transition(j->first,j->second.first,j->second.second));
-      }
-    }
-    else
-    {
-      get_trans(begin,tss,tss.get_set_child_left(d),d_trans);
-      get_trans(begin,tss,tss.get_set_child_right(d),d_trans);
-    }
-  }
-}
-} // namespace detail
-
-
 template <class LTS_TYPE>
 void determinise(LTS_TYPE& l)
 {
-  tree_set_store tss;
-
-  std::vector<transition> d_transs;
-  std::vector<std::ptrdiff_t> d_states;
-
-  // create the initial state of the DLTS
-  d_states.push_back(l.initial_state());
-  std::ptrdiff_t d_id = tss.set_set_tag(tss.create_set(d_states));
-  d_states.clear();
-
-  std::multimap < transition::size_type, std::pair < transition::size_type, transition::size_type > >
-  begin=transitions_per_outgoing_state(l.get_transitions(),l.hidden_label_map());
-
-  l.clear_transitions();
-  l.clear_state_labels();
-  std::size_t d_ntransitions = 0;
-  std::vector < transition > d_transitions;
-
-  std::size_t s;
-  std::size_t i,to,lbl,n_t;
-
-  while (d_id < tss.get_next_tag())
-  {
-    // collect the outgoing transitions of every state of DLTS state d_id in
-    // the vector d_transs
-    detail::get_trans(begin,tss,tss.get_set(d_id),d_transs);
-
-    // sort d_transs by label and (if labels are equal) by destination
-    const detail::compare_transitions_lts compare(l.hidden_label_map());
-    sort(d_transs.begin(),d_transs.end(),compare);
-
-    n_t = d_transs.size();
-    i = 0;
-    for (lbl = 0; lbl < l.num_action_labels(); ++lbl)
-    {
-      // compute the destination of the transition with label lbl
-      while (i < n_t && l.apply_hidden_label_map(d_transs[i].label()) < lbl)
-      {
-        ++i;
-      }
-      while (i < n_t && l.apply_hidden_label_map(d_transs[i].label()) == lbl)
-      {
-        to = d_transs[i].to();
-        d_states.push_back(to);
-        while (i < n_t && l.apply_hidden_label_map(d_transs[i].label()) == lbl &&
-               d_transs[i].to() == to)
-        {
-          ++i;
-        }
-      }
-      s = tss.create_set(d_states);
-
-      // generate the transitions to each of the next states
-      if (!tss.is_set_empty(s))
-      {
-        d_transitions.push_back(transition(d_id,lbl,tss.set_set_tag(s)));
-
-        if (d_ntransitions%10000 == 0)
-        {
-          mCRL2log(log::debug) <<
-            "generated " << tss.get_next_tag() << " states and " << d_ntransitions
-                         << " transitions; explored " << d_id << " states" << std::endl;
-        }
-      }
-      d_states.clear();
-    }
-    d_transs.clear();
-    ++d_id;
-  }
-
-
-  l.set_num_states(d_id,false); // remove the state values, and reset the number of states.
-  l.set_initial_state(0);
-
-  for (const transition& t: d_transitions)
-  {
-    l.add_transition(t);
-  }
+  detail::subset_construction(l);
   assert(is_deterministic(l));
 }
 
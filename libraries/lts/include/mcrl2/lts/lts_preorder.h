@@ -40,8 +40,10 @@ enum lts_preorder
   lts_pre_failures_refinement,    /**< Failures refinement based on anti chains */
   lts_pre_weak_failures_refinement, /**< Weak failures refinement based on anti chains */
   lts_pre_failures_divergence_refinement, /**< Failures divergence refinement based on anti chains, which is automatically weak */
+  lts_pre_sim_bit_matrix,    /**< Strong simulation preorder computed with a bit matrix */
+  lts_pre_ready_sim_bit_matrix,    /**< Strong ready simulation preorder computed with a bit matrix */
   lts_preorder_min = lts_pre_none,
-  lts_preorder_max = lts_pre_failures_divergence_refinement
+  lts_preorder_max = lts_pre_ready_sim_bit_matrix
 };
 
 /** \brief Determines the preorder from a string.
@@ -96,6 +98,14 @@ lts_preorder parse_preorder(std::string const& s)
   {
     return lts_pre_failures_divergence_refinement;
   }
+  else if (s == "sim-bitmatrix")
+  {
+    return lts_pre_sim_bit_matrix;
+  }
+  else if (s == "ready-sim-bitmatrix")
+  {
+    return lts_pre_ready_sim_bit_matrix;
+  }
   else
   {
     throw mcrl2::runtime_error("unknown preorder " + s);
@@ -149,6 +159,10 @@ std::string print_preorder(const lts_preorder pre)
       return "weak-failures";
     case lts_pre_failures_divergence_refinement:
       return "failures-divergence";
+    case lts_pre_sim_bit_matrix:
+      return "sim-bitmatrix";
+    case lts_pre_ready_sim_bit_matrix:
+      return "ready-sim-bitmatrix";
     default:
       throw mcrl2::runtime_error("unknown preorder");
   }
@@ -190,6 +204,10 @@ std::string description(const lts_preorder pre)
       return "weak failures refinement";
     case lts_pre_failures_divergence_refinement:
       return "failures divergence refinement (automatically weak)";
+    case lts_pre_sim_bit_matrix:
+      return "strong simulation preorder, using a bit matrix and multiple threads";
+    case lts_pre_ready_sim_bit_matrix:
+      return "strong ready simulation preorder, using a bit matrix and multiple threads";
     default:
       throw mcrl2::runtime_error("unknown preorder");
   }
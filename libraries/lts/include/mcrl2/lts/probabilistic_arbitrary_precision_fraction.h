@@ -25,6 +25,7 @@
 #include <cassert>
 #include <sstream>
 #include <limits>
+#include <utility>
 #include "mcrl2/utilities/hash_utility.h"
 #include "mcrl2/utilities/big_numbers.h"
 
@@ -63,6 +64,136 @@ class probabilistic_arbitrary_precision_fraction
       return buffer;
     }
 
+    // Most fractions have an enumerator and denominator that fit in a machine word. For those the
+    // operations below are done on machine words, as long as the results do not overflow.
+    bool has_machine_numbers(const probabilistic_arbitrary_precision_fraction& other) const
+    {
+      return m_enumerator.is_machine_number() && m_denominator.is_machine_number() &&
+             other.m_enumerator.is_machine_number() && other.m_denominator.is_machine_number();
+    }
+
+    // Returns the product x*y as a pair of machine words, the most significant word first.
+    static std::pair<std::size_t, std::size_t> multiply_machine_numbers(const std::size_t x, const std::size_t y)
+    {
+      std::size_t high=0;
+      const std::size_t low=utilities::detail::multiply_single_number(x,y,high);
+      return std::make_pair(high,low);
+    }
+
+    static std::size_t count_trailing_zeros(std::size_t x)
+    {
+      assert(x!=0);
+#if defined(__GNUC__) || defined(__clang__)
+      return __builtin_ctzll(x);
+#else
+      std::size_t result=0;
+      for( ; (x & 1)==0; x>>=1)
+      {
+        ++result;
+      }
+      return result;
+#endif
+    }
+
+    // The binary greatest common divisor algorithm of Stein, which avoids divisions.
+    static std::size_t machine_greatest_common_divisor(std::size_t x, std::size_t y)
+    {
+      if (x==0) { return y; }
+      if (y==0) { return x; }
+      const std::size_t shift=count_trailing_zeros(x | y);
+      x>>=count_trailing_zeros(x);
+      do
+      {
+        y>>=count_trailing_zeros(y);
+        if (x>y)
+        {
+          std::swap(x,y);
+        }
+        y=y-x;
+      }
+      while (y!=0);
+      return x<<shift;
+    }
+
+    // Returns the fraction enumerator/denominator without common factors.
+    static probabilistic_arbitrary_precision_fraction machine_fraction(const std::size_t enumerator, const std::size_t denominator)
+    {
+      assert(denominator>0);
+      const std::size_t gcd=machine_greatest_common_divisor(enumerator,denominator);
+      return probabilistic_arbitrary_precision_fraction(utilities::big_natural_number(enumerator/gcd),
+                                                        utilities::big_natural_number(denominator/gcd));
+    }
+
+    // Compares this->m_enumerator*other.m_denominator with other.m_enumerator*this->m_denominator.
+    // The result is negative, zero or positive if the first is smaller, equal or larger, respectively.
+    int compare_machine_numbers(const probabilistic_arbitrary_precision_fraction& other) const
+    {
+      const std::pair<std::size_t, std::size_t> x=multiply_machine_numbers(std::size_t(m_enumerator),std::size_t(other.m_denominator));
+      const std::pair<std::size_t, std::size_t> y=multiply_machine_numbers(std::size_t(other.m_enumerator),std::size_t(m_denominator));
+      return x<y ? -1 : (y<x ? 1 : 0);
+    }
+
+    // Calculates this+other, or this-other if subtract is true, on machine words. Returns false
+    // if the result does not fit in machine words.
+    bool add_machine_numbers(const probabilistic_arbitrary_precision_fraction& other,
+                             const bool subtract,
+                             probabilistic_arbitrary_precision_fraction& result) const
+    {
+      const std::size_t b=std::size_t(m_denominator);
+      const std::size_t d=std::size_t(other.m_denominator);
+      const std::size_t gcd=machine_greatest_common_divisor(b,d);
+      const std::pair<std::size_t, std::size_t> denominator=multiply_machine_numbers(b/gcd,d);
+      const std::pair<std::size_t, std::size_t> x=multiply_machine_numbers(std::size_t(m_enumerator),d/gcd);
+      const std::pair<std::size_t, std::size_t> y=multiply_machine_numbers(std::size_t(other.m_enumerator),b/gcd);
+      if (denominator.first!=0 || x.first!=0 || y.first!=0)
+      {
+        return false;
+      }
+      if (subtract)
+      {
+        if (x.second<y.second)
+        {
+          return false;
+        }
+        result=machine_fraction(x.second-y.second,denominator.second);
+        return true;
+      }
+      const std::size_t enumerator=x.second+y.second;
+      if (enumerator<x.second)
+      {
+        return false;
+      }
+      result=machine_fraction(enumerator,denominator.second);
+      return true;
+    }
+
+    // Calculates (a/b)*(c/d) on machine words, where common factors of a and d, and of c and b, are
+    // removed first. Returns false if the result does not fit in machine words.
+    static bool multiply_machine_fractions(std::size_t a, std::size_t b, std::size_t c, std::size_t d,
+                                           probabilistic_arbitrary_precision_fraction& result)
+    {
+      const std::size_t gcd_ad=machine_greatest_common_divisor(a,d);
+      if (gcd_ad>1)
+      {
+        a=a/gcd_ad;
+        d=d/gcd_ad;
+      }
+      const std::size_t gcd_cb=machine_greatest_common_divisor(c,b);
+      if (gcd_cb>1)
+      {
+        c=c/gcd_cb;
+        b=b/gcd_cb;
+      }
+      const std::pair<std::size_t, std::size_t> enumerator=multiply_machine_numbers(a,c);
+      const std::pair<std::size_t, std::size_t> denominator=multiply_machine_numbers(b,d);
+      if (enumerator.first!=0 || denominator.first!=0 || denominator.second==0)
+      {
+        return false;
+      }
+      result=machine_fraction(enumerator.second,denominator.second);
+      return true;
+    }
+
   public:
 
     /// \brief Constant zero.
@@ -124,6 +255,10 @@ class probabilistic_arbitrary_precision_fraction
     */
     bool operator==(const probabilistic_arbitrary_precision_fraction& other) const
     {
+      if (has_machine_numbers(other))
+      {
+        return compare_machine_numbers(other)==0;
+      }
       // return this->m_enumerator*other.m_denominator==other.m_enumerator*this->m_denominator;
       buffer1().clear();
       this->m_enumerator.multiply(other.m_denominator, buffer1(), buffer3());
@@ -143,6 +278,10 @@ class probabilistic_arbitrary_precision_fraction
     */
     bool operator<(const probabilistic_arbitrary_precision_fraction& other) const
     {
+      if (has_machine_numbers(other))
+      {
+        return compare_machine_numbers(other)<0;
+      }
       // return this->m_enumerator*other.m_denominator<other.m_enumerator*this->m_denominator;
       buffer1().clear();
       this->m_enumerator.multiply(other.m_denominator, buffer1(), buffer3());
@@ -176,6 +315,12 @@ class probabilistic_arbitrary_precision_fraction
      */
     probabilistic_arbitrary_precision_fraction operator+(const probabilistic_arbitrary_precision_fraction& other) const
     {
+      probabilistic_arbitrary_precision_fraction result;
+      if (has_machine_numbers(other) && add_machine_numbers(other,false,result))
+      {
+        return result;
+      }
+
       /* utilities::big_natural_number enumerator=this->enumerator()*other.denominator() +
                                                other.enumerator()*this->denominator();
       utilities::big_natural_number denominator=this->denominator()*other.denominator();
@@ -197,6 +342,12 @@ class probabilistic_arbitrary_precision_fraction
      */
     probabilistic_arbitrary_precision_fraction operator-(const probabilistic_arbitrary_precision_fraction& other) const
     {
+      probabilistic_arbitrary_precision_fraction result;
+      if (has_machine_numbers(other) && add_machine_numbers(other,true,result))
+      {
+        return result;
+      }
+
       /* utilities::big_natural_number enumerator= this->enumerator()*other.denominator() -
                                     other.enumerator()*this->denominator();
       utilities::big_natural_number denominator=this->denominator()*other.denominator();
@@ -218,6 +369,14 @@ class probabilistic_arbitrary_precision_fraction
      */
     probabilistic_arbitrary_precision_fraction operator*(const probabilistic_arbitrary_precision_fraction& other) const
     {
+      probabilistic_arbitrary_precision_fraction result;
+      if (has_machine_numbers(other) &&
+          multiply_machine_fractions(std::size_t(m_enumerator),std::size_t(m_denominator),
+                                     std::size_t(other.m_enumerator),std::size_t(other.m_denominator),result))
+      {
+        return result;
+      }
+
       /* utilities::big_natural_number enumerator= this->enumerator()*other.enumerator();
       utilities::big_natural_number denominator=this->denominator()*other.denominator();
       remove_common_factors(enumerator,denominator);
@@ -235,6 +394,14 @@ class probabilistic_arbitrary_precision_fraction
      */
     probabilistic_arbitrary_precision_fraction operator/(const probabilistic_arbitrary_precision_fraction& other) const
     {
+      probabilistic_arbitrary_precision_fraction result;
+      if (has_machine_numbers(other) &&
+          multiply_machine_fractions(std::size_t(m_enumerator),std::size_t(m_denominator),
+                                     std::size_t(other.m_denominator),std::size_t(other.m_enumerator),result))
+      {
+        return result;
+      }
+
       /* assert(other>probabilistic_arbitrary_precision_fraction::zero());
       utilities::big_natural_number enumerator= this->enumerator()*other.denominator();
       utilities::big_natural_number denominator=this->denominator()*other.enumerator();
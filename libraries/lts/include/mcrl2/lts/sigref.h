@@ -19,6 +19,7 @@
 #include <iostream>
 #include "mcrl2/lts/lts.h"
 #include "mcrl2/lts/lts_utilities.h"
+#include "mcrl2/lts/detail/scc_decomposition.h"
 #include "mcrl2/utilities/logger.h"
 
 namespace mcrl2
@@ -194,93 +195,20 @@ protected:
   /** \brief Record for each vertex whether it is in a tau-scc */
   std::vector<bool> m_divergent;
 
-  /** \brief Iterative implementation of Tarjan's SCC algorithm.
-   *
-   * based on an earlier implementation by Sjoerd Cranen
+  /** \brief Records for each state whether it is on a tau loop.
    *
    * For the non-trivial tau-sccs (i.e. SCCs with more than one state, or
-   * single-state SCCs with a tau-loop, we set \a m_divergent to true.
+   * single-state SCCs with a tau-loop, we set \a m_divergent to true for all
+   * states of the scc.
    */
   void compute_tau_sccs()
   {
-    std::size_t unused = 1, lastscc = 1;
-    std::vector<std::size_t> scc(m_lts.num_states(), 0);
-	  std::vector<std::size_t> low(m_lts.num_states(), 0);
-	  std::stack<std::size_t> stack;
-	  std::stack<std::size_t> sccstack;
-
-    // Record forward transition relation sorted by state.
-	  outgoing_transitions_per_state_t m_lts_succ_transitions(transitions_per_outgoing_state(m_lts.get_transitions(),m_lts.hidden_label_map()));
-
-	  for (std::size_t i = 0; i < m_lts.num_states(); ++i)
-	  {
-		  if (scc[i] == 0)
-			  stack.push(i);
-		  while (!stack.empty())
-		  {
-			  std::size_t vi = stack.top();
-
-        // Outgoing transitions of vi.
-        std::pair<outgoing_transitions_per_state_t::const_iterator, outgoing_transitions_per_state_t::const_iterator> succ_range
-          = m_lts_succ_transitions.equal_range(vi);
-
-			  if (low[vi] == 0 && scc[vi] == 0)
-			  {
-				  scc[vi] = unused;
-				  low[vi] = unused++;
-				  sccstack.push(vi);
-
-				  for (outgoing_transitions_per_state_t::const_iterator t = succ_range.first; t != succ_range.second; ++t)
-				  {
-            if ((low[to(t)] == 0) && (scc[to(t)] == 0) && (m_lts.is_tau(label(t))))
-					  {
-						  stack.push(to(t));
-						}
-				  }
-			  }
-			  else
-			  {
-				  for (outgoing_transitions_per_state_t::const_iterator t = succ_range.first; t != succ_range.second; ++t)
-				  {
-					  if ((low[to(t)] != 0) && (m_lts.is_tau(label(t))))
-						  low[vi] = low[vi] < low[to(t)] ? low[vi] : low[to(t)];
-				  }
-				  if (low[vi] == scc[vi])
-				  {
-					  std::size_t tos, scc_id = lastscc++;
-            std::vector<std::size_t> this_scc;
-					  do
-					  {
-						  tos = sccstack.top();
-						  low[tos] = 0;
-						  scc[tos] = scc_id;
-						  sccstack.pop();
-              this_scc.push_back(tos);
-					  }
-					  while (tos != vi);
-
-            // We only consider non-trivial sccs, hence
-            // if the scc consists of a single schate, check whether it has a tau-loop
-            if(this_scc.size() == 1)
-            {
-              for(outgoing_transitions_per_state_t::const_iterator i = succ_range.first; i != succ_range.second; ++i)
-              {
-                if(from(i) == to(i) && m_lts.is_tau(label(i)))
-                {
-                  m_divergent[tos] = true;
-                  break;
-                }
-              }
-            }
-            else
-            {
-              m_divergent[tos] = true;
-            }
-				  }
-				  stack.pop();
-			  }
-		  }
-	  }
+    const detail::csr_graph g = detail::tau_graph(m_lts);
+    const detail::scc_decomposition sccs(g);
+    for (std::size_t i = 0; i < m_lts.num_states(); ++i)
+    {
+      m_divergent[i] = sccs.on_cycle(i);
+    }
   }
 
 public:
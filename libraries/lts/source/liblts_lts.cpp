@@ -50,6 +50,18 @@ static atermpp::function_symbol lts_header()
   return lts;
 }
 
+static atermpp::function_symbol columnar_lts_header()
+{
+  static atermpp::function_symbol lts("labelled_transition_system_columnar",4);
+  return lts;
+}
+
+static atermpp::function_symbol columnar_transitions_header()
+{
+  static atermpp::function_symbol tr("columnar_transitions",3);
+  return tr;
+}
+
 static atermpp::function_symbol meta_data_header()
 {
   static atermpp::function_symbol mdh("meta_data_header",4);
@@ -128,6 +140,60 @@ class aterm_probabilistic_transition_list: public aterm_appl
     }
 };
 
+/// \brief The transitions of an lts in the columnar format.
+/// \details Only the number of transitions and the probabilistic target states are stored as an aterm.
+///          The transitions themselves follow the aterm in the stream as a binary block, consisting of
+///          three varint encoded columns with the sources, labels and targets of the transitions.
+///          If the list of probabilistic states is empty, the targets are plain states, i.e., the
+///          probabilistic state with index i is the state i with probability one.
+class aterm_columnar_transitions: public aterm_appl
+{
+  public:
+    aterm_columnar_transitions(const std::size_t num_transitions,
+                               const std::size_t num_probabilistic_states,
+                               const aterm_list& probabilistic_states)
+      : aterm_appl(columnar_transitions_header(),
+                   aterm_int(num_transitions),
+                   aterm_int(num_probabilistic_states),
+                   probabilistic_states)
+    {}
+
+    std::size_t num_transitions() const
+    {
+      return (atermpp::down_cast<aterm_int>((*this)[0]).value());
+    }
+
+    std::size_t num_probabilistic_states() const
+    {
+      return (atermpp::down_cast<aterm_int>((*this)[1]).value());
+    }
+
+    const aterm_list& probabilistic_states() const
+    {
+      return atermpp::down_cast<aterm_list>((*this)[2]);
+    }
+};
+
+// Apply f to all probabilistic states in a columnar transitions term. The list of probabilistic
+// states can be too long to be traversed recursively, hence it is rebuilt element by element.
+template <class Function>
+static aterm_appl apply_to_columnar_transitions(const aterm_appl& trans, Function f)
+{
+  const aterm_columnar_transitions& t=atermpp::down_cast<aterm_columnar_transitions>(trans);
+  std::vector<aterm> states;
+  states.reserve(t.num_probabilistic_states());
+  for(const aterm& s: t.probabilistic_states())
+  {
+    states.push_back(f(s));
+  }
+  aterm_list result;
+  for(std::vector<aterm>::const_reverse_iterator i=states.rbegin(); i!=states.rend(); ++i)
+  {
+    result.push_front(*i);
+  }
+  return aterm_columnar_transitions(t.num_transitions(), t.num_probabilistic_states(), result);
+}
+
 // typedef term_list<aterm_probabilistic_transition> aterm_transition_list;
 typedef term_list<state_label_lts> state_labels_t;               // The state labels listed consecutively.
 typedef term_list<atermpp::aterm_appl> action_labels_t;          // A multiaction has the shape "multi_action(action_list,data_expression)
@@ -162,10 +228,48 @@ class aterm_labelled_transition_system: public atermpp::aterm_appl
                   )
     {}
 
+    aterm_labelled_transition_system(
+               const probabilistic_lts_lts_t& ts,
+               const aterm_columnar_transitions& transitions,
+               const state_labels_t& state_label_list,
+               const action_labels_t& action_label_list)
+      : aterm_appl(columnar_lts_header(),
+                   aterm_appl(meta_data_header(),
+                              data::detail::data_specification_to_aterm(ts.data()),
+                              ts.process_parameters(),
+                              ts.action_label_declarations(),
+                              aterm_appl(num_of_states_labels_and_initial_state(),
+                                         aterm_int(ts.num_states()),
+                                         aterm_int(ts.num_action_labels()),
+                                         state_probability_list(ts.initial_probabilistic_state()))),
+                   transitions,
+                   state_label_list,
+                   action_label_list
+                  )
+    {}
+
+    /// \brief Indicates whether the transitions are stored in columnar format after this term.
+    bool is_columnar() const
+    {
+      return function()==columnar_lts_header();
+    }
+
     // \brief add_index() adds a unique index to some term types, such as variables, to access data about them 
     //        quickly. When loading a term, these indices must first be added before a term can be used in the toolset.
     void add_indices()
     {
+      if (is_columnar())
+      {
+        std::unordered_map<atermpp::aterm_appl, atermpp::aterm> cache;
+        *this = aterm_appl(columnar_lts_header(),
+                           data::detail::add_index(meta_data(),cache),
+                           apply_to_columnar_transitions(columnar_transitions(),
+                                  [&cache](const aterm& t) { return data::detail::add_index(t,cache); }),
+                           data::detail::add_index(get_state_labels(),cache),
+                           data::detail::add_index(get_action_label_declarations(),cache));
+        return;
+      }
+
       aterm_appl md=meta_data();
       aterm_probabilistic_transition_list trans=transitions(); 
       state_labels_t state_labels=get_state_labels();
@@ -199,6 +303,18 @@ class aterm_labelled_transition_system: public atermpp::aterm_appl
     /// \brief Remove indices from dedicated terms such as variables and process names. 
     void remove_indices()
     {
+      if (is_columnar())
+      {
+        std::unordered_map<atermpp::aterm_appl, atermpp::aterm> cache;
+        *this = aterm_appl(columnar_lts_header(),
+                           data::detail::remove_index(meta_data(),cache),
+                           apply_to_columnar_transitions(columnar_transitions(),
+                                  [&cache](const aterm& t) { return data::detail::remove_index(t,cache); }),
+                           data::detail::remove_index(get_state_labels(),cache),
+                           data::detail::remove_index(get_action_label_declarations(),cache));
+        return;
+      }
+
       aterm_appl md=meta_data();
       aterm_probabilistic_transition_list trans=transitions(); 
       state_labels_t state_labels=get_state_labels();
@@ -269,6 +385,12 @@ class aterm_labelled_transition_system: public atermpp::aterm_appl
     {
       return down_cast<aterm_probabilistic_transition_list>((*this)[1]);
     }
+
+    const aterm_columnar_transitions& columnar_transitions() const
+    {
+      assert(is_columnar());
+      return down_cast<aterm_columnar_transitions>((*this)[1]);
+    }
   
     state_labels_t get_state_labels() const
     {
@@ -289,53 +411,194 @@ class aterm_labelled_transition_system: public atermpp::aterm_appl
     }
 };
 
-static void read_from_lts(probabilistic_lts_lts_t& l, const std::string& filename)
+// The columnar transition format. The sources, labels and targets of the transitions are
+// written as three consecutive columns. Each column is preceded by its size in bytes, and
+// contains one unsigned LEB128 varint per transition. The sources are delta encoded with respect
+// to the source of the previous transition, and the targets with respect to the source of the
+// same transition. As these deltas can be negative, they are zigzag encoded.
+
+static void write_varint(std::size_t n, std::vector<unsigned char>& buffer)
 {
-  aterm input;
-  if (filename=="")
+  while (n>=0x80)
   {
-    input=read_term_from_binary_stream(std::cin);
+    buffer.push_back(static_cast<unsigned char>((n & 0x7f) | 0x80));
+    n=n>>7;
   }
-  else 
+  buffer.push_back(static_cast<unsigned char>(n));
+}
+
+static std::size_t read_varint(const unsigned char*& p, const unsigned char* end)
+{
+  std::size_t result=0;
+  for(std::size_t shift=0; p!=end && shift<8*sizeof(std::size_t); shift=shift+7)
   {
-    std::ifstream stream;
-    stream.exceptions ( std::ifstream::failbit | std::ifstream::badbit );
-    try
-    {  
-      stream.open(filename, std::ifstream::in | std::ifstream::binary);
+    const unsigned char c=*p++;
+    result=result | (static_cast<std::size_t>(c & 0x7f) << shift);
+    if ((c & 0x80)==0)
+    {
+      return result;
     }
-    catch (std::ifstream::failure)
+  }
+  throw mcrl2::runtime_error("The transitions in the input are not in proper columnar .lts format.");
+}
+
+static std::size_t zigzag_encode(const std::size_t from, const std::size_t to)
+{
+  return to>=from?(to-from)<<1:((from-to)<<1)-1;
+}
+
+static std::size_t zigzag_decode(const std::size_t from, const std::size_t delta)
+{
+  return (delta & 1)==0?from+(delta>>1):from-((delta+1)>>1);
+}
+
+static void write_column(const std::vector<unsigned char>& column, std::ostream& os)
+{
+  std::vector<unsigned char> size;
+  write_varint(column.size(), size);
+  os.write(reinterpret_cast<const char*>(size.data()), size.size());
+  os.write(reinterpret_cast<const char*>(column.data()), column.size());
+}
+
+static void read_column(std::vector<unsigned char>& column, std::istream& is)
+{
+  std::size_t size=0;
+  for(std::size_t shift=0; ; shift=shift+7)
+  {
+    const int c=is.get();
+    if (c==EOF || shift>=8*sizeof(std::size_t))
     {
-      if (filename=="")
-      {
-        throw mcrl2::runtime_error("Fail to open standard input to read an lts.");
-      }
-      else 
-      {
-        throw mcrl2::runtime_error("Fail to open file " + filename + " to read an lts.");
-      }
+      throw mcrl2::runtime_error("The transitions in the input are truncated.");
     }
+    size=size | (static_cast<std::size_t>(c & 0x7f) << shift);
+    if ((c & 0x80)==0)
+    {
+      break;
+    }
+  }
+  column.resize(size);
+  is.read(reinterpret_cast<char*>(column.data()), size);
+  if (static_cast<std::size_t>(is.gcount())!=size)
+  {
+    throw mcrl2::runtime_error("The transitions in the input are truncated.");
+  }
+}
 
-    try
+static void write_transition_columns(const probabilistic_lts_lts_t& l, std::ostream& os)
+{
+  // The columns are encoded and written one at a time, to limit the size of the buffer.
+  std::vector<unsigned char> column;
+  column.reserve(l.num_transitions());
+
+  std::size_t previous_from=0;
+  for(const transition& t: l.get_transitions())
+  {
+    write_varint(zigzag_encode(previous_from, t.from()), column);
+    previous_from=t.from();
+  }
+  write_column(column, os);
+
+  column.clear();
+  for(const transition& t: l.get_transitions())
+  {
+    write_varint(l.apply_hidden_label_map(t.label()), column);
+  }
+  write_column(column, os);
+
+  column.clear();
+  for(const transition& t: l.get_transitions())
+  {
+    write_varint(zigzag_encode(t.from(), t.to()), column);
+  }
+  write_column(column, os);
+}
+
+static void read_transition_columns(probabilistic_lts_lts_t& l, const std::size_t num_transitions, std::istream& is)
+{
+  std::vector<unsigned char> column;
+  l.clear_transitions(num_transitions);
+
+  read_column(column, is);
+  const unsigned char* p=column.data();
+  const unsigned char* end=p+column.size();
+  std::size_t from=0;
+  for(std::size_t i=0; i<num_transitions; ++i)
+  {
+    from=zigzag_decode(from, read_varint(p, end));
+    l.add_transition(transition(from, 0, 0));
+  }
+
+  read_column(column, is);
+  p=column.data();
+  end=p+column.size();
+  for(transition& t: l.get_transitions())
+  {
+    t.set_label(read_varint(p, end));
+  }
+
+  read_column(column, is);
+  p=column.data();
+  end=p+column.size();
+  for(transition& t: l.get_transitions())
+  {
+    t.set_to(zigzag_decode(t.from(), read_varint(p, end)));
+  }
+}
+
+// Returns true if the probabilistic state with index i is the plain state i, for all i.
+// In that case the probabilistic states do not have to be stored.
+static bool probabilistic_states_are_plain_states(const probabilistic_lts_lts_t& l)
+{
+  for(std::size_t i=0; i<l.num_probabilistic_states(); ++i)
+  {
+    const probabilistic_lts_lts_t::probabilistic_state_t& s=l.probabilistic_state(i);
+    if (s.size()!=1 || s.begin()->state()!=i)
     {
-      input=atermpp::read_term_from_binary_stream(stream);
-      stream.close();
+      return false;
     }
-    catch (std::ifstream::failure)
+  }
+  return true;
+}
+
+static aterm_columnar_transitions columnar_transitions(const probabilistic_lts_lts_t& l)
+{
+  aterm_list probabilistic_states;
+  if (!probabilistic_states_are_plain_states(l))
+  {
+    for(std::size_t i=l.num_probabilistic_states(); i>0;)
     {
-      if (filename=="")
-      {
-        throw mcrl2::runtime_error("Fail to correctly read an lts from standard input.");
-      }
-      else
-      {
-        throw mcrl2::runtime_error("Fail to correctly read an lts from the file " + filename + ".");
-      }
+      --i;
+      probabilistic_states.push_front(state_probability_list(l.probabilistic_state(i)));
+    }
+  }
+  return aterm_columnar_transitions(l.num_transitions(), l.num_probabilistic_states(), probabilistic_states);
+}
+
+static void add_columnar_probabilistic_states(probabilistic_lts_lts_t& l, const aterm_columnar_transitions& transitions)
+{
+  if (transitions.probabilistic_states().empty())
+  {
+    for(std::size_t i=0; i<transitions.num_probabilistic_states(); ++i)
+    {
+      l.add_probabilistic_state(probabilistic_lts_lts_t::probabilistic_state_t(i));
+    }
+  }
+  else
+  {
+    assert(transitions.num_probabilistic_states()==transitions.probabilistic_states().size());
+    for(const aterm& s: transitions.probabilistic_states())
+    {
+      l.add_probabilistic_state(aterm_list_to_probabilistic_state(down_cast<aterm_list>(s)));
     }
-    
   }
+}
+
+static void read_from_lts(probabilistic_lts_lts_t& l, std::istream& is, const std::string& filename)
+{
+  aterm input=read_term_from_binary_stream(is);
 
-  if (!input.type_is_appl() || down_cast<aterm_appl>(input).function()!=lts_header())
+  if (!input.type_is_appl() || (down_cast<aterm_appl>(input).function()!=lts_header() &&
+                                down_cast<aterm_appl>(input).function()!=columnar_lts_header()))
   {
     throw runtime_error("The input file " + filename + " is not in proper .lts format.");
   }
@@ -357,13 +620,21 @@ static void read_from_lts(probabilistic_lts_lts_t& l, const std::string& filenam
 
   l.set_action_label_declarations(input_lts.action_label_declarations());
   
-  aterm_probabilistic_transition_list input_transitions=input_lts.transitions();
-  while (input_transitions.function()!= transition_empty_header()) 
+  if (input_lts.is_columnar())
   {
-    assert(input_transitions.function()==transition_list_header());
-    const std::size_t prob_state_index=l.add_probabilistic_state(input_transitions.target());
-    l.add_transition(transition(input_transitions.source(), input_transitions.label(), prob_state_index));
-    input_transitions=input_transitions.next();
+    add_columnar_probabilistic_states(l, input_lts.columnar_transitions());
+    read_transition_columns(l, input_lts.columnar_transitions().num_transitions(), is);
+  }
+  else
+  {
+    aterm_probabilistic_transition_list input_transitions=input_lts.transitions();
+    while (input_transitions.function()!= transition_empty_header()) 
+    {
+      assert(input_transitions.function()==transition_list_header());
+      const std::size_t prob_state_index=l.add_probabilistic_state(input_transitions.target());
+      l.add_transition(transition(input_transitions.source(), input_transitions.label(), prob_state_index));
+      input_transitions=input_transitions.next();
+    }
   }
   
   if (input_lts.get_state_labels().size()==0)
@@ -399,21 +670,39 @@ static void read_from_lts(probabilistic_lts_lts_t& l, const std::string& filenam
   l.set_initial_probabilistic_state(input_lts.initial_probabilistic_state());
 }
 
-static void write_to_lts(const probabilistic_lts_lts_t& l, const std::string& filename)
+static void read_from_lts(probabilistic_lts_lts_t& l, const std::string& filename)
 {
-  aterm_probabilistic_transition_list transitions;
-  
-  for(std::vector<transition>::const_reverse_iterator i=l.get_transitions().rbegin();
-                i!=l.get_transitions().rend(); ++i)
+  if (filename=="")
   {
-    // The transitions are stored in reverse order.
-    transitions=aterm_probabilistic_transition_list(
-                                i->from(), 
-                                l.apply_hidden_label_map(i->label()), 
-                                l.probabilistic_state(i->to()),
-                                transitions);
+    read_from_lts(l, std::cin, filename);
   }
+  else 
+  {
+    std::ifstream stream;
+    stream.exceptions ( std::ifstream::failbit | std::ifstream::badbit );
+    try
+    {  
+      stream.open(filename, std::ifstream::in | std::ifstream::binary);
+    }
+    catch (std::ifstream::failure)
+    {
+      throw mcrl2::runtime_error("Fail to open file " + filename + " to read an lts.");
+    }
 
+    try
+    {
+      read_from_lts(l, stream, filename);
+      stream.close();
+    }
+    catch (std::ifstream::failure)
+    {
+      throw mcrl2::runtime_error("Fail to correctly read an lts from the file " + filename + ".");
+    }
+  }
+}
+
+static void write_to_lts(const probabilistic_lts_lts_t& l, std::ostream& os)
+{
   state_labels_t state_label_list;
   if (l.has_state_info())
   { for(std::size_t i=l.num_state_labels(); i>0;)
@@ -434,14 +723,20 @@ static void write_to_lts(const probabilistic_lts_lts_t& l, const std::string& fi
   }
 
   aterm_labelled_transition_system t0(l,
-                                      transitions,
+                                      columnar_transitions(l),
                                       state_label_list,
                                       action_label_list);
   t0.remove_indices();
 
+  atermpp::write_term_to_binary_stream(t0, os);
+  write_transition_columns(l, os);
+}
+
+static void write_to_lts(const probabilistic_lts_lts_t& l, const std::string& filename)
+{
   if (filename=="")
   {
-    atermpp::write_term_to_binary_stream(t0, std::cout);
+    write_to_lts(l, std::cout);
   }
   else 
   {
@@ -457,7 +752,7 @@ static void write_to_lts(const probabilistic_lts_lts_t& l, const std::string& fi
     }
     try
     { 
-      atermpp::write_term_to_binary_stream(t0, stream);
+      write_to_lts(l, stream);
       stream.close();
     }
     catch (std::ofstream::failure)
@@ -6,6 +6,9 @@
 // (See accompanying file LICENSE_1_0.txt or copy at
 // http://www.boost.org/LICENSE_1_0.txt)
 
+#include <random>
+#include <sstream>
+
 #include <boost/test/included/unit_test_framework.hpp>
 
 #include "mcrl2/lts/lts_algorithm.h"
@@ -388,6 +391,66 @@ BOOST_AUTO_TEST_CASE(verum_test)
 }
 
 
+// The preorders computed with a bit matrix must be the same as those of the partitioners.
+BOOST_AUTO_TEST_CASE(test_sim_bit_matrix)
+{
+  const std::string tests[] = { l1, l2, l2a, l3, l4, a, b };
+  for (const std::string& s1: tests)
+  {
+    for (const std::string& s2: tests)
+    {
+      BOOST_CHECK_EQUAL(preorder_compare(s1,s2,lts_pre_sim_bit_matrix), preorder_compare(s1,s2,lts_pre_sim));
+      BOOST_CHECK_EQUAL(preorder_compare(s1,s2,lts_pre_ready_sim_bit_matrix), preorder_compare(s1,s2,lts_pre_ready_sim));
+    }
+  }
+
+  std::mt19937 generator(1);
+  const char* labels[] = { "a", "b", "c" };
+  for (std::size_t k = 0; k < 20; k++)
+  {
+    const std::size_t n = 2 + generator() % 60;
+    const std::size_t m = generator() % (3 * n);
+    std::ostringstream out;
+    out << "des (0," << m << "," << n << ")\n";
+    for (std::size_t i = 0; i < m; i++)
+    {
+      out << "(" << generator() % n << ",\"" << labels[generator() % 3] << "\"," << generator() % n << ")\n";
+    }
+
+    for (bool ready: { false, true })
+    {
+      lts_aut_t l = parse_aut(out.str());
+      detail::sim_bit_matrix<lts_aut_t> sbm(l, ready, 2);
+      lts_aut_t l_copy = parse_aut(out.str());
+      if (ready)
+      {
+        detail::ready_sim_partitioner<lts_aut_t> sp(l_copy);
+        sp.partitioning_algorithm();
+        for (std::size_t s = 0; s < n; s++)
+        {
+          for (std::size_t t = 0; t < n; t++)
+          {
+            BOOST_CHECK_EQUAL(sbm.in_preorder(s, t), sp.in_preorder(s, t));
+          }
+        }
+      }
+      else
+      {
+        detail::sim_partitioner<lts_aut_t> sp(l_copy);
+        sp.partitioning_algorithm();
+        for (std::size_t s = 0; s < n; s++)
+        {
+          for (std::size_t t = 0; t < n; t++)
+          {
+            BOOST_CHECK_EQUAL(sbm.in_preorder(s, t), sp.in_preorder(s, t));
+          }
+        }
+      }
+    }
+  }
+}
+
+
 
 
 boost::unit_test::test_suite* init_unit_test_suite(int argc, char* argv[])
@@ -13,6 +13,7 @@
 #include <boost/test/included/unit_test_framework.hpp>
 
 #include <ctime>
+#include <fstream>
 #include <iostream>
 #include <sstream>
 #include <cstdio>
@@ -21,6 +22,7 @@
 #include "mcrl2/lps/parse.h"
 #include "mcrl2/lts/detail/exploration.h"
 #include "mcrl2/lts/detail/exploration_strategy.h"
+#include "mcrl2/lts/detail/liblts_onthefly_refinement.h"
 #include "mcrl2/lts/lts_aut.h"
 #include "mcrl2/lts/lts_fsm.h"
 #include "mcrl2/lts/lts_lts.h"
@@ -34,7 +36,9 @@ template<class LtsType>
 LtsType translate_lps_to_lts(const lps::specification& specification,
                               exploration_strategy strategy = es_breadth,
                               data::rewrite_strategy rewrite_strategy = data::jitty,
-                              const std::string& priority_action = "")
+                              const std::string& priority_action = "",
+                              bool compress_states = false,
+                              bool external_memory = false)
 {
   std::clog << "Translating LPS to LTS with exploration strategy " << strategy << ", rewrite strategy "
             << rewrite_strategy << "." << std::endl;
@@ -43,6 +47,9 @@ LtsType translate_lps_to_lts(const lps::specification& specification,
   options.specification = specification;
   // options.priority_action = priority_action;
   options.strat = rewrite_strategy;
+  options.compress_states = compress_states;
+  options.external_memory = external_memory;
+  options.memory_budget = 256; // Small enough to create multiple sorted runs per level.
   // options.expl_strat = strategy;
 
   options.filename = utilities::temporary_filename("lps2lts_test_file");
@@ -131,6 +138,22 @@ static void check_lps2lts_specification(const std::string& specification,
       BOOST_CHECK_EQUAL(result2.num_transitions(), expected_transitions);
       BOOST_CHECK_EQUAL(result2.num_action_labels(), expected_labels);
 
+      std::cerr << "AUT FORMAT (COMPRESSED STATES)\n";
+      lts_aut_t result4 = translate_lps_to_lts<lts_aut_t>(lpsspec, expl_strategy, *rewr_strategy,
+                                                                    priority_action, true);
+      BOOST_CHECK_EQUAL(result4.num_states(), expected_states);
+      BOOST_CHECK_EQUAL(result4.num_transitions(), expected_transitions);
+      BOOST_CHECK_EQUAL(result4.num_action_labels(), expected_labels);
+
+      std::cerr << "AUT FORMAT (EXTERNAL MEMORY)\n";
+      lts_aut_t result5 = translate_lps_to_lts<lts_aut_t>(lpsspec, expl_strategy, *rewr_strategy,
+                                                                    priority_action, false, true);
+
+
+      BOOST_CHECK_EQUAL(result5.num_states(), expected_states);
+      BOOST_CHECK_EQUAL(result5.num_transitions(), expected_transitions);
+      BOOST_CHECK_EQUAL(result5.num_action_labels(), expected_labels);
+
       std::cerr << "FSM FORMAT\n";
       lts_fsm_t result3 = translate_lps_to_lts<lts_fsm_t>(lpsspec, expl_strategy, *rewr_strategy,
                                                                     priority_action);
@@ -585,3 +608,142 @@ BOOST_AUTO_TEST_CASE(test_whether_sets_of_functions_can_be_enumerated)
   );
   check_lps2lts_specification(spec, 1, 8, 9);
 }
+
+BOOST_AUTO_TEST_CASE(test_deadlock_trace)
+{
+  std::string spec(
+          "act a, b: Nat;\n"
+          "proc P(n: Nat) = (n < 3) -> a(n).P(n + 1) + (n == 1) -> b(n).P(n + 5);\n"
+          "init P(0);\n"
+  );
+  lps::specification lpsspec;
+  parse_lps(spec, lpsspec);
+
+  lts_generation_options options;
+  options.specification = lpsspec;
+  options.detect_deadlock = true;
+  options.trace = true;
+  options.max_traces = 1;
+  options.trace_prefix = utilities::temporary_filename("lps2lts_test_trace");
+  lps2lts_algorithm<lps::next_state_generator> lps2lts;
+  lps2lts.generate_lts(options);
+
+  // The first deadlock that is found is P(6), which is reached via a(0) and b(1).
+  std::string filename = options.trace_prefix + "_dlk_0.trc";
+  trace::Trace trace;
+  trace.load(filename);
+  std::remove(filename.c_str());
+  BOOST_CHECK_EQUAL(trace.number_of_actions(), 2u);
+  BOOST_CHECK_EQUAL(trace.number_of_states(), 3u);
+}
+
+BOOST_AUTO_TEST_CASE(test_telemetry)
+{
+  std::string spec(
+          "act a, b: Nat;\n"
+          "proc P(n: Nat) = (n < 3) -> a(n).P(n + 1) + (n == 1) -> b(n).P(n + 5);\n"
+          "init P(0);\n"
+  );
+  lps::specification lpsspec;
+  parse_lps(spec, lpsspec);
+
+  for (bool external_memory: { false, true })
+  {
+    lts_generation_options options;
+    options.specification = lpsspec;
+    options.external_memory = external_memory;
+    options.telemetry_filename = utilities::temporary_filename("lps2lts_test_telemetry");
+    options.telemetry_interval = 1000000;
+    lps2lts_algorithm<lps::next_state_generator> lps2lts;
+    lps2lts.generate_lts(options);
+
+    // Only the final line is written, since the interval is long.
+    std::ifstream in(options.telemetry_filename);
+    std::string line;
+    std::getline(in, line);
+    in.close();
+    std::remove(options.telemetry_filename.c_str());
+    BOOST_CHECK(line.find("\"final\": true") != std::string::npos);
+    BOOST_CHECK(line.find("\"states\": 5, \"transitions\": 4, \"explored\": 5") != std::string::npos);
+    BOOST_CHECK(line.find("{\"level\": 1, \"states\": 1, \"transitions\": 1}") != std::string::npos);
+    BOOST_CHECK_EQUAL(line.find("\"state_table\"") != std::string::npos, !external_memory);
+
+    // The first summand has solutions in the states P(0), P(1) and P(2), the second one only in P(1).
+    BOOST_CHECK(line.find("\"calls\": 5, \"solutions\": 3, \"condition_false_rate\": 0.4") != std::string::npos);
+    BOOST_CHECK(line.find("\"calls\": 5, \"solutions\": 1, \"condition_false_rate\": 0.8") != std::string::npos);
+  }
+}
+
+static lts_aut_t parse_aut(const std::string& text)
+{
+  std::stringstream is(text);
+  lts_aut_t l;
+  l.load(is);
+  return l;
+}
+
+static bool check_lps_refinement(const std::string& implementation, const std::string& specification, refinement_type refinement, bool weak_reduction)
+{
+  lps::specification lpsspec;
+  parse_lps(implementation, lpsspec);
+  lts_aut_t spec = parse_aut(specification);
+  bool result = lps_refinement_checker(lpsspec, spec, refinement, weak_reduction);
+
+  // Compare the result with the refinement check on the generated state space.
+  lts_aut_t impl = translate_lps_to_lts<lts_aut_t>(lpsspec);
+  spec = parse_aut(specification);
+  BOOST_CHECK_EQUAL(result, destructive_refinement_checker(impl, spec, refinement, weak_reduction));
+  return result;
+}
+
+BOOST_AUTO_TEST_CASE(test_lps_refinement)
+{
+  // a.(b+c), repeated
+  const std::string spec =
+    "des (0,3,2)\n"
+    "(0,\"a\",1)\n"
+    "(1,\"b\",0)\n"
+    "(1,\"c\",0)\n";
+
+  const std::string impl1 =
+    "act a, b, c;\n"
+    "proc P(n: Nat) = (n == 0) -> a.P(1) + (n == 1) -> b.P(0) + (n == 1) -> c.P(0);\n"
+    "init P(0);\n";
+  const std::string impl2 =
+    "act a, b, c;\n"
+    "proc P(n: Nat) = (n == 0) -> a.P(1) + (n == 0) -> a.P(2) + (n == 1) -> b.P(0) + (n == 2) -> c.P(0);\n"
+    "init P(0);\n";
+  const std::string impl3 =
+    "act a, b, c;\n"
+    "proc P(n: Nat) = (n == 0) -> a.P(1) + (n == 1) -> tau.P(2) + (n == 2) -> b.P(0) + (n == 2) -> c.P(0);\n"
+    "init P(0);\n";
+
+  for (bool weak_reduction: { false, true })
+  {
+    for (refinement_type refinement: { mcrl2::lts::trace, failures, failures_divergence })
+    {
+      if (refinement == failures_divergence && !weak_reduction)
+      {
+        continue;
+      }
+      BOOST_CHECK(check_lps_refinement(impl1, spec, refinement, weak_reduction));
+      BOOST_CHECK_EQUAL(check_lps_refinement(impl2, spec, refinement, weak_reduction), refinement == mcrl2::lts::trace);
+      BOOST_CHECK_EQUAL(check_lps_refinement(impl3, spec, refinement, weak_reduction), weak_reduction);
+    }
+  }
+
+  // The implementation has infinitely many states, but the check stops at the first counterexample.
+  const std::string impl4 =
+    "act a, b, c;\n"
+    "proc P(n: Nat) = (n mod 2 == 0) -> a.P(n + 1) + (n mod 2 == 1 && n != 11) -> b.P(n + 1) + (n == 11) -> a.P(n + 1);\n"
+    "init P(0);\n";
+  lps::specification lpsspec;
+  parse_lps(impl4, lpsspec);
+  lts_aut_t l = parse_aut(spec);
+  const std::string filename = utilities::temporary_filename("lps2lts_test_counter_example") + ".trc";
+  BOOST_CHECK(!lps_refinement_checker(lpsspec, l, mcrl2::lts::trace, false, data::jitty, detail::counter_example_constructor(filename)));
+  trace::Trace counter_example;
+  counter_example.load(filename);
+  std::remove(filename.c_str());
+  BOOST_CHECK_EQUAL(counter_example.number_of_actions(), 12u);
+}
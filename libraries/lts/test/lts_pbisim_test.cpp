@@ -10,6 +10,8 @@
 /// \brief This file contains tests to see whether ltsconvert
 //         reduces problems well.
 
+#include <random>
+#include <sstream>
 #include <boost/test/included/unit_test_framework.hpp>
 
 #include "mcrl2/lts/lts_aut.h"
@@ -388,7 +390,58 @@ BOOST_AUTO_TEST_CASE(test_state_space_reductions)
 #endif
 }
 
+// Generates a random probabilistic transition system in aut format with n states. A probabilistic
+// state has up to three target states, with probabilities 1/2, 1/3 or 1/4 for all but the last.
+static std::string random_plts(const std::size_t n, const std::size_t seed)
+{
+  std::mt19937 generator(seed);
+  const char* labels[] = { "a", "b", "c" };
+  const char* probabilities[] = { "1/4", "1/3", "1/2" };
+  std::stringstream transitions;
+  std::size_t number_of_transitions = 0;
+  for (std::size_t s = 0; s < n; ++s)
+  {
+    for (std::size_t k = generator() % 4; k > 0; --k)
+    {
+      const std::size_t m = 1 + generator() % 3;
+      transitions << "(" << s << ",\"" << labels[generator() % 3] << "\",";
+      for (std::size_t i = 0; i + 1 < m; ++i)
+      {
+        transitions << generator() % n << " " << probabilities[generator() % (m == 3 ? 2 : 3)] << " ";
+      }
+      transitions << generator() % n << ")\n";
+      number_of_transitions++;
+    }
+  }
+  std::stringstream result;
+  result << "des (0," << number_of_transitions << "," << n << ")\n" << transitions.str();
+  return result.str();
+}
+
+BOOST_AUTO_TEST_CASE(test_random_plts)
+{
+  // Both algorithms must compute the same probabilistic bisimulation, and reducing again has no effect.
+  for (std::size_t seed = 0; seed < 20; ++seed)
+  {
+    probabilistic_lts_aut_t t1 = parse_aut(random_plts(300, seed));
+    probabilistic_lts_aut_t t2 = t1;
+    mcrl2::utilities::execution_timer timer1;
+    detail::probabilistic_bisimulation_reduce_grv(t1, timer1);
+    detail::probabilistic_bisimulation_reduce_bem(t2, timer1);
+    BOOST_CHECK_EQUAL(t1.num_states(), t2.num_states());
+    BOOST_CHECK_EQUAL(t1.num_transitions(), t2.num_transitions());
+    BOOST_CHECK_EQUAL(t1.num_probabilistic_states(), t2.num_probabilistic_states());
+
+    probabilistic_lts_aut_t t3 = t2;
+    mcrl2::utilities::execution_timer timer2;
+    detail::probabilistic_bisimulation_reduce_bem(t3, timer2);
+    BOOST_CHECK_EQUAL(t2.num_states(), t3.num_states());
+    BOOST_CHECK_EQUAL(t2.num_transitions(), t3.num_transitions());
 
+    mcrl2::utilities::execution_timer timer3;
+    BOOST_CHECK(detail::probabilistic_bisimulation_compare_bem(t1, t2, timer3));
+  }
+}
 
 boost::unit_test::test_suite* init_unit_test_suite(int argc, char* argv[])
 {
@@ -14,6 +14,8 @@
 #include <boost/test/minimal.hpp>
 #include "mcrl2/lts/lts_algorithm.h"
 #include "mcrl2/lts/lts_aut.h"
+#include "mcrl2/lts/lts_lts.h"
+#include "mcrl2/utilities/test_utilities.h"
 
 using namespace mcrl2;
 
@@ -649,6 +651,54 @@ void test_is_deterministic()
   is_deterministic_test2();
 }
 
+// Check that transitions with decreasing sources and targets survive the columnar .lts format.
+static void test_lts_format_round_trip()
+{
+  const process::action_label a(core::identifier_string("a"), data::sort_expression_list());
+  const process::action_label b(core::identifier_string("b"), data::sort_expression_list());
+
+  lts::lts_lts_t l;
+  l.set_action_label_declarations(process::action_label_list({ a, b }));
+  l.add_action(lts::action_label_lts(lps::multi_action(process::action(a, data::data_expression_list()))));
+  l.add_action(lts::action_label_lts(lps::multi_action(process::action(b, data::data_expression_list()))));
+  l.set_num_states(1000, false);
+  l.set_initial_state(7);
+  for (std::size_t i = 0; i < 1000; ++i)
+  {
+    l.add_transition(lts::transition((i * 7919) % 1000, i % 3, (i * 104729) % 1000));
+  }
+
+  const std::string filename = utilities::temporary_filename("lts_test_file");
+  l.save(filename);
+  lts::lts_lts_t l_loaded;
+  l_loaded.load(filename);
+  std::remove(filename.c_str());
+
+  BOOST_CHECK(l_loaded.num_states() == l.num_states());
+  BOOST_CHECK(l_loaded.initial_state() == l.initial_state());
+  BOOST_CHECK(l_loaded.num_action_labels() == l.num_action_labels());
+  BOOST_CHECK(l_loaded.get_transitions() == l.get_transitions());
+
+  // A probabilistic lts in which the probabilistic states are not the plain states.
+  lts::probabilistic_lts_lts_t pl;
+  pl.set_num_states(3, false);
+  pl.set_initial_probabilistic_state(lts::probabilistic_lts_lts_t::probabilistic_state_t(0));
+  pl.add_probabilistic_state(lts::probabilistic_lts_lts_t::probabilistic_state_t(2));
+  pl.add_probabilistic_state(lts::probabilistic_lts_lts_t::probabilistic_state_t(0));
+  pl.add_transition(lts::transition(0, 0, 0));
+  pl.add_transition(lts::transition(2, 0, 1));
+
+  pl.save(filename);
+  lts::probabilistic_lts_lts_t pl_loaded;
+  pl_loaded.load(filename);
+  std::remove(filename.c_str());
+
+  BOOST_CHECK(pl_loaded.get_transitions() == pl.get_transitions());
+  BOOST_CHECK(pl_loaded.num_probabilistic_states() == 2);
+  BOOST_CHECK(pl_loaded.probabilistic_state(0) == pl.probabilistic_state(0));
+  BOOST_CHECK(pl_loaded.probabilistic_state(1) == pl.probabilistic_state(1));
+}
+
 int test_main(int /* argc*/, char** /* argv */)
 {
   reduce_simple_loop();
@@ -661,6 +711,7 @@ int test_main(int /* argc*/, char** /* argv */)
   failing_test_groote_wijs_algorithm();
   counterexample_jk_1(3);
   counterexample_postprocessing();
+  test_lts_format_round_trip();
   // TODO: Add groote wijs branching bisimulation and add weak bisimulation tests. For the last Peterson is a good candidate.
   return 0;
 }
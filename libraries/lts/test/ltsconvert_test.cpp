@@ -11,6 +11,9 @@
 //         reduces problems well.
 
 // #include <iostream>
+#include <map>
+#include <random>
+#include <set>
 #include <string>
 #include <sstream>
 
@@ -601,6 +604,239 @@ BOOST_AUTO_TEST_CASE(test_state_space_reductions)
  }
 }
 
+// Returns the text of a random LTS in aut format, in which a fraction of the transitions is labelled tau.
+static std::string random_aut(std::size_t number_of_states, std::size_t number_of_transitions, std::size_t seed)
+{
+  std::mt19937 generator(seed);
+  const char* labels[] = { "tau", "tau", "a", "b", "c" };
+  std::ostringstream out;
+  out << "des (0," << number_of_transitions << "," << number_of_states << ")\n";
+  for (std::size_t i = 0; i < number_of_transitions; i++)
+  {
+    out << "(" << generator() % number_of_states << ",\"" << labels[generator() % 5] << "\"," << generator() % number_of_states << ")\n";
+  }
+  return out.str();
+}
+
+static std::string print_aut(const lts_aut_t& l)
+{
+  std::ostringstream out;
+  out << l.initial_state() << " " << l.num_states() << "\n";
+  for (const transition& t: l.get_transitions())
+  {
+    out << t.from() << " " << t.label() << " " << t.to() << "\n";
+  }
+  return out.str();
+}
+
+BOOST_AUTO_TEST_CASE(test_parallel_bisimulation)
+{
+  const std::string tests[] = { test1, test2, test3, test4, test5, test5a, test6, test7, test8, test9, test10, test11, test12, test13,
+                                random_aut(5000, 6000, 1), random_aut(20000, 30000, 2) };
+  const std::pair<lts_equivalence, lts_equivalence> equivalences[] =
+  {
+    { lts_eq_bisim, lts_eq_bisim_parallel },
+    { lts_eq_branching_bisim, lts_eq_branching_bisim_parallel },
+    { lts_eq_divergence_preserving_branching_bisim, lts_eq_divergence_preserving_branching_bisim_parallel }
+  };
+  for (const std::string& text: tests)
+  {
+    for (const auto& eq: equivalences)
+    {
+      lts_aut_t expected = parse_aut(text);
+      reduce(expected, eq.first);
+      lts_aut_t l = parse_aut(text);
+      reduce(l, eq.second);
+      BOOST_CHECK_EQUAL(l.num_states(), expected.num_states());
+      BOOST_CHECK_EQUAL(l.num_transitions(), expected.num_transitions());
+
+      // The result may not depend on the number of threads.
+      std::string result;
+      for (std::size_t number_of_threads: { 1, 2, 4 })
+      {
+        lts_aut_t l = parse_aut(text);
+        detail::bisimulation_reduce_parallel(l, eq.first != lts_eq_bisim, eq.first == lts_eq_divergence_preserving_branching_bisim, number_of_threads);
+        std::string text1 = print_aut(l);
+        BOOST_CHECK(result.empty() || text1 == result);
+        result = text1;
+      }
+
+      lts_aut_t l1 = parse_aut(text);
+      lts_aut_t l2 = parse_aut(text);
+      BOOST_CHECK(compare(l1, l2, eq.second, false));
+    }
+  }
+}
+
+// Weak bisimulation reduction as it was computed before, by applying strong bisimulation to the transitive tau closure.
+static void weak_bisimulation_reduce_using_closure(lts_aut_t& l, bool preserve_divergences)
+{
+  detail::bisimulation_reduce_gjkw(l, true, preserve_divergences);
+  std::size_t divergence_label = 0;
+  if (preserve_divergences)
+  {
+    divergence_label = detail::mark_explicit_divergence_transitions(l);
+  }
+  detail::reflexive_transitive_tau_closure(l);
+  detail::bisimulation_reduce_gjkw(l, false, false);
+  scc_reduce(l);
+  detail::remove_redundant_transitions(l);
+  if (preserve_divergences)
+  {
+    detail::unmark_explicit_divergence_transitions(l, divergence_label);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(test_weak_bisimulation_signatures)
+{
+  const std::string tests[] = { test1, test2, test3, test4, test5, test5a, test6, test7, test8, test9, test10, test11, test12, test13,
+                                random_aut(300, 400, 3), random_aut(1000, 1500, 4) };
+  for (const std::string& text: tests)
+  {
+    for (bool preserve_divergences: { false, true })
+    {
+      lts_aut_t expected = parse_aut(text);
+      weak_bisimulation_reduce_using_closure(expected, preserve_divergences);
+      lts_aut_t l = parse_aut(text);
+      detail::weak_bisimulation_reduce(l, preserve_divergences);
+      BOOST_CHECK_EQUAL(l.num_states(), expected.num_states());
+
+      // The transitions of the results may differ, but their closures must be strongly bisimilar.
+      weak_bisimulation_reduce_using_closure(l, preserve_divergences);
+      BOOST_CHECK(detail::destructive_bisimulation_compare_gjkw(l, expected, false, false));
+    }
+  }
+}
+
+// A straightforward subset construction, with which the result of determinise is compared.
+static std::string determinise_reference(const lts_aut_t& l)
+{
+  std::map<std::size_t, std::set<std::pair<std::size_t, std::size_t> > > out;
+  for (const transition& t: l.get_transitions())
+  {
+    out[t.from()].insert(std::make_pair(l.apply_hidden_label_map(t.label()), t.to()));
+  }
+  std::map<std::set<std::size_t>, std::size_t> numbers;
+  std::vector<std::set<std::size_t> > sets = { { l.initial_state() } };
+  numbers[sets[0]] = 0;
+  std::ostringstream result;
+  result << "0 ";
+  std::ostringstream transitions;
+  for (std::size_t i = 0; i < sets.size(); ++i)
+  {
+    std::map<std::size_t, std::set<std::size_t> > successors;
+    for (std::size_t s: sets[i])
+    {
+      for (const auto& p: out[s])
+      {
+        successors[p.first].insert(p.second);
+      }
+    }
+    for (const auto& p: successors)
+    {
+      auto j = numbers.insert(std::make_pair(p.second, sets.size()));
+      if (j.second)
+      {
+        sets.push_back(p.second);
+      }
+      transitions << i << " " << p.first << " " << j.first->second << "\n";
+    }
+  }
+  result << sets.size() << "\n" << transitions.str();
+  return result.str();
+}
+
+BOOST_AUTO_TEST_CASE(test_determinise)
+{
+  const std::string tests[] = { test1, test2, test3, test4, test5, test5a, test6, test7, test8, test9, test10, test11, test12, test13,
+                                random_aut(20, 60, 5), random_aut(200, 500, 6), random_aut(3000, 4000, 7) };
+  for (const std::string& text: tests)
+  {
+    lts_aut_t l = parse_aut(text);
+    const std::string expected = determinise_reference(l);
+    for (std::size_t number_of_threads: { 1, 2, 4 })
+    {
+      lts_aut_t l = parse_aut(text);
+      detail::subset_construction(l, number_of_threads);
+      BOOST_CHECK(is_deterministic(l));
+      BOOST_CHECK_EQUAL(print_aut(l), expected);
+    }
+  }
+}
+
+static std::vector<std::pair<std::size_t, std::size_t> > random_edges(std::size_t n, std::size_t m, std::size_t seed)
+{
+  std::mt19937 generator(seed);
+  std::vector<std::pair<std::size_t, std::size_t> > result;
+  for (std::size_t i = 0; i < m; ++i)
+  {
+    result.emplace_back(generator() % n, generator() % n);
+  }
+  return result;
+}
+
+BOOST_AUTO_TEST_CASE(test_scc_decomposition)
+{
+  // Compare with the definition on a small graph: two vertices are in the same component if they can reach each other.
+  {
+    const std::size_t n = 150;
+    const auto edges = random_edges(n, 180, 8);
+    detail::csr_graph g(n, edges);
+    std::vector<std::vector<bool> > reachable(n, std::vector<bool>(n, false));
+    for (std::size_t s = 0; s < n; ++s)
+    {
+      std::vector<std::size_t> todo = { s };
+      reachable[s][s] = true;
+      while (!todo.empty())
+      {
+        std::size_t u = todo.back();
+        todo.pop_back();
+        for (const std::size_t* i = g.successors_begin(u); i != g.successors_end(u); ++i)
+        {
+          if (!reachable[s][*i])
+          {
+            reachable[s][*i] = true;
+            todo.push_back(*i);
+          }
+        }
+      }
+    }
+    detail::scc_decomposition sccs(g);
+    for (std::size_t s = 0; s < n; ++s)
+    {
+      for (std::size_t t = 0; t < n; ++t)
+      {
+        BOOST_CHECK_EQUAL(sccs.component(s) == sccs.component(t), reachable[s][t] && reachable[t][s]);
+      }
+    }
+  }
+
+  // The result may not depend on the number of threads.
+  for (std::size_t k = 0; k < 3; ++k)
+  {
+    const std::size_t n = 20000;
+    detail::csr_graph g(n, random_edges(n, n + 5000 * k, 9 + k));
+    detail::scc_decomposition expected(g);
+    for (std::size_t number_of_threads: { 2, 4 })
+    {
+      detail::scc_decomposition sccs(g, number_of_threads);
+      BOOST_CHECK_EQUAL(sccs.num_components(), expected.num_components());
+      BOOST_CHECK(sccs.components() == expected.components());
+      for (std::size_t v = 0; v < n; ++v)
+      {
+        BOOST_CHECK_EQUAL(sccs.on_cycle(v), expected.on_cycle(v));
+      }
+    }
+  }
+
+  const std::string text = random_aut(20000, 40000, 12);
+  lts_aut_t expected = parse_aut(text);
+  scc_reduce(expected);
+  lts_aut_t l = parse_aut(text);
+  scc_reduce(l, false, 4);
+  BOOST_CHECK_EQUAL(print_aut(l), print_aut(expected));
+}
+
 boost::unit_test::test_suite* init_unit_test_suite(int argc, char* argv[])
 {
   return nullptr;
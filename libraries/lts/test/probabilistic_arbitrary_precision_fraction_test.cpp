@@ -64,6 +64,55 @@ BOOST_AUTO_TEST_CASE(cumulative_tests)
 }
 
 
+// Checks the operations on fractions, which are computed on machine words if possible, against a
+// computation on big natural numbers.
+void test_operations(const std::string& as, const std::string& bs, const std::string& cs, const std::string& ds)
+{
+  using utilities::big_natural_number;
+  const big_natural_number a(as), b(bs), c(cs), d(ds);
+  const probabilistic_arbitrary_precision_fraction x(a,b);
+  const probabilistic_arbitrary_precision_fraction y(c,d);
+
+  // Returns whether p/q equals the fraction z.
+  auto equal = [](const big_natural_number& p, const big_natural_number& q, const probabilistic_arbitrary_precision_fraction& z)
+  {
+    return p*z.denominator()==z.enumerator()*q;
+  };
+
+  // Fractions are probabilities, so results larger than one are not checked.
+  BOOST_CHECK((x==y) == (a*d==c*b));
+  BOOST_CHECK((x<y) == (a*d<c*b));
+  BOOST_CHECK(equal(a*c, b*d, x*y));
+  if (a*d+c*b<=b*d)
+  {
+    const probabilistic_arbitrary_precision_fraction z=x+y;
+    BOOST_CHECK(equal(a*d+c*b, b*d, z));
+    BOOST_CHECK(probabilistic_arbitrary_precision_fraction::greatest_common_divisor(z.enumerator(),z.denominator()).is_number(1));
+  }
+  if (c*b<=a*d)
+  {
+    BOOST_CHECK(equal(a*d-c*b, b*d, x-y));
+  }
+  if (!c.is_zero() && a*d<=b*c)
+  {
+    BOOST_CHECK(equal(a*d, b*c, x/y));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(machine_number_tests)
+{
+  test_operations("1","3","1","6");
+  test_operations("2","4","1","2");
+  test_operations("0","7","3","7");
+  test_operations("5","7","0","1");
+  test_operations("1","18446744073709551615","1","18446744073709551614");
+  test_operations("9223372036854775807","18446744073709551615","9223372036854775807","18446744073709551615");
+  test_operations("4294967296","18446744073709551615","4294967297","18446744073709551557");
+  test_operations("1","4294967296","1","4294967296");
+  test_operations("3","12000000000000000000123","1","2");
+}
+
+
 boost::unit_test::test_suite* init_unit_test_suite(int argc, char* argv[])
 {
   return nullptr;
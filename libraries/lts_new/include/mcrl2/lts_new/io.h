@@ -0,0 +1,217 @@
+// Author(s): Wieger Wesselink
+// Copyright: see the accompanying file COPYING or copy at
+// https://svn.win.tue.nl/trac/MCRL2/browser/trunk/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file mcrl2/lts/io.h
+/// \brief Reading and writing LTSs in .aut format, and in a compact binary format.
+
+#ifndef MCRL2_LTS_IO_H
+#define MCRL2_LTS_IO_H
+
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <string>
+#include "mcrl2/lts_new/lts.h"
+#include "mcrl2/lts_new/parse.h"
+#include "mcrl2/utilities/exception.h"
+
+namespace mcrl2 {
+
+namespace lts {
+
+namespace detail {
+
+// The binary format consists of the header "LTSBIN01", followed by the initial state, the number of
+// states, the number of action labels, the number of transitions and the number of bytes used for each
+// number of a transition. These are 64 bit numbers. Then the action labels follow, each given by its
+// length as a 64 bit number and its characters. Finally the transitions follow, each given by the
+// numbers from, label and to of 4 or 8 bytes. All numbers are stored in the byte order of the machine.
+inline
+const std::string& binary_lts_header()
+{
+  static const std::string result = "LTSBIN01";
+  return result;
+}
+
+template <typename Number>
+void write_number(std::ostream& out, Number n)
+{
+  out.write(reinterpret_cast<const char*>(&n), sizeof(Number));
+}
+
+template <typename Number>
+Number read_number(std::istream& in)
+{
+  Number n;
+  if (!in.read(reinterpret_cast<char*>(&n), sizeof(Number)))
+  {
+    throw mcrl2::runtime_error("unexpected end of binary LTS");
+  }
+  return n;
+}
+
+template <typename Number>
+void write_transitions(std::ostream& out, const std::vector<transition>& transitions)
+{
+  for (const transition& t: transitions)
+  {
+    Number buffer[3] = { static_cast<Number>(t.from), static_cast<Number>(t.label), static_cast<Number>(t.to) };
+    out.write(reinterpret_cast<const char*>(buffer), sizeof(buffer));
+  }
+}
+
+template <typename Number>
+void read_transitions(std::istream& in, std::vector<transition>& transitions, std::size_t number_of_transitions)
+{
+  transitions.reserve(number_of_transitions);
+  for (std::size_t i = 0; i < number_of_transitions; i++)
+  {
+    Number buffer[3];
+    if (!in.read(reinterpret_cast<char*>(buffer), sizeof(buffer)))
+    {
+      throw mcrl2::runtime_error("unexpected end of binary LTS");
+    }
+    transitions.emplace_back(buffer[0], buffer[1], buffer[2]);
+  }
+}
+
+// Reads the part of a binary LTS after the header.
+inline
+labeled_transition_system load_lts_binary_body(std::istream& in)
+{
+  labeled_transition_system result;
+  result.initial_state = read_number<std::uint64_t>(in);
+  result.number_of_states = read_number<std::uint64_t>(in);
+  std::size_t number_of_labels = read_number<std::uint64_t>(in);
+  std::size_t number_of_transitions = read_number<std::uint64_t>(in);
+  std::size_t width = read_number<std::uint64_t>(in);
+
+  for (std::size_t i = 0; i < number_of_labels; i++)
+  {
+    std::string label(read_number<std::uint64_t>(in), '\0');
+    if (!in.read(&label[0], label.size()))
+    {
+      throw mcrl2::runtime_error("unexpected end of binary LTS");
+    }
+    result.action_labels.push_back(label);
+  }
+
+  if (width == 4)
+  {
+    read_transitions<std::uint32_t>(in, result.transitions, number_of_transitions);
+  }
+  else if (width == 8)
+  {
+    read_transitions<std::uint64_t>(in, result.transitions, number_of_transitions);
+  }
+  else
+  {
+    throw mcrl2::runtime_error("invalid number size in binary LTS");
+  }
+  return result;
+}
+
+} // namespace detail
+
+// Writes ltsspec in binary format. If all states and labels fit in 32 bits, the transitions are
+// stored using 4 bytes per number.
+inline
+void save_lts_binary(std::ostream& out, const labeled_transition_system& ltsspec)
+{
+  const bool small = ltsspec.number_of_states <= std::numeric_limits<std::uint32_t>::max() &&
+                     ltsspec.action_labels.size() <= std::numeric_limits<std::uint32_t>::max();
+
+  out << detail::binary_lts_header();
+  detail::write_number<std::uint64_t>(out, ltsspec.initial_state);
+  detail::write_number<std::uint64_t>(out, ltsspec.number_of_states);
+  detail::write_number<std::uint64_t>(out, ltsspec.action_labels.size());
+  detail::write_number<std::uint64_t>(out, ltsspec.transitions.size());
+  detail::write_number<std::uint64_t>(out, small ? 4 : 8);
+  for (const std::string& label: ltsspec.action_labels)
+  {
+    detail::write_number<std::uint64_t>(out, label.size());
+    out << label;
+  }
+  if (small)
+  {
+    detail::write_transitions<std::uint32_t>(out, ltsspec.transitions);
+  }
+  else
+  {
+    detail::write_transitions<std::uint64_t>(out, ltsspec.transitions);
+  }
+}
+
+// Reads an LTS from in, that is either in binary format or in .aut format.
+inline
+labeled_transition_system load_lts(std::istream& in)
+{
+  const std::string& header = detail::binary_lts_header();
+  std::string text(header.size(), '\0');
+  in.read(&text[0], header.size());
+  text.resize(in.gcount());
+  if (text == header)
+  {
+    return detail::load_lts_binary_body(in);
+  }
+  text.append(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+  return parse_lts(text);
+}
+
+// Reads an LTS from the file filename, or from stdin if filename is empty.
+inline
+labeled_transition_system load_lts(const std::string& filename)
+{
+  if (filename.empty())
+  {
+    return load_lts(std::cin);
+  }
+  std::ifstream in(filename, std::ios::binary);
+  if (!in.good())
+  {
+    throw mcrl2::runtime_error("Could not read from filename " + filename);
+  }
+  return load_lts(in);
+}
+
+// Writes an LTS to the file filename, or to stdout if filename is empty. If binary is true the binary
+// format is used, otherwise the .aut format.
+inline
+void save_lts(const std::string& filename, const labeled_transition_system& ltsspec, bool binary = false)
+{
+  auto save = [&](std::ostream& out)
+    {
+      if (binary)
+      {
+        save_lts_binary(out, ltsspec);
+      }
+      else
+      {
+        out << ltsspec;
+      }
+    };
+
+  if (filename.empty())
+  {
+    save(std::cout);
+    return;
+  }
+  std::ofstream out(filename, std::ios::binary);
+  if (!out.good())
+  {
+    throw mcrl2::runtime_error("Could not write to filename " + filename);
+  }
+  save(out);
+}
+
+} // namespace lts
+
+} // namespace mcrl2
+
+#endif // MCRL2_LTS_IO_H
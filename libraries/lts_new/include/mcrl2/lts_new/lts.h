@@ -14,6 +14,8 @@
 
 #include <cstddef>
 #include <iostream>
+#include <string>
+#include <tuple>
 #include <utility>
 #include <vector>
 
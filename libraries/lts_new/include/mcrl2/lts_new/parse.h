@@ -46,6 +46,7 @@ labeled_transition_system parse_lts(Iterator first, Iterator last)
 
   // the special action "tau" has always label 0
   label_map["tau"] = 0;
+  result.action_labels.push_back("tau");
 
   std::size_t from;
   std::size_t label;
@@ -12,18 +12,78 @@
 #ifndef MCRL2_LTS_REMOVE_DUPLICATE_TRANSITIONS_H
 #define MCRL2_LTS_REMOVE_DUPLICATE_TRANSITIONS_H
 
-#include <set>
+#include <algorithm>
 #include "mcrl2/lts_new/lts.h"
 
 namespace mcrl2 {
 
 namespace lts {
 
+namespace detail {
+
+// Sorts the transitions in place on their source state, using a radix sort with one bucket per state
+// (American flag sort). Returns the offsets of the buckets: the transitions with source s are at the
+// positions offsets[s], ..., offsets[s+1] - 1.
+inline
+std::vector<std::size_t> sort_transitions_on_source(std::vector<transition>& transitions, std::size_t number_of_states)
+{
+  std::vector<std::size_t> offsets(number_of_states + 1, 0);
+  for (const transition& t: transitions)
+  {
+    offsets[t.from + 1]++;
+  }
+  for (std::size_t s = 0; s < number_of_states; s++)
+  {
+    offsets[s + 1] += offsets[s];
+  }
+
+  // next[s] is the first position in bucket s of which the transition has not been placed yet
+  std::vector<std::size_t> next(offsets.begin(), offsets.end() - 1);
+  for (std::size_t s = 0; s < number_of_states; s++)
+  {
+    while (next[s] < offsets[s + 1])
+    {
+      transition& t = transitions[next[s]];
+      if (t.from == s)
+      {
+        next[s]++;
+      }
+      else
+      {
+        std::swap(t, transitions[next[t.from]++]);
+      }
+    }
+  }
+  return offsets;
+}
+
+} // namespace detail
+
+// Removes duplicate transitions, and sorts the transitions on (from, label, to). The transitions are
+// sorted in place, such that apart from the transitions only O(number_of_states) memory is used.
 inline
 void remove_duplicate_transitions(labeled_transition_system& ltsspec)
 {
-  std::set<transition> transitions(ltsspec.transitions.begin(), ltsspec.transitions.end());
-  ltsspec.transitions.assign(transitions.begin(), transitions.end());
+  std::vector<transition>& transitions = ltsspec.transitions;
+  std::vector<std::size_t> offsets = detail::sort_transitions_on_source(transitions, ltsspec.number_of_states);
+
+  auto equal = [](const transition& t1, const transition& t2)
+    {
+      return t1.from == t2.from && t1.label == t2.label && t1.to == t2.to;
+    };
+
+  // sort the buckets, and move their unique transitions to the front
+  std::size_t size = 0;
+  for (std::size_t s = 0; s < ltsspec.number_of_states; s++)
+  {
+    auto first = transitions.begin() + offsets[s];
+    auto last = transitions.begin() + offsets[s + 1];
+    std::sort(first, last);
+    last = std::unique(first, last, equal);
+    std::move(first, last, transitions.begin() + size);
+    size += last - first;
+  }
+  transitions.resize(size, transition(0, 0, 0));
 }
 
 } // namespace lts
@@ -12,7 +12,7 @@
 #ifndef MCRL2_LTS_REMOVE_TAU_ACTION_H
 #define MCRL2_LTS_REMOVE_TAU_ACTION_H
 
-#include <map>
+#include <numeric>
 #include "mcrl2/lts_new/lts.h"
 #include "mcrl2/lts_new/remove_duplicate_transitions.h"
 #include "mcrl2/lts_new/remove_unused_states.h"
@@ -21,53 +21,84 @@ namespace mcrl2 {
 
 namespace lts {
 
-// Joins states that are connected using a transition with label tau_label.
-inline
-void remove_tau_action(labeled_transition_system& ltsspec, std::size_t tau_label = 0)
+namespace detail {
+
+// A union-find structure on the elements [0, ..., n), with union by size and path halving.
+class union_find
 {
-  // compute a map of replacements
-  std::map<std::size_t, std::size_t> replacements;
-  for (const transition& t: ltsspec.transitions)
-  {
-    if (t.label != tau_label)
-    {
-      continue;
-    }
-    auto i = replacements.find(t.to);
-    if (i == replacements.end())
+  protected:
+    std::vector<std::size_t> m_parent;
+    std::vector<std::size_t> m_size;
+
+  public:
+    explicit union_find(std::size_t n)
+      : m_parent(n), m_size(n, 1)
     {
-      replacements[t.to] = t.from;
+      std::iota(m_parent.begin(), m_parent.end(), 0);
     }
-    else
+
+    // Returns the representative of the set that contains x.
+    std::size_t find(std::size_t x)
     {
-      replacements[t.to] = i->second;
+      while (m_parent[x] != x)
+      {
+        m_parent[x] = m_parent[m_parent[x]];
+        x = m_parent[x];
+      }
+      return x;
     }
-  }
 
-  auto replace = [&](std::size_t n)
+    // Joins the sets that contain x and y.
+    void join(std::size_t x, std::size_t y)
     {
-      auto i = replacements.find(n);
-      if (i == replacements.end())
+      x = find(x);
+      y = find(y);
+      if (x == y)
       {
-        return n;
+        return;
       }
-      return i->second;
-    };
+      if (m_size[x] < m_size[y])
+      {
+        std::swap(x, y);
+      }
+      m_parent[y] = x;
+      m_size[x] += m_size[y];
+    }
+};
+
+} // namespace detail
 
-  // compute new transitions
-  std::vector<transition> transitions;
+// Joins states that are connected using a transition with label tau_label, and removes these transitions.
+// States are joined if they are connected by a path of tau transitions in either direction. If all tau
+// transitions are inert, e.g. if they are confluent, the result is branching bisimilar to the original.
+// This takes near linear time, and apart from the transitions O(number_of_states) memory.
+inline
+void remove_tau_action(labeled_transition_system& ltsspec, std::size_t tau_label = 0)
+{
+  detail::union_find components(ltsspec.number_of_states);
   for (const transition& t: ltsspec.transitions)
   {
     if (t.label == tau_label)
     {
-      continue;
+      components.join(t.from, t.to);
+    }
+  }
+
+  // remove the tau transitions, and replace the states by their representatives in place
+  std::vector<transition>& transitions = ltsspec.transitions;
+  std::size_t size = 0;
+  for (std::size_t i = 0; i < transitions.size(); i++)
+  {
+    const transition& t = transitions[i];
+    if (t.label != tau_label)
+    {
+      transitions[size++] = transition(components.find(t.from), t.label, components.find(t.to));
     }
-    transitions.emplace_back(replace(t.from), t.label, replace(t.to));
   }
-  std::swap(ltsspec.transitions, transitions);
+  transitions.resize(size, transition(0, 0, 0));
 
   // update initial state
-  ltsspec.initial_state = replace(ltsspec.initial_state);
+  ltsspec.initial_state = components.find(ltsspec.initial_state);
 
   // there may be duplicate transitions, so remove them.
   remove_duplicate_transitions(ltsspec);
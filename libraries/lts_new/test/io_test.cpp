@@ -0,0 +1,67 @@
+// Author(s): Wieger Wesselink
+// Copyright: see the accompanying file COPYING or copy at
+// https://svn.win.tue.nl/trac/MCRL2/browser/trunk/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file io_test.cpp
+/// \brief Tests for reading and writing LTSs, and for removing duplicate transitions.
+
+#define BOOST_TEST_MODULE io_test
+
+#include <random>
+#include <set>
+#include <sstream>
+#include <boost/test/included/unit_test_framework.hpp>
+#include "mcrl2/lts_new/io.h"
+#include "mcrl2/lts_new/remove_duplicate_transitions.h"
+
+using namespace mcrl2;
+
+std::string print(const lts::labeled_transition_system& ltsspec)
+{
+  std::ostringstream out;
+  out << ltsspec;
+  return out.str();
+}
+
+BOOST_AUTO_TEST_CASE(test_binary_format)
+{
+  std::string text = "des (2,4,4)\n(0,\"a\",1)\n(1,\"tau\",2)\n(2,\"b\",3)\n(3,\"a\",0)\n";
+  lts::labeled_transition_system lts1 = lts::parse_lts(text);
+  BOOST_CHECK_EQUAL(print(lts1), text);
+
+  std::stringstream binary;
+  lts::save_lts_binary(binary, lts1);
+  lts::labeled_transition_system lts2 = lts::load_lts(binary);
+  BOOST_CHECK_EQUAL(print(lts2), text);
+
+  std::istringstream aut(text);
+  lts::labeled_transition_system lts3 = lts::load_lts(aut);
+  BOOST_CHECK_EQUAL(print(lts3), text);
+
+  std::string truncated = binary.str().substr(0, binary.str().size() - 1);
+  std::istringstream in(truncated);
+  BOOST_CHECK_THROW(lts::load_lts(in), mcrl2::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(test_remove_duplicate_transitions)
+{
+  std::mt19937 generator(42);
+  lts::labeled_transition_system ltsspec;
+  ltsspec.initial_state = 0;
+  ltsspec.number_of_states = 50;
+  ltsspec.action_labels = { "tau", "a", "b" };
+  for (std::size_t i = 0; i < 1000; i++)
+  {
+    ltsspec.transitions.emplace_back(generator() % 50, generator() % 3, generator() % 50);
+  }
+  std::set<lts::transition> expected(ltsspec.transitions.begin(), ltsspec.transitions.end());
+
+  lts::remove_duplicate_transitions(ltsspec);
+  BOOST_CHECK_EQUAL(ltsspec.transitions.size(), expected.size());
+  BOOST_CHECK(std::equal(ltsspec.transitions.begin(), ltsspec.transitions.end(), expected.begin(),
+                         [](const lts::transition& t1, const lts::transition& t2) { return !(t1 < t2) && !(t2 < t1); }));
+}
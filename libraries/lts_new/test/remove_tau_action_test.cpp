@@ -0,0 +1,104 @@
+// Author(s): Wieger Wesselink
+// Copyright: see the accompanying file COPYING or copy at
+// https://svn.win.tue.nl/trac/MCRL2/browser/trunk/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file remove_tau_action_test.cpp
+/// \brief Tests for the contraction of tau transitions.
+
+#define BOOST_TEST_MODULE remove_tau_action_test
+
+#include <algorithm>
+#include <random>
+#include <sstream>
+#include <boost/test/included/unit_test_framework.hpp>
+#include "mcrl2/lts_new/parse.h"
+#include "mcrl2/lts_new/remove_tau_action.h"
+
+using namespace mcrl2;
+
+std::string print(const lts::labeled_transition_system& ltsspec)
+{
+  std::ostringstream out;
+  out << ltsspec;
+  return out.str();
+}
+
+BOOST_AUTO_TEST_CASE(test_chains)
+{
+  // A chain of tau transitions, and a state with several tau predecessors.
+  std::string text =
+    "des (0,6,7)\n"
+    "(0,\"tau\",1)\n"
+    "(1,\"tau\",2)\n"
+    "(2,\"a\",3)\n"
+    "(4,\"tau\",3)\n"
+    "(5,\"tau\",3)\n"
+    "(3,\"b\",6)\n";
+  lts::labeled_transition_system ltsspec = lts::parse_lts(text);
+  lts::remove_tau_action(ltsspec);
+  BOOST_CHECK_EQUAL(print(ltsspec), "des (0,2,3)\n(0,\"a\",1)\n(1,\"b\",2)\n");
+}
+
+// Replaces each state s of ltsspec by a cluster of k states that are connected by tau transitions, such that
+// each state of the cluster has the outgoing transitions of s to arbitrary states of the target clusters. The
+// tau transitions are confluent, so the result is branching bisimilar to ltsspec.
+lts::labeled_transition_system inflate(const lts::labeled_transition_system& ltsspec, std::size_t k, std::mt19937& generator)
+{
+  lts::labeled_transition_system result;
+  result.action_labels = ltsspec.action_labels;
+  result.number_of_states = ltsspec.number_of_states * k;
+  result.initial_state = ltsspec.initial_state * k + generator() % k;
+  for (std::size_t s = 0; s < ltsspec.number_of_states; s++)
+  {
+    // connect the cluster by a random tree of tau transitions in either direction
+    for (std::size_t i = 1; i < k; i++)
+    {
+      std::size_t j = generator() % i;
+      if (generator() % 2 == 0)
+      {
+        result.transitions.emplace_back(s * k + i, 0, s * k + j);
+      }
+      else
+      {
+        result.transitions.emplace_back(s * k + j, 0, s * k + i);
+      }
+    }
+  }
+  for (const lts::transition& t: ltsspec.transitions)
+  {
+    for (std::size_t i = 0; i < k; i++)
+    {
+      result.transitions.emplace_back(t.from * k + i, t.label, t.to * k + generator() % k);
+    }
+  }
+  std::shuffle(result.transitions.begin(), result.transitions.end(), generator);
+  return result;
+}
+
+BOOST_AUTO_TEST_CASE(test_confluent_tau)
+{
+  std::mt19937 generator(7);
+  for (std::size_t n = 1; n < 50; n += 7)
+  {
+    lts::labeled_transition_system ltsspec;
+    ltsspec.action_labels = { "tau", "a", "b", "c" };
+    ltsspec.number_of_states = n;
+    ltsspec.initial_state = generator() % n;
+    for (std::size_t s = 0; s < n; s++)
+    {
+      ltsspec.transitions.emplace_back(s, 1 + generator() % 3, generator() % n);
+      ltsspec.transitions.emplace_back(s, 1 + generator() % 3, generator() % n);
+    }
+    lts::remove_duplicate_transitions(ltsspec);
+
+    // The states of a cluster are contracted to one of them. Since the clusters are numbered in the order
+    // of the original states, the result is equal to the original LTS.
+    lts::labeled_transition_system inflated = inflate(ltsspec, 1 + n % 5, generator);
+    lts::remove_tau_action(inflated);
+    BOOST_CHECK_EQUAL(print(inflated), print(ltsspec));
+  }
+}
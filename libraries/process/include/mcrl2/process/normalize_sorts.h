@@ -28,6 +28,10 @@ void normalize_sorts(T& x,
                      typename std::enable_if< !std::is_base_of< atermpp::aterm, T >::value >::type* = nullptr
                     )
 {
+  if (sortspec.sort_alias_map().empty())
+  {
+    return;
+  }
   core::make_update_apply_builder<process::sort_expression_builder>(data::detail::normalize_sorts_function(sortspec)).update(x);
 }
 
@@ -37,6 +41,10 @@ T normalize_sorts(const T& x,
                   typename std::enable_if< std::is_base_of< atermpp::aterm, T >::value >::type* = nullptr
                  )
 {
+  if (sortspec.sort_alias_map().empty())
+  {
+    return x;
+  }
   return core::make_update_apply_builder<process::sort_expression_builder>(data::detail::normalize_sorts_function(sortspec)).apply(x);
 }
 
@@ -0,0 +1,316 @@
+// Author(s): Wieger Wesselink
+// Copyright: see the accompanying file COPYING or copy at
+// https://github.com/mCRL2org/mCRL2/blob/master/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file mcrl2/utilities/async_logger.h
+/// \brief An output policy for the logger that writes messages in a separate thread.
+
+#ifndef MCRL2_UTILITIES_ASYNC_LOGGER_H
+#define MCRL2_UTILITIES_ASYNC_LOGGER_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "mcrl2/utilities/logger.h"
+
+namespace mcrl2 {
+
+namespace log {
+
+/// \brief Output policy that passes messages to another output policy in a separate writer thread.
+///
+/// Each thread that logs gets its own ring buffer of messages, to which it writes without locking.
+/// The writer thread drains the buffers and outputs the messages in the order in which they were
+/// submitted. If the buffer of a thread is full, the thread waits until the writer has made room.
+/// Since the other output policy is only called from the writer thread, it does not need to be
+/// thread safe. In particular this holds for the formatter, which keeps track of the last message.
+class async_output: public output_policy
+{
+  protected:
+    struct message
+    {
+      log_level_t level;
+      std::string hint;
+      time_t timestamp;
+      std::string text;
+      bool print_time_information;
+      std::size_t sequence_number;
+    };
+
+    /// \brief A ring buffer with one producer and one consumer (the writer thread).
+    struct message_buffer
+    {
+      std::vector<message> messages;              // The size is a power of two.
+      alignas(64) std::atomic<std::size_t> head;  // The number of messages that were written to the buffer.
+      alignas(64) std::atomic<std::size_t> tail;  // The number of messages that were taken from the buffer.
+      std::atomic<bool> closed;                   // Set when the thread that writes to the buffer has finished.
+
+      explicit message_buffer(std::size_t capacity)
+        : messages(capacity), head(0), tail(0), closed(false)
+      {}
+
+      bool empty() const
+      {
+        return tail.load(std::memory_order_relaxed) == head.load(std::memory_order_acquire);
+      }
+
+      message& front()
+      {
+        return messages[tail.load(std::memory_order_relaxed) & (messages.size() - 1)];
+      }
+    };
+
+    /// \brief The buffers of the current thread, one per async_output object.
+    struct thread_buffers
+    {
+      std::vector<std::pair<std::size_t, std::shared_ptr<message_buffer> > > buffers;
+
+      ~thread_buffers()
+      {
+        for (auto& p: buffers)
+        {
+          p.second->closed.store(true, std::memory_order_release);
+        }
+      }
+    };
+
+    static std::size_t round_up_to_power_of_two(std::size_t n)
+    {
+      std::size_t result = 1;
+      while (result < n)
+      {
+        result *= 2;
+      }
+      return result;
+    }
+
+    static std::size_t next_identifier()
+    {
+      static std::atomic<std::size_t> m_identifier(0);
+      return m_identifier++;
+    }
+
+    output_policy& m_output;
+    const std::size_t m_identifier;
+    const std::size_t m_capacity;
+    std::atomic<std::size_t> m_sequence_number;
+
+    std::mutex m_mutex;                        // Protects m_buffers and m_stop, and is used for the condition variables.
+    std::condition_variable m_work_available;  // Signals the writer thread.
+    std::condition_variable m_work_done;       // Signals threads that wait in flush().
+    std::atomic<bool> m_writer_waiting;
+    std::vector<std::shared_ptr<message_buffer> > m_buffers;
+    bool m_stop;
+    std::thread m_writer;
+
+    /// \brief Returns the buffer of the current thread, and creates it if needed.
+    message_buffer& local_buffer()
+    {
+      static thread_local thread_buffers local;
+      for (auto& p: local.buffers)
+      {
+        if (p.first == m_identifier)
+        {
+          return *p.second;
+        }
+      }
+      std::shared_ptr<message_buffer> buffer = std::make_shared<message_buffer>(m_capacity);
+      local.buffers.emplace_back(m_identifier, buffer);
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_buffers.push_back(buffer);
+      return *buffer;
+    }
+
+    void wake_writer()
+    {
+      if (m_writer_waiting.load(std::memory_order_acquire))
+      {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_work_available.notify_one();
+      }
+    }
+
+    /// \brief Outputs all messages that are in the buffers.
+    /// \return True if at least one message was written.
+    bool drain(const std::vector<std::shared_ptr<message_buffer> >& buffers)
+    {
+      bool result = false;
+      while (true)
+      {
+        // Take the oldest message at the front of a buffer.
+        message_buffer* next = nullptr;
+        for (const std::shared_ptr<message_buffer>& buffer: buffers)
+        {
+          if (!buffer->empty() && (!next || buffer->front().sequence_number < next->front().sequence_number))
+          {
+            next = buffer.get();
+          }
+        }
+        if (!next)
+        {
+          return result;
+        }
+        message& m = next->front();
+        m_output.output(m.level, m.hint, m.timestamp, m.text, m.print_time_information);
+        next->tail.store(next->tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        result = true;
+      }
+    }
+
+    void run()
+    {
+      std::vector<std::shared_ptr<message_buffer> > buffers;
+      while (true)
+      {
+        bool stop;
+        {
+          std::lock_guard<std::mutex> lock(m_mutex);
+          // Remove the buffers of threads that have finished.
+          m_buffers.erase(std::remove_if(m_buffers.begin(), m_buffers.end(),
+                                         [](const std::shared_ptr<message_buffer>& buffer)
+                                         {
+                                           return buffer->closed.load(std::memory_order_acquire) && buffer->empty();
+                                         }),
+                          m_buffers.end());
+          buffers = m_buffers;
+          stop = m_stop;
+        }
+
+        if (drain(buffers))
+        {
+          std::lock_guard<std::mutex> lock(m_mutex);
+          m_work_done.notify_all();
+          continue;
+        }
+        if (stop)
+        {
+          return;
+        }
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_writer_waiting.store(true, std::memory_order_release);
+        // A message that is written just before m_writer_waiting is set does not wake the writer,
+        // hence the timeout.
+        m_work_available.wait_for(lock, std::chrono::milliseconds(10));
+        m_writer_waiting.store(false, std::memory_order_release);
+      }
+    }
+
+  public:
+    /// \brief Constructor.
+    /// \param output The output policy to which the messages are passed.
+    /// \param capacity The number of messages that can be buffered per thread. It is rounded up to a power of two.
+    explicit async_output(output_policy& output, std::size_t capacity = 1024)
+      : m_output(output),
+        m_identifier(next_identifier()),
+        m_capacity(round_up_to_power_of_two(capacity)),
+        m_sequence_number(0),
+        m_writer_waiting(false),
+        m_stop(false)
+    {
+      m_writer = std::thread([this]() { run(); });
+    }
+
+    async_output(const async_output&) = delete;
+    async_output& operator=(const async_output&) = delete;
+
+    /// \brief Destructor. Outputs the remaining messages and stops the writer thread.
+    ~async_output() override
+    {
+      {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+        m_work_available.notify_one();
+      }
+      m_writer.join();
+    }
+
+    void output(const log_level_t level, const std::string& hint, const time_t timestamp, const std::string& msg, const bool print_time_information) override
+    {
+      message_buffer& buffer = local_buffer();
+      const std::size_t head = buffer.head.load(std::memory_order_relaxed);
+      while (head - buffer.tail.load(std::memory_order_acquire) == buffer.messages.size())
+      {
+        wake_writer();
+        std::this_thread::yield();
+      }
+      message& m = buffer.messages[head & (buffer.messages.size() - 1)];
+      m.level = level;
+      m.hint = hint;
+      m.timestamp = timestamp;
+      m.text = msg;
+      m.print_time_information = print_time_information;
+      m.sequence_number = m_sequence_number.fetch_add(1, std::memory_order_relaxed);
+      buffer.head.store(head + 1, std::memory_order_release);
+      wake_writer();
+    }
+
+    /// \brief Waits until all messages that were submitted before the call have been output.
+    void flush()
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      std::vector<std::pair<std::shared_ptr<message_buffer>, std::size_t> > targets;
+      for (const std::shared_ptr<message_buffer>& buffer: m_buffers)
+      {
+        targets.emplace_back(buffer, buffer->head.load(std::memory_order_acquire));
+      }
+      m_work_available.notify_one();
+      m_work_done.wait(lock, [&]()
+        {
+          return std::all_of(targets.begin(), targets.end(), [](const std::pair<std::shared_ptr<message_buffer>, std::size_t>& p)
+            {
+              return p.first->tail.load(std::memory_order_acquire) >= p.second;
+            });
+        });
+    }
+};
+
+/// \brief Replaces an output policy of the logger by an async_output during its lifetime. This makes
+/// logging from multiple threads safe, and moves the formatting and writing of the messages out
+/// of the threads that log.
+class async_logging
+{
+  protected:
+    output_policy& m_policy;
+    async_output m_output;
+
+  public:
+    explicit async_logging(output_policy& policy = default_output_policy(), std::size_t capacity = 1024)
+      : m_policy(policy),
+        m_output(policy, capacity)
+    {
+      mcrl2_logger::unregister_output_policy(m_policy);
+      mcrl2_logger::register_output_policy(m_output);
+    }
+
+    async_logging(const async_logging&) = delete;
+    async_logging& operator=(const async_logging&) = delete;
+
+    ~async_logging()
+    {
+      mcrl2_logger::unregister_output_policy(m_output);
+      m_output.flush();
+      mcrl2_logger::register_output_policy(m_policy);
+    }
+
+    /// \brief Waits until all messages that were logged before the call have been output.
+    void flush()
+    {
+      m_output.flush();
+    }
+};
+
+} // namespace log
+
+} // namespace mcrl2
+
+#endif // MCRL2_UTILITIES_ASYNC_LOGGER_H
@@ -0,0 +1,209 @@
+// Author(s): Wieger Wesselink
+// Copyright: see the accompanying file COPYING or copy at
+// https://github.com/mCRL2org/mCRL2/blob/master/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file mcrl2/utilities/benchmark.h
+/// \brief A small harness for running benchmarks, and measuring their time and memory usage.
+
+#ifndef MCRL2_UTILITIES_BENCHMARK_H
+#define MCRL2_UTILITIES_BENCHMARK_H
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "mcrl2/utilities/text_utility.h"
+
+#ifdef __linux__
+#include <sys/resource.h>
+#endif
+
+namespace mcrl2 {
+
+namespace utilities {
+
+/// \brief Measures the time of one run of a benchmark. The time between the call of the benchmark
+/// function and start() is not measured, such that a benchmark can prepare its input first.
+class benchmark_timer
+{
+  protected:
+    std::chrono::steady_clock::time_point m_start = std::chrono::steady_clock::now();
+    std::chrono::steady_clock::time_point m_finish;
+    bool m_finished = false;
+
+  public:
+    /// \brief Starts the measurement.
+    void start()
+    {
+      m_start = std::chrono::steady_clock::now();
+    }
+
+    /// \brief Ends the measurement. If it is not called, the measurement ends when the benchmark function returns.
+    void finish()
+    {
+      m_finish = std::chrono::steady_clock::now();
+      m_finished = true;
+    }
+
+    /// \brief Returns the measured time in seconds.
+    double seconds()
+    {
+      if (!m_finished)
+      {
+        finish();
+      }
+      return std::chrono::duration<double>(m_finish - m_start).count();
+    }
+};
+
+/// \brief A benchmark is a function that processes an input of a given size. It returns the number
+/// of items that were processed, which is used to compute the throughput.
+struct benchmark
+{
+  std::string name;
+  std::vector<std::size_t> sizes;
+  std::function<std::size_t(std::size_t, benchmark_timer&)> run;
+};
+
+/// \brief The results of running a benchmark with one of its sizes.
+struct benchmark_measurement
+{
+  std::string name;
+  std::size_t size;
+  std::size_t items;
+  std::vector<double> times;     // The time of each repetition in seconds.
+  std::size_t peak_memory;       // The peak resident memory in bytes.
+  bool peak_memory_is_exact;     // False if the peak of the process is reported, since it could not be reset.
+
+  double minimum_time() const
+  {
+    return *std::min_element(times.begin(), times.end());
+  }
+
+  double median_time() const
+  {
+    std::vector<double> t = times;
+    std::sort(t.begin(), t.end());
+    return t.size() % 2 == 1 ? t[t.size() / 2] : (t[t.size() / 2 - 1] + t[t.size() / 2]) / 2;
+  }
+
+  /// \brief Returns the number of items per second, based on the median time.
+  double throughput() const
+  {
+    const double t = median_time();
+    return t > 0 ? items / t : 0.0;
+  }
+};
+
+/// \brief Resets the peak resident memory of the process to the current resident memory.
+/// \return False if this is not supported.
+inline
+bool reset_peak_memory_usage()
+{
+#ifdef __linux__
+  std::ofstream out("/proc/self/clear_refs");
+  out << "5";
+  out.flush();
+  return out.good();
+#else
+  return false;
+#endif
+}
+
+/// \brief Returns the peak resident memory of the process in bytes, or 0 if it is unknown.
+inline
+std::size_t peak_memory_usage()
+{
+#ifdef __linux__
+  std::ifstream in("/proc/self/status");
+  std::string line;
+  while (std::getline(in, line))
+  {
+    if (line.compare(0, 6, "VmHWM:") == 0)
+    {
+      return std::stoul(line.substr(6)) * 1024;
+    }
+  }
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) == 0)
+  {
+    return static_cast<std::size_t>(usage.ru_maxrss) * 1024;
+  }
+#endif
+  return 0;
+}
+
+/// \brief Runs benchmark b with the given size the given number of times.
+inline
+benchmark_measurement run_benchmark(const benchmark& b, std::size_t size, std::size_t repetitions)
+{
+  benchmark_measurement result;
+  result.name = b.name;
+  result.size = size;
+  result.items = 0;
+  result.peak_memory = 0;
+  result.peak_memory_is_exact = true;
+  for (std::size_t i = 0; i < std::max(std::size_t(1), repetitions); i++)
+  {
+    result.peak_memory_is_exact = reset_peak_memory_usage() && result.peak_memory_is_exact;
+    benchmark_timer timer;
+    result.items = b.run(size, timer);
+    result.times.push_back(timer.seconds());
+    result.peak_memory = std::max(result.peak_memory, peak_memory_usage());
+  }
+  return result;
+}
+
+/// \brief Writes the header of the table that is written by write_benchmark_row.
+inline
+void write_benchmark_header(std::ostream& out)
+{
+  out << std::left << std::setw(32) << "benchmark" << std::right << std::setw(10) << "size" << std::setw(12) << "items"
+      << std::setw(12) << "min (s)" << std::setw(12) << "median (s)" << std::setw(14) << "items/s" << std::setw(12) << "peak (MB)" << "\n";
+}
+
+/// \brief Writes a measurement as a row of a table.
+inline
+void write_benchmark_row(std::ostream& out, const benchmark_measurement& m)
+{
+  out << std::left << std::setw(32) << m.name << std::right << std::setw(10) << m.size << std::setw(12) << m.items
+      << std::fixed << std::setprecision(4) << std::setw(12) << m.minimum_time() << std::setw(12) << m.median_time()
+      << std::setprecision(0) << std::setw(14) << m.throughput()
+      << std::setprecision(1) << std::setw(12) << m.peak_memory / (1024.0 * 1024.0) << (m.peak_memory_is_exact ? "" : "*") << "\n";
+  out.unsetf(std::ios::floatfield);
+}
+
+/// \brief Writes the measurements as a JSON array.
+inline
+void write_benchmark_json(std::ostream& out, const std::vector<benchmark_measurement>& measurements)
+{
+  out << "[";
+  for (auto i = measurements.begin(); i != measurements.end(); ++i)
+  {
+    out << (i == measurements.begin() ? "\n" : ",\n")
+        << "  {\"name\": " << json_string(i->name) << ", \"size\": " << i->size << ", \"items\": " << i->items
+        << std::setprecision(9) << ", \"min_time\": " << i->minimum_time() << ", \"median_time\": " << i->median_time()
+        << ", \"throughput\": " << i->throughput() << ", \"peak_memory\": " << i->peak_memory
+        << ", \"peak_memory_is_exact\": " << (i->peak_memory_is_exact ? "true" : "false") << ", \"times\": [";
+    for (auto j = i->times.begin(); j != i->times.end(); ++j)
+    {
+      out << (j == i->times.begin() ? "" : ", ") << *j;
+    }
+    out << "]}";
+  }
+  out << "\n]\n";
+}
+
+} // namespace utilities
+
+} // namespace mcrl2
+
+#endif // MCRL2_UTILITIES_BENCHMARK_H
@@ -21,7 +21,10 @@
 #include "mcrl2/utilities/exception.h"
 #include "mcrl2/utilities/hash_utility.h"
 #include <algorithm>
+#include <cassert>
+#include <iterator>
 #include <limits>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -150,6 +153,171 @@ namespace detail
 
     return resultls + (resultms << (no_of_bits_per_digit/2));
   }
+
+  /// \brief A vector of digits for big natural numbers. Up to two digits are stored in the object
+  ///        itself. Only larger numbers use memory on the heap. As most numbers, and products of
+  ///        two such numbers, are small, this avoids nearly all allocations.
+  class digit_vector
+  {
+    protected:
+      static std::size_t inline_capacity()
+      {
+        return 2;
+      }
+
+      std::size_t m_size = 0;
+      std::size_t m_capacity = inline_capacity();
+      std::unique_ptr<std::size_t[]> m_heap;
+      std::size_t m_inline[2] = { 0, 0 };
+
+      void grow(std::size_t capacity)
+      {
+        std::unique_ptr<std::size_t[]> heap(new std::size_t[capacity]);
+        std::copy(data(), data() + m_size, heap.get());
+        m_heap = std::move(heap);
+        m_capacity = capacity;
+      }
+
+    public:
+      typedef std::size_t value_type;
+      typedef std::size_t* iterator;
+      typedef const std::size_t* const_iterator;
+      typedef std::reverse_iterator<iterator> reverse_iterator;
+      typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+      digit_vector() = default;
+
+      digit_vector(const digit_vector& other)
+      {
+        *this = other;
+      }
+
+      digit_vector(digit_vector&& other) noexcept
+      {
+        swap(other);
+      }
+
+      digit_vector& operator=(const digit_vector& other)
+      {
+        if (this != &other)
+        {
+          reserve(other.m_size);
+          std::copy(other.begin(), other.end(), data());
+          m_size = other.m_size;
+        }
+        return *this;
+      }
+
+      digit_vector& operator=(digit_vector&& other) noexcept
+      {
+        swap(other);
+        return *this;
+      }
+
+      std::size_t* data()
+      {
+        return m_heap ? m_heap.get() : m_inline;
+      }
+
+      const std::size_t* data() const
+      {
+        return m_heap ? m_heap.get() : m_inline;
+      }
+
+      std::size_t size() const
+      {
+        return m_size;
+      }
+
+      bool empty() const
+      {
+        return m_size == 0;
+      }
+
+      iterator begin() { return data(); }
+      iterator end() { return data() + m_size; }
+      const_iterator begin() const { return data(); }
+      const_iterator end() const { return data() + m_size; }
+      reverse_iterator rbegin() { return reverse_iterator(end()); }
+      reverse_iterator rend() { return reverse_iterator(begin()); }
+      const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+      const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+
+      std::size_t& operator[](std::size_t i)
+      {
+        assert(i < m_size);
+        return data()[i];
+      }
+
+      std::size_t operator[](std::size_t i) const
+      {
+        assert(i < m_size);
+        return data()[i];
+      }
+
+      std::size_t& front() { return (*this)[0]; }
+      std::size_t front() const { return (*this)[0]; }
+      std::size_t& back() { return (*this)[m_size - 1]; }
+      std::size_t back() const { return (*this)[m_size - 1]; }
+
+      void reserve(std::size_t capacity)
+      {
+        if (capacity > m_capacity)
+        {
+          grow((std::max)(capacity, 2 * m_capacity));
+        }
+      }
+
+      void push_back(std::size_t n)
+      {
+        reserve(m_size + 1);
+        data()[m_size++] = n;
+      }
+
+      void pop_back()
+      {
+        assert(m_size > 0);
+        m_size--;
+      }
+
+      void clear()
+      {
+        m_size = 0;
+      }
+
+      /// \brief Changes the size to n. New digits are zero.
+      void resize(std::size_t n)
+      {
+        reserve(n);
+        std::fill(data() + (std::min)(n, m_size), data() + n, 0);
+        m_size = n;
+      }
+
+      void swap(digit_vector& other) noexcept
+      {
+        if (!m_heap || !other.m_heap)
+        {
+          // At least one of the digits is stored inline; exchange the inline parts explicitly.
+          std::size_t buffer[2];
+          std::copy(m_inline, m_inline + 2, buffer);
+          std::copy(other.m_inline, other.m_inline + 2, m_inline);
+          std::copy(buffer, buffer + 2, other.m_inline);
+        }
+        std::swap(m_size, other.m_size);
+        std::swap(m_capacity, other.m_capacity);
+        m_heap.swap(other.m_heap);
+      }
+
+      bool operator==(const digit_vector& other) const
+      {
+        return m_size == other.m_size && std::equal(begin(), end(), other.begin());
+      }
+
+      bool operator!=(const digit_vector& other) const
+      {
+        return !(*this == other);
+      }
+  };
 } // namespace detail
 
 class big_natural_number;
@@ -164,7 +332,7 @@ class big_natural_number
     // Numbers are stored as std::size_t words, with the most significant number last. 
     // Note that the number representation is not unique. Numbers have no trailing
     // zero's, i.e., this->back()!=0 (if this->size()>0). Therefore their representation is unique.
-    std::vector<std::size_t> m_number;
+    detail::digit_vector m_number;
 
     /* Multiply the current number by n and add the carry */
     void multiply_by(std::size_t n, std::size_t carry)
@@ -265,6 +433,15 @@ class big_natural_number
       return m_number.size()==1 && m_number.front()==n;
     }
 
+    /** \brief Returns whether this number fits in a std::size_t, i.e., whether it can be
+               transformed to a machine size number.
+    */
+    bool is_machine_number() const
+    {
+      is_well_defined();
+      return m_number.size()<=1;
+    }
+
     /** \brief Sets the number to zero.
         \details This is more efficient than using an assignment x=0.
     */
@@ -322,8 +499,8 @@ class big_natural_number
         return false;
       }
       assert(m_number.size()==other.m_number.size());
-      std::vector<std::size_t>::const_reverse_iterator j=other.m_number.rbegin();
-      for(std::vector<std::size_t>::const_reverse_iterator i=m_number.rbegin(); i!=m_number.rend(); ++i, ++j)
+      detail::digit_vector::const_reverse_iterator j=other.m_number.rbegin();
+      for(detail::digit_vector::const_reverse_iterator i=m_number.rbegin(); i!=m_number.rend(); ++i, ++j)
       {
         if (*i < *j)
         {
@@ -364,7 +541,7 @@ class big_natural_number
     std::size_t divide_by(std::size_t n)
     {
       std::size_t remainder=0;
-      for(std::vector<std::size_t>::reverse_iterator i=m_number.rbegin(); i!=m_number.rend(); ++i)
+      for(detail::digit_vector::reverse_iterator i=m_number.rbegin(); i!=m_number.rend(); ++i)
       {
         *i=detail::divide_single_number(*i,n,remainder);
       }
@@ -784,8 +961,13 @@ struct hash< mcrl2::utilities::big_natural_number >
 {
   std::size_t operator()(const mcrl2::utilities::big_natural_number& n) const
   {
-    hash<std::vector<std::size_t> > hasher;
-    return hasher(n.m_number);
+    // This is the same hash as that of a std::vector of the digits.
+    std::size_t hash=0;
+    for(std::size_t digit: n.m_number)
+    {
+      hash = mcrl2::utilities::detail::hash_combine(hash,std::hash<std::size_t>()(digit));
+    }
+    return hash;
   }
 };
 
@@ -13,11 +13,19 @@
 #define MCRL2_UTILITIES_EXECUTION_TIMER_H
 
 #include "mcrl2/utilities/exception.h"
+#include <chrono>
 #include <ctime>
 #include <fstream>
-#include <map>
+#include <functional>
+#include <iostream>
 #include <sstream>
 #include <string>
+#include <utility>
+#include <vector>
+
+#ifdef __linux__
+#include <sys/resource.h>
+#endif
 
 namespace mcrl2
 {
@@ -25,7 +33,7 @@ namespace mcrl2
 namespace utilities
 {
 
-/// \brief Simple timer to time the CPU time used by a piece of code.
+/// \brief Timer to measure the phases of a piece of code.
 ///
 /// Example usage:
 /// execution_timer timer("test_tool", "/path/to/file")
@@ -34,60 +42,138 @@ namespace utilities
 /// timer.finish("hint")
 /// timer.report()
 ///
-/// This will output the following to the file "/path/to/file", or
-/// standard error if filename is empty, assuming that the time between
-/// start and finish is n seconds (with precision of 2 decimal places).
+/// Timings can be nested: a timing that is started while another one is running becomes
+/// a phase of it. If a timing with the same name is started again in the same parent,
+/// the measurements are accumulated. For each timing the number of calls, the wall clock
+/// time, the CPU time, the increase of the peak resident memory of the process, and the
+/// increase of each registered counter (for example the number of terms) are recorded.
+///
+/// The report is written to the file "/path/to/file", or standard error if filename is
+/// empty, in the following format, which can immediately be parsed using YAML
+/// (http://www.yaml.org/):
 /// - tool: test_tool
 ///   timing:
-///     hint: n
-///
-/// Note that this is an output format that can immediately be parsed using
-/// YAML (http://www.yaml.org/)
+///     hint:
+///       calls: 1
+///       wall: 1.50
+///       cpu: 1.45
+///       peak_memory_increase: 1048576
+///       aterms: 1000
+///       phases:
+///         ...
 class execution_timer
 {
+  public:
+    /// \brief A counter of which the increase during each timing is reported.
+    typedef std::function<long long()> counter;
+
+    /// \brief Registers a counter that is sampled at the start and at the finish of every timing.
+    static void register_counter(const std::string& name, counter f)
+    {
+      counters().emplace_back(name, f);
+    }
+
   protected:
+    static std::vector<std::pair<std::string, counter> >& counters()
+    {
+      static std::vector<std::pair<std::string, counter> > m_counters;
+      return m_counters;
+    }
+
+    /// \brief The values of the clocks, the peak memory and the counters at some moment.
+    struct measurement
+    {
+      std::chrono::steady_clock::time_point wall;
+      double cpu = 0.0;              // in seconds
+      std::size_t peak_memory = 0;   // in bytes, or 0 if unknown
+      std::vector<long long> counters;
 
-    /// \brief Pair of start and finish times
+      static measurement now()
+      {
+        measurement result;
+        result.wall = std::chrono::steady_clock::now();
+#ifdef __linux__
+        struct rusage usage;
+        if (getrusage(RUSAGE_SELF, &usage) == 0)
+        {
+          result.cpu = usage.ru_utime.tv_sec + usage.ru_stime.tv_sec + (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+          result.peak_memory = static_cast<std::size_t>(usage.ru_maxrss) * 1024;
+        }
+#else
+        result.cpu = static_cast<double>(clock()) / CLOCKS_PER_SEC;
+#endif
+        for (const auto& p: execution_timer::counters())
+        {
+          result.counters.push_back(p.second());
+        }
+        return result;
+      }
+    };
+
+    /// \brief The accumulated measurements of a timing.
     struct timing
     {
-      clock_t start;
-      clock_t finish;
+      std::string name;
+      std::size_t parent;
+      std::vector<std::size_t> children;
+      std::size_t calls = 0;
+      bool running = false;
+      double wall_time = 0.0;
+      double cpu_time = 0.0;
+      std::size_t peak_memory_increase = 0;
+      std::vector<long long> counter_increases;
+      measurement start;
 
-      timing() :
-        start(0),
-        finish(0)
+      timing(const std::string& name_, std::size_t parent_)
+        : name(name_), parent(parent_)
       {}
     };
 
     std::string m_tool_name; //!< name of the tool we are timing
     std::string m_filename; //!< name of the file to write timings to
-    std::map<std::string, timing> m_timings; //!< collection of timings
+    std::vector<timing> m_timings; //!< the tree of timings; m_timings[0] is the root, which is never started
+    std::size_t m_current; //!< the innermost running timing
 
-    /// \brief Write the report to an output stream.
-    /// \param[in] s The output stream to which the report is written.
-    void write_report(std::ostream& s)
+    /// \brief Finishes the innermost running timing.
+    void finish_current()
     {
-      s.setf(std::ios::fixed, std::ios::floatfield); // Print floats in 2 decimals
-      s.precision(2);
-
-      s << "- tool: " << m_tool_name << std::endl
-        << "  timing:" << std::endl;
+      measurement m = measurement::now();
+      timing& t = m_timings[m_current];
+      t.calls++;
+      t.running = false;
+      t.wall_time += std::chrono::duration<double>(m.wall - t.start.wall).count();
+      t.cpu_time += m.cpu - t.start.cpu;
+      t.peak_memory_increase += m.peak_memory - t.start.peak_memory;
+      t.counter_increases.resize(m.counters.size(), 0);
+      for (std::size_t i = 0; i < m.counters.size() && i < t.start.counters.size(); i++)
+      {
+        t.counter_increases[i] += m.counters[i] - t.start.counters[i];
+      }
+      m_current = t.parent;
+    }
 
-      for (std::map<std::string, timing>::const_iterator i = m_timings.begin(); i != m_timings.end(); ++i)
+    void write_timing(std::ostream& s, std::size_t index, const std::string& indent) const
+    {
+      const timing& t = m_timings[index];
+      s << indent << t.name << ":" << std::endl;
+      if (t.running)
       {
-        if (i->second.finish==0)
-        {
-          s << "    " << i->first << ": did not finish. " << std::endl;
-        }
-        else if (i->second.start > i->second.finish)
-        {
-          throw mcrl2::runtime_error("Start of " + i->first + " occurred after finish.");
-        }
-        else
+        s << indent << "  unfinished: true" << std::endl;
+      }
+      s << indent << "  calls: " << t.calls << std::endl
+        << indent << "  wall: " << t.wall_time << std::endl
+        << indent << "  cpu: " << t.cpu_time << std::endl
+        << indent << "  peak_memory_increase: " << t.peak_memory_increase << std::endl;
+      for (std::size_t i = 0; i < t.counter_increases.size(); i++)
+      {
+        s << indent << "  " << counters()[i].first << ": " << t.counter_increases[i] << std::endl;
+      }
+      if (!t.children.empty())
+      {
+        s << indent << "  phases:" << std::endl;
+        for (std::size_t child: t.children)
         {
-          s << "    " << i->first << ": "
-            << (static_cast<float>(i->second.finish - i->second.start))/CLOCKS_PER_SEC 
-            << std::endl;
+          write_timing(s, child, indent + "    ");
         }
       }
     }
@@ -99,39 +185,72 @@ class execution_timer
     /// \param[in] filename Name of the file to which the measurements are written
     execution_timer(const std::string& tool_name = "", std::string const& filename = "") :
       m_tool_name(tool_name),
-      m_filename(filename)
-    {}
-
-    /// \brief Destructor
-    ~execution_timer()
+      m_filename(filename),
+      m_timings(1, timing("", 0)),
+      m_current(0)
     {}
 
     /// \brief Start measurement with a hint
     /// \param[in] timing_name Name of the measurement being started
-    /// \pre No start(timing_name) has occurred before
-    /// \post The current time has been recorded as starting time of timing_name
+    /// \post The current time has been recorded as starting time of timing_name, which is a phase
+    /// of the timing that is running.
     void start(const std::string& timing_name)
     {
-      if (m_timings.find(timing_name) != m_timings.end())
+      std::size_t index = m_timings.size();
+      for (std::size_t child: m_timings[m_current].children)
       {
-        throw mcrl2::runtime_error("Starting already known timing: " + timing_name + ". This causes unreliable results.");
+        if (m_timings[child].name == timing_name)
+        {
+          index = child;
+        }
       }
-      timing t;
-      t.start = clock();
-      m_timings[timing_name] = t;
+      if (index == m_timings.size())
+      {
+        m_timings.emplace_back(timing_name, m_current);
+        m_timings[m_current].children.push_back(index);
+      }
+      timing& t = m_timings[index];
+      t.running = true;
+      m_current = index;
+      t.start = measurement::now();
     }
 
     /// \brief Finish a measurement with a hint
     /// \param[in] timing_name Name of the measurment being finished
     /// \pre A start(timing_name) was executed before
-    /// \post The current time has been recorded as end time of timing_name
+    /// \post The current time has been recorded as end time of timing_name. Phases of timing_name
+    /// that are still running are finished as well.
     void finish(const std::string& timing_name)
     {
-      if (m_timings.find(timing_name) == m_timings.end())
+      std::size_t index = m_current;
+      while (index != 0 && m_timings[index].name != timing_name)
+      {
+        index = m_timings[index].parent;
+      }
+      if (index == 0)
       {
         throw mcrl2::runtime_error("Finishing timing '" + timing_name + "' that was not started.");
       }
-      m_timings[timing_name].finish = clock();
+      while (m_current != index)
+      {
+        finish_current();
+      }
+      finish_current();
+    }
+
+    /// \brief Write the report to an output stream.
+    /// \param[in] s The output stream to which the report is written.
+    void write_report(std::ostream& s) const
+    {
+      s.setf(std::ios::fixed, std::ios::floatfield); // Print floats in 3 decimals
+      s.precision(3);
+
+      s << "- tool: " << m_tool_name << std::endl
+        << "  timing:" << std::endl;
+      for (std::size_t child: m_timings[0].children)
+      {
+        write_timing(s, child, "    ");
+      }
     }
 
     /// \brief Write all timing information that has been recorded.
@@ -140,7 +259,7 @@ class execution_timer
     /// the constructor. If no filename was provided (i.e. the filename is
     /// empty) the information is written to standard error.
     /// The output is in YAML compatible format.
-    void report()
+    void report() const
     {
       if (m_filename.empty())
       {
@@ -154,7 +273,76 @@ class execution_timer
         out.close();
       }
     }
+};
+
+template <class T> // note, T is only a dummy
+struct execution_timer_pointer
+{
+  static execution_timer* timer;
+};
+
+template <class T>
+execution_timer* execution_timer_pointer<T>::timer = nullptr;
+
+/// \brief Returns the timer in which the phases of the libraries are recorded, or nullptr if timing is disabled.
+inline
+execution_timer* active_execution_timer()
+{
+  return execution_timer_pointer<int>::timer;
+}
+
+/// \brief Sets the timer in which the phases of the libraries are recorded. Timing is disabled by passing nullptr.
+inline
+void set_active_execution_timer(execution_timer* timer)
+{
+  execution_timer_pointer<int>::timer = timer;
+}
 
+/// \brief Measures a phase from its construction until its destruction. If the timer is nullptr
+/// nothing is measured.
+class scoped_timer
+{
+  protected:
+    execution_timer* m_timer;
+    std::string m_name;
+
+  public:
+    explicit scoped_timer(const std::string& name, execution_timer* timer = active_execution_timer())
+      : m_timer(timer), m_name(name)
+    {
+      if (m_timer)
+      {
+        m_timer->start(m_name);
+      }
+    }
+
+    scoped_timer(const scoped_timer&) = delete;
+    scoped_timer& operator=(const scoped_timer&) = delete;
+
+    /// \brief Finishes the phase before the end of the scope.
+    void finish()
+    {
+      if (m_timer)
+      {
+        execution_timer* timer = m_timer;
+        m_timer = nullptr;
+        timer->finish(m_name);
+      }
+    }
+
+    /// \brief Finishes the phase, unless it was finished already. The phase is also finished if
+    /// a phase in which it is nested has been finished explicitly, in which case nothing is done.
+    ~scoped_timer()
+    {
+      try
+      {
+        finish();
+      }
+      catch (const mcrl2::runtime_error&)
+      {
+        // The phase was finished together with an enclosing phase.
+      }
+    }
 };
 
 } // namespace utilities
@@ -11,6 +11,8 @@
 #ifndef MCRL2_UTILITIES_LOGGER_H
 #define MCRL2_UTILITIES_LOGGER_H
 
+#include <algorithm>
+#include <atomic>
 #include <cstdio>
 #include <ctime>
 #include <map>
@@ -216,6 +218,26 @@ class logger
       }
     }
 
+    /// \brief The maximum of the reporting levels of all hints. Messages above this level
+    /// are discarded without looking up the level of their hint.
+    static
+    std::atomic<log_level_t>& maximal_reporting_level_value()
+    {
+      static std::atomic<log_level_t> m_maximal_reporting_level(info);
+      return m_maximal_reporting_level;
+    }
+
+    static
+    void update_maximal_reporting_level()
+    {
+      log_level_t result = default_reporting_level();
+      for (const auto& p: hint_to_level())
+      {
+        result = (std::max)(result, p.second);
+      }
+      maximal_reporting_level_value().store(result, std::memory_order_relaxed);
+    }
+
   public:
     /// \brief Default constructor
     logger()
@@ -271,6 +293,7 @@ class logger
     void set_reporting_level(const log_level_t level, const std::string& hint = default_hint())
     {
       hint_to_level()[hint] = level;
+      update_maximal_reporting_level();
     }
 
     /// \brief Get reporting level
@@ -295,6 +318,14 @@ class logger
     void clear_reporting_level(const std::string& hint)
     {
       hint_to_level().erase(hint);
+      update_maximal_reporting_level();
+    }
+
+    /// \brief Returns the maximum of the reporting levels of all hints.
+    static
+    log_level_t maximal_reporting_level()
+    {
+      return maximal_reporting_level_value().load(std::memory_order_relaxed);
     }
 
     /// \brief Indicate that timing information should be printed.
@@ -503,11 +534,13 @@ typedef logger mcrl2_logger;
 #define MCRL2_MAX_LOG_LEVEL mcrl2::log::debug
 #endif
 
-/// mCRL2log(level) provides the function used to log. It performs two
+/// mCRL2log(level) provides the function used to log. It performs three
 /// optimisations:
 /// - the first comparison (level > MCRL2_MAX_LOG_LEVEL), compares two constants
 ///   during compile time. The compiler will not create any code if (level > MCRl2_MAX_LOG_LEVEL).
-/// - the second comparison compares two constants at runtime. This check makes
+/// - the second comparison compares level to the maximal reporting level of all hints,
+///   which is a single load. Hence a disabled message does not cause a lookup of its hint.
+/// - the third comparison compares level to the reporting level of the hint. This check makes
 ///   sure that the arguments to mCRL2log(level) will not be evaluated if level > file_logger::reporting_level().
 /// In all other cases this macro provides a stream that can be printed to.
 // Note that the macro uses the dirty preprocessor token concatenation. For a
@@ -517,11 +550,12 @@ typedef logger mcrl2_logger;
 // to allow mCRL2log(level) as well as mCRL2log(level, "hint")
 #define mCRL2log(level, ...) \
 if ((level) > MCRL2_MAX_LOG_LEVEL) ; \
+else if ((level) > mcrl2::log::mcrl2_logger::maximal_reporting_level()) ; \
 else if ((level) > (mcrl2::log::mcrl2_logger::get_reporting_level(__VA_ARGS__))) ; \
 else mcrl2::log::mcrl2_logger().get(level, ##__VA_ARGS__)
 
 #define mCRL2logEnabled(level, ...) \
-(((level) <= MCRL2_MAX_LOG_LEVEL) && ((level) <= (mcrl2::log::mcrl2_logger::get_reporting_level(__VA_ARGS__))))
+(((level) <= MCRL2_MAX_LOG_LEVEL) && ((level) <= mcrl2::log::mcrl2_logger::maximal_reporting_level()) && ((level) <= (mcrl2::log::mcrl2_logger::get_reporting_level(__VA_ARGS__))))
 
   } // namespace log
 } // namespace mcrl2
@@ -133,6 +133,10 @@ std::string word_wrap_text(const std::string& text, unsigned int max_line_length
 /// \return True if s is of the form "0 | -? [1-9][0-9]*", false otherwise
 bool is_numeric_string(const std::string& s);
 
+/// \brief Returns s as a JSON string literal, i.e. between double quotes and with special characters escaped.
+/// \param s A string of text.
+std::string json_string(const std::string& s);
+
 /// \brief Convert a number to a string in the buffer starting at position start_position.
 /// \param number The number to be converted.
 /// \param buffer A buffer in which the string will be stored that is sufficiently large.
@@ -70,8 +70,9 @@ class tool
     virtual void add_options(interface_description& desc)
     {
       desc.add_option("timings", make_optional_argument<std::string>("FILE", ""),
-                      "append timing measurements to FILE. Measurements are written to "
-                      "standard error if no FILE is provided");
+                      "append timing measurements to FILE. For every (nested) phase the number of calls, "
+                      "the wall clock time, the CPU time and the increase of the peak memory are written. "
+                      "Measurements are written to standard error if no FILE is provided");
     }
 
     /// \brief Parse non-standard options
@@ -219,9 +220,15 @@ class tool
             // method.
             m_timer = execution_timer(m_name, timing_filename());
 
+            // With --timings the phases that are marked in the libraries are recorded as well.
+            if (m_timing_enabled)
+            {
+              set_active_execution_timer(&m_timer);
+            }
             timer().start("total");
             result = run();
             timer().finish("total");
+            set_active_execution_timer(nullptr);
 
             if (m_timing_enabled)
             {
@@ -246,6 +253,7 @@ class tool
       {
         mCRL2log(mcrl2::log::error) << e.what() << std::endl;
       }
+      set_active_execution_timer(nullptr);
       return EXIT_FAILURE;
     }
 };
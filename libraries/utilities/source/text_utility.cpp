@@ -221,6 +221,36 @@ bool is_numeric_string(const std::string& s)
   return boost::xpressive::regex_match(s, re);
 }
 
+std::string json_string(const std::string& s)
+{
+  std::string result = "\"";
+  for (char c: s)
+  {
+    switch (c)
+    {
+      case '"': result += "\\\""; break;
+      case '\\': result += "\\\\"; break;
+      case '\n': result += "\\n"; break;
+      case '\r': result += "\\r"; break;
+      case '\t': result += "\\t"; break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20)
+        {
+          const char* digits = "0123456789abcdef";
+          result += "\\u00";
+          result += digits[(c >> 4) & 0xf];
+          result += digits[c & 0xf];
+        }
+        else
+        {
+          result += c;
+        }
+    }
+  }
+  result += '"';
+  return result;
+}
+
 std::string trim_copy(const std::string& text)
 {
   return boost::trim_copy(text);
@@ -128,6 +128,26 @@ BOOST_AUTO_TEST_CASE(cumulative_tests)
 }
 
 
+// Small numbers are stored inside the object and large ones on the heap. Check copying and swapping between them.
+BOOST_AUTO_TEST_CASE(copy_and_swap_test)
+{
+  const big_natural_number small(12);
+  const big_natural_number large("349857349587453098713409835719348571930857");
+  big_natural_number x=small;
+  big_natural_number y=large;
+  swap(x,y);
+  BOOST_CHECK(x==large && y==small);
+  swap(x,y);
+  BOOST_CHECK(x==small && y==large);
+  x=y;
+  BOOST_CHECK(x==large);
+  x=small;
+  BOOST_CHECK(x==small);
+  big_natural_number z(std::move(y));
+  BOOST_CHECK(z==large);
+  BOOST_CHECK(std::hash<big_natural_number>()(z)==std::hash<big_natural_number>()(large));
+}
+
 boost::unit_test::test_suite* init_unit_test_suite(int argc, char* argv[])
 {
   return nullptr;
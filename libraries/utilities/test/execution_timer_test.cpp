@@ -0,0 +1,134 @@
+// Author(s): Wieger Wesselink
+// Copyright: see the accompanying file COPYING or copy at
+// https://svn.win.tue.nl/trac/MCRL2/browser/trunk/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file execution_timer_test.cpp
+/// \brief Tests for the execution timer.
+
+#define BOOST_TEST_MODULE execution_timer_test
+#include <boost/test/included/unit_test_framework.hpp>
+
+#include "mcrl2/utilities/execution_timer.h"
+
+using namespace mcrl2;
+using utilities::execution_timer;
+
+std::string report(const execution_timer& timer)
+{
+  std::ostringstream out;
+  timer.write_report(out);
+  return out.str();
+}
+
+// Returns the lines of text that contain the given string.
+std::vector<std::string> find_lines(const std::string& text, const std::string& s)
+{
+  std::vector<std::string> result;
+  std::istringstream in(text);
+  std::string line;
+  while (std::getline(in, line))
+  {
+    if (line.find(s) != std::string::npos)
+    {
+      result.push_back(line);
+    }
+  }
+  return result;
+}
+
+BOOST_AUTO_TEST_CASE(test_nested_timings)
+{
+  static long long value = 0;
+  execution_timer::register_counter("test_counter", []() { return value; });
+
+  execution_timer timer("test_tool");
+  timer.start("total");
+  for (int i = 0; i < 3; i++)
+  {
+    utilities::scoped_timer timing("phase", &timer);
+    value += 5;
+    {
+      utilities::scoped_timer timing("subphase", &timer);
+    }
+  }
+  timer.finish("total");
+
+  std::string text = report(timer);
+  BOOST_CHECK(text.find("- tool: test_tool\n  timing:\n    total:\n      calls: 1\n") == 0);
+  BOOST_CHECK(text.find("\n      phases:\n        phase:\n          calls: 3\n") != std::string::npos);
+  BOOST_CHECK(text.find("\n          phases:\n            subphase:\n              calls: 3\n") != std::string::npos);
+
+  // The counter increases are accumulated over the calls.
+  std::vector<std::string> counters = find_lines(text, "test_counter:");
+  BOOST_REQUIRE_EQUAL(counters.size(), 3u);
+  BOOST_CHECK_EQUAL(counters[0], "      test_counter: 15");
+  BOOST_CHECK_EQUAL(counters[1], "          test_counter: 15");
+  BOOST_CHECK_EQUAL(counters[2], "              test_counter: 0");
+}
+
+BOOST_AUTO_TEST_CASE(test_finish)
+{
+  execution_timer timer("test_tool");
+  timer.start("a");
+  timer.start("b");
+
+  // Finishing a finishes b as well.
+  timer.finish("a");
+  BOOST_CHECK(find_lines(report(timer), "unfinished").empty());
+  BOOST_CHECK_THROW(timer.finish("b"), mcrl2::runtime_error);
+
+  // A timing that is started again is accumulated.
+  timer.start("a");
+  BOOST_CHECK_EQUAL(find_lines(report(timer), "unfinished").size(), 1u);
+  timer.finish("a");
+  BOOST_CHECK_EQUAL(find_lines(report(timer), "calls: 2").size(), 1u);
+}
+
+BOOST_AUTO_TEST_CASE(test_scoped_timer_finish)
+{
+  execution_timer timer("test_tool");
+  {
+    utilities::scoped_timer timing("a", &timer);
+    timing.finish();
+    BOOST_CHECK(find_lines(report(timer), "unfinished").empty());
+  }
+
+  // The destructor of a scoped timer does not throw if its phase was finished with an enclosing phase.
+  timer.start("b");
+  {
+    utilities::scoped_timer timing("c", &timer);
+    timer.finish("b");
+  }
+  BOOST_CHECK(find_lines(report(timer), "unfinished").empty());
+
+  // A phase is finished if an exception leaves its scope.
+  try
+  {
+    utilities::scoped_timer timing("d", &timer);
+    throw mcrl2::runtime_error("error");
+  }
+  catch (const mcrl2::runtime_error&)
+  {
+  }
+  BOOST_CHECK(find_lines(report(timer), "unfinished").empty());
+}
+
+BOOST_AUTO_TEST_CASE(test_active_timer)
+{
+  {
+    // Without an active timer nothing is measured.
+    utilities::scoped_timer timing("phase");
+  }
+
+  execution_timer timer("test_tool");
+  utilities::set_active_execution_timer(&timer);
+  {
+    utilities::scoped_timer timing("phase");
+  }
+  utilities::set_active_execution_timer(nullptr);
+  BOOST_CHECK_EQUAL(find_lines(report(timer), "phase:").size(), 1u);
+}
@@ -12,6 +12,8 @@
 #include <boost/test/auto_unit_test.hpp>
 #include <boost/test/included/unit_test_framework.hpp>
 
+#include <thread>
+#include "mcrl2/utilities/async_logger.h"
 #include "mcrl2/utilities/logger.h"
 
 using namespace mcrl2::log;
@@ -141,3 +143,70 @@ BOOST_AUTO_TEST_CASE(test_multiline_nonewline)
   mCRL2log(info) << "in this message" << std::endl;
 }
 
+
+BOOST_AUTO_TEST_CASE(test_maximal_reporting_level)
+{
+  mcrl2_logger::set_reporting_level(info);
+  BOOST_CHECK_EQUAL(mcrl2_logger::maximal_reporting_level(), info);
+  mcrl2_logger::set_reporting_level(debug, "test_hint");
+  BOOST_CHECK_EQUAL(mcrl2_logger::maximal_reporting_level(), debug);
+  mCRL2log(debug, "test_hint") << "Testing maximal reporting level, should be printed" << std::endl;
+  mcrl2_logger::clear_reporting_level("test_hint");
+  BOOST_CHECK_EQUAL(mcrl2_logger::maximal_reporting_level(), info);
+  mCRL2log(debug, "test_hint") << "Testing maximal reporting level, should not be printed" << test_assert() << std::endl;
+}
+
+// Output policy that stores the messages.
+struct collect_output: public output_policy
+{
+  std::vector<std::string> messages;
+
+  void output(const log_level_t, const std::string&, const time_t, const std::string& msg, const bool) override
+  {
+    messages.push_back(msg);
+  }
+};
+
+BOOST_AUTO_TEST_CASE(test_async_logging)
+{
+  const std::size_t thread_count = 4;
+  const std::size_t message_count = 1000;
+  collect_output collect;
+  mcrl2_logger::unregister_output_policy(default_output_policy());
+  mcrl2_logger::register_output_policy(collect);
+  {
+    // A small capacity, such that the threads have to wait for the writer.
+    async_logging logging(collect, 16);
+    std::vector<std::thread> threads;
+    for (std::size_t i = 0; i < thread_count; i++)
+    {
+      threads.emplace_back([i, message_count]()
+        {
+          for (std::size_t j = 0; j < message_count; j++)
+          {
+            mCRL2log(info) << i << " " << j << std::endl;
+          }
+        });
+    }
+    for (std::thread& t: threads)
+    {
+      t.join();
+    }
+    mCRL2log(info) << "done" << std::endl;
+  }
+  mcrl2_logger::unregister_output_policy(collect);
+  mcrl2_logger::register_output_policy(default_output_policy());
+
+  // All messages arrive, and the messages of each thread are in order.
+  BOOST_REQUIRE_EQUAL(collect.messages.size(), thread_count * message_count + 1);
+  BOOST_CHECK_EQUAL(collect.messages.back(), "done\n");
+  std::vector<std::size_t> next(thread_count, 0);
+  for (std::size_t k = 0; k + 1 < collect.messages.size(); k++)
+  {
+    std::istringstream in(collect.messages[k]);
+    std::size_t i, j;
+    in >> i >> j;
+    BOOST_REQUIRE(i < thread_count);
+    BOOST_CHECK_EQUAL(j, next[i]++);
+  }
+}
@@ -8,59 +8,84 @@
 //
 /// \file ltstransform.cpp
 
+#include <deque>
 #include <iostream>
-#include <sstream>
 
-#include "mcrl2/core/detail/print_utility.h"
-#include "mcrl2/lts_new/parse.h"
+#include "mcrl2/lts_new/io.h"
+#include "mcrl2/lts_new/remove_duplicate_transitions.h"
 #include "mcrl2/lts_new/remove_tau_action.h"
+#include "mcrl2/lts_new/remove_unused_states.h"
 #include "mcrl2/utilities/detail/command.h"
-#include "mcrl2/utilities/detail/io.h"
 #include "mcrl2/utilities/detail/transform_tool.h"
 #include "mcrl2/utilities/input_output_tool.h"
+#include "mcrl2/utilities/logger.h"
+#include "mcrl2/utilities/text_utility.h"
 
 using namespace mcrl2;
 using utilities::detail::transform_tool;
 using utilities::tools::input_output_tool;
 
+/// \brief A transformation of an LTS. It can be executed on its own, or be one step of a pipeline.
 struct lts_command: public utilities::detail::command
 {
-  lts::labeled_transition_system ltsspec;
+  const bool& binary_output;
 
   lts_command(const std::string& name,
               const std::string& input_filename,
               const std::string& output_filename,
-              const std::vector<std::string>& options
+              const std::vector<std::string>& options,
+              const bool& binary_output_
              )
-    : utilities::detail::command(name, input_filename, output_filename, options)
+    : utilities::detail::command(name, input_filename, output_filename, options),
+      binary_output(binary_output_)
   {}
 
+  virtual void apply(lts::labeled_transition_system& ltsspec) = 0;
+
   void execute() override
   {
-    std::string text = utilities::detail::read_text(input_filename);
-    ltsspec = lts::parse_lts(text);
+    lts::labeled_transition_system ltsspec = lts::load_lts(input_filename);
+    apply(ltsspec);
+    lts::save_lts(output_filename, ltsspec, binary_output);
   }
+};
+
+/// \brief Joins states that are connected by a tau transition
+struct remove_tau_action_command: public lts_command
+{
+  remove_tau_action_command(const std::string& input_filename, const std::string& output_filename, const std::vector<std::string>& options, const bool& binary_output)
+    : lts_command("remove-tau", input_filename, output_filename, options, binary_output)
+  {}
 
-  void save()
+  void apply(lts::labeled_transition_system& ltsspec) override
   {
-    std::ostringstream out;
-    out << ltsspec;
-    utilities::detail::write_text(output_filename, out.str());
+    lts::remove_tau_action(ltsspec);
   }
 };
 
-/// \brief Eliminates trivial process equations of the shape P = Q
-struct remove_tau_action_command: public lts_command
+/// \brief Removes duplicate transitions
+struct remove_duplicate_transitions_command: public lts_command
 {
-  remove_tau_action_command(const std::string& input_filename, const std::string& output_filename, const std::vector<std::string>& options)
-    : lts_command("remove-tau", input_filename, output_filename, options)
+  remove_duplicate_transitions_command(const std::string& input_filename, const std::string& output_filename, const std::vector<std::string>& options, const bool& binary_output)
+    : lts_command("remove-duplicates", input_filename, output_filename, options, binary_output)
   {}
 
-  void execute() override
+  void apply(lts::labeled_transition_system& ltsspec) override
   {
-    lts_command::execute();
-    lts::remove_tau_action(ltsspec);
-    save();
+    lts::remove_duplicate_transitions(ltsspec);
+  }
+};
+
+/// \brief Renumbers the states such that there are no states without transitions, except the initial state
+struct remove_unused_states_command: public lts_command
+{
+  remove_unused_states_command(const std::string& input_filename, const std::string& output_filename, const std::vector<std::string>& options, const bool& binary_output)
+    : lts_command("remove-unused-states", input_filename, output_filename, options, binary_output)
+  {}
+
+  void apply(lts::labeled_transition_system& ltsspec) override
+  {
+    lts::remove_unused_states(ltsspec);
   }
 };
 
@@ -68,19 +93,81 @@ class ltstransform_tool: public transform_tool<input_output_tool>
 {
   typedef transform_tool<input_output_tool> super;
 
+  protected:
+    bool binary_output = false;
+
+    // The options of the steps of a pipeline. A deque is used, since the commands keep references to them.
+    std::deque<std::vector<std::string>> pipeline_options;
+
+    void parse_options(const utilities::command_line_parser& parser) override
+    {
+      super::parse_options(parser);
+      binary_output = parser.options.count("binary") > 0;
+    }
+
+    void add_options(utilities::interface_description& desc) override
+    {
+      super::add_options(desc);
+      desc.add_option("binary", "write the result in binary format instead of .aut format. The input "
+                      "format (binary or .aut) is detected automatically.", 'b');
+    }
+
+    // Applies the algorithms in a comma separated list in one go, such that the LTS is read and written only once.
+    void run_pipeline(const std::vector<std::string>& steps)
+    {
+      std::vector<std::shared_ptr<lts_command>> pipeline;
+      for (const std::string& step: steps)
+      {
+        std::vector<std::string> words = utilities::regex_split(step, "\\s+");
+        pipeline_options.emplace_back(words.begin() + 1, words.end());
+        commands.clear();
+        add_commands(pipeline_options.back());
+        auto i = commands.find(words.front());
+        if (i == commands.end())
+        {
+          throw mcrl2::runtime_error("Unknown algorithm " + words.front());
+        }
+        pipeline.push_back(std::static_pointer_cast<lts_command>(i->second));
+      }
+
+      lts::labeled_transition_system ltsspec = lts::load_lts(input_filename());
+      for (const std::shared_ptr<lts_command>& command: pipeline)
+      {
+        mCRL2log(log::verbose) << "applying " << command->name << " to an LTS with " << ltsspec.number_of_states
+                               << " states and " << ltsspec.transitions.size() << " transitions" << std::endl;
+        command->apply(ltsspec);
+      }
+      lts::save_lts(output_filename(), ltsspec, binary_output);
+    }
+
   public:
     ltstransform_tool()
       : super("ltstransform",
               "Wieger Wesselink",
               "applies a transformation to an LTS",
               "Transform the object in INFILE and write the result to OUTFILE. If OUTFILE "
-              "is not present, stdout is used. If INFILE is not present, stdin is used."
+              "is not present, stdout is used. If INFILE is not present, stdin is used. "
+              "Multiple algorithms can be applied in one run by separating them with commas, "
+              "e.g. -a \"remove-tau,remove-duplicates\"."
              )
     {}
 
     void add_commands(const std::vector<std::string>& options) override
     {
-      add_command(std::make_shared<remove_tau_action_command>(input_filename(), output_filename(), options));
+      add_command(std::make_shared<remove_tau_action_command>(input_filename(), output_filename(), options, binary_output));
+      add_command(std::make_shared<remove_duplicate_transitions_command>(input_filename(), output_filename(), options, binary_output));
+      add_command(std::make_shared<remove_unused_states_command>(input_filename(), output_filename(), options, binary_output));
+    }
+
+    bool run() override
+    {
+      std::vector<std::string> steps = utilities::regex_split(algorithm_and_options, ",");
+      if (algorithm_number >= 0 || steps.size() < 2)
+      {
+        return super::run();
+      }
+      run_pipeline(steps);
+      return true;
     }
 };
 
@@ -176,24 +176,27 @@ class mcrl22lps_tool : public rewriter_tool< input_output_tool >
     {
       //linearise infilename with options
       mcrl2::process::process_specification spec;
-      if (input_filename().empty())
       {
-        //parse specification from stdin
-        mCRL2log(mcrl2::log::verbose) << "Reading input from stdin..." << std::endl;
-        spec = mcrl2::process::parse_process_specification(std::cin, !noalpha);
-      }
-      else
-      {
-        //parse specification from infilename
-        mCRL2log(mcrl2::log::verbose) << "Reading input from file '"
-                                      <<  input_filename() << "'..." << std::endl;
-        std::ifstream instream(input_filename().c_str(), std::ifstream::in|std::ifstream::binary);
-        if (!instream.is_open())
+        mcrl2::utilities::scoped_timer timing("parse + type check process specification", &timer());
+        if (input_filename().empty())
+        {
+          //parse specification from stdin
+          mCRL2log(mcrl2::log::verbose) << "Reading input from stdin..." << std::endl;
+          spec = mcrl2::process::parse_process_specification(std::cin, !noalpha);
+        }
+        else
         {
-          throw mcrl2::runtime_error("Cannot open input file: " + input_filename() + ".");
+          //parse specification from infilename
+          mCRL2log(mcrl2::log::verbose) << "Reading input from file '"
+                                        <<  input_filename() << "'..." << std::endl;
+          std::ifstream instream(input_filename().c_str(), std::ifstream::in|std::ifstream::binary);
+          if (!instream.is_open())
+          {
+            throw mcrl2::runtime_error("Cannot open input file: " + input_filename() + ".");
+          }
+          spec = mcrl2::process::parse_process_specification(instream, !noalpha);
+          instream.close();
         }
-        spec = mcrl2::process::parse_process_specification(instream, !noalpha);
-        instream.close();
       }
       //report on well-formedness (if needed)
       if (opt_check_only)
@@ -211,7 +214,12 @@ class mcrl22lps_tool : public rewriter_tool< input_output_tool >
         return true;
       }
       //store the result
-      mcrl2::lps::stochastic_specification linear_spec(mcrl2::lps::linearise(spec, m_linearisation_options));
+      mcrl2::lps::stochastic_specification linear_spec;
+      {
+        mcrl2::utilities::scoped_timer timing("linearise", &timer());
+        linear_spec = mcrl2::lps::linearise(spec, m_linearisation_options);
+      }
+      mcrl2::utilities::scoped_timer timing("save LPS", &timer());
       mCRL2log(mcrl2::log::verbose) << "Writing LPS to "
                                     << (output_filename().empty() ? "stdout"
                                                                   : "file " + output_filename())
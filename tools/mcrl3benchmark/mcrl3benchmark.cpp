@@ -0,0 +1,603 @@
+// Author(s): Wieger Wesselink
+// Copyright: see the accompanying file COPYING or copy at
+// https://github.com/mCRL2org/mCRL2/blob/master/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file mcrl3benchmark.cpp
+
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include "mcrl2/atermpp/aterm_appl.h"
+#include "mcrl2/atermpp/aterm_int.h"
+#include "mcrl2/atermpp/aterm_io.h"
+#include "mcrl2/atermpp/aterm_list.h"
+#include "mcrl2/atermpp/indexed_set.h"
+#include "mcrl2/data/enumerator.h"
+#include "mcrl2/data/parse.h"
+#include "mcrl2/data/rewriter.h"
+#include "mcrl2/lps/linearise.h"
+#include "mcrl2/lts/detail/exploration.h"
+#include "mcrl2/lts/detail/liblts_bisim_parallel.h"
+#include "mcrl2/lts/detail/liblts_sim_bit_matrix.h"
+#include "mcrl2/lts/detail/liblts_weak_bisim.h"
+#include "mcrl2/lts/lts_algorithm.h"
+#include "mcrl2/lts/lts_aut.h"
+#include "mcrl2/utilities/benchmark.h"
+#include "mcrl2/utilities/tool.h"
+
+using namespace mcrl2;
+using utilities::benchmark;
+using utilities::benchmark_timer;
+using utilities::tools::tool;
+
+// The specification of n dining philosophers, with n forks.
+std::string dining_philosophers(std::size_t n)
+{
+  const std::string N = std::to_string(n);
+  std::ostringstream out;
+  out << "act get, put, up, down, lock, free: Nat # Nat;\n"
+         "    eat: Nat;\n"
+         "proc Phil(i: Nat) = get(i, i) . get(i, (i + 1) mod " << N << ") . eat(i) . put(i, i) . put(i, (i + 1) mod " << N << ") . Phil(i);\n"
+         "     Fork(f: Nat) = sum p: Nat . (p < " << N << ") -> up(p, f) . down(p, f) . Fork(f);\n"
+         "init allow({lock, free, eat}, comm({get|up -> lock, put|down -> free}, ";
+  for (std::size_t i = 0; i < n; i++)
+  {
+    out << "Phil(" << i << ") || Fork(" << i << ")" << (i + 1 < n ? " || " : "");
+  }
+  out << "));\n";
+  return out.str();
+}
+
+// The specification of a ring of n nodes that pass a token. The node with the token can increment a
+// local counter modulo 3.
+std::string token_ring(std::size_t n)
+{
+  const std::string N = std::to_string(n);
+  std::ostringstream out;
+  out << "act send, receive, pass, work: Nat;\n"
+         "proc Node(i: Nat, token: Bool, c: Nat) =\n"
+         "       token -> work(i) . Node(i, token, (c + 1) mod 3)\n"
+         "     + token -> send((i + 1) mod " << N << ") . Node(i, false, c)\n"
+         "     + !token -> receive(i) . Node(i, true, c);\n"
+         "init allow({pass, work}, comm({send|receive -> pass}, ";
+  for (std::size_t i = 0; i < n; i++)
+  {
+    out << "Node(" << i << ", " << (i == 0 ? "true" : "false") << ", 0)" << (i + 1 < n ? " || " : "");
+  }
+  out << "));\n";
+  return out.str();
+}
+
+// The specification of a chain of n one place buffers with data values d1 and d2.
+std::string buffer_chain(std::size_t n)
+{
+  std::ostringstream out;
+  out << "sort D = struct d1 | d2;\n";
+  out << "act ";
+  for (std::size_t i = 0; i <= n; i++)
+  {
+    out << "r" << i << ", s" << i << ", c" << i << (i < n ? ", " : ": D;\n");
+  }
+  for (std::size_t i = 0; i < n; i++)
+  {
+    out << (i == 0 ? "proc " : "     ") << "B" << i << " = sum d: D . r" << i << "(d) . s" << i + 1 << "(d) . B" << i << ";\n";
+  }
+  out << "init allow({r0, s" << n;
+  for (std::size_t i = 1; i < n; i++)
+  {
+    out << ", c" << i;
+  }
+  out << "}, comm({";
+  for (std::size_t i = 1; i < n; i++)
+  {
+    out << "s" << i << "|r" << i << " -> c" << i << (i + 1 < n ? ", " : "");
+  }
+  out << "}, ";
+  for (std::size_t i = 0; i < n; i++)
+  {
+    out << "B" << i << (i + 1 < n ? " || " : "");
+  }
+  out << "));\n";
+  return out.str();
+}
+
+// Returns an LTS in .aut format with n states, in which each state has out_degree outgoing
+// transitions to random states. A fraction tau_fraction of the transitions has label tau.
+std::string random_aut(std::size_t n, std::size_t out_degree, double tau_fraction, std::size_t seed = 12345)
+{
+  std::mt19937 generator(seed);
+  std::uniform_real_distribution<double> probability(0.0, 1.0);
+  std::ostringstream out;
+  out << "des (0," << n * out_degree << "," << n << ")\n";
+  for (std::size_t s = 0; s < n; s++)
+  {
+    for (std::size_t i = 0; i < out_degree; i++)
+    {
+      out << "(" << s << ",";
+      if (probability(generator) < tau_fraction)
+      {
+        out << "tau";
+      }
+      else
+      {
+        out << "\"a" << generator() % 4 << "\"";
+      }
+      out << "," << generator() % n << ")\n";
+    }
+  }
+  return out.str();
+}
+
+lts::lts_aut_t parse_aut(const std::string& text)
+{
+  std::istringstream in(text);
+  lts::lts_aut_t result;
+  result.load(in);
+  return result;
+}
+
+// Linearises the specification. Time is ignored, since otherwise the conditions of the models lead to
+// timed deadlock summands, which cannot be explored.
+lps::specification linearise(const std::string& text)
+{
+  lps::t_lin_options options;
+  options.ignore_time = true;
+  return lps::remove_stochastic_operators(lps::linearise(text, options));
+}
+
+// Explores the state space of the specification and returns the number of states.
+std::size_t explore(const std::string& text, benchmark_timer& timer)
+{
+  lts::lts_generation_options options;
+  options.specification = linearise(text);
+  timer.start();
+  lts::lps2lts_algorithm<lps::next_state_generator> algorithm;
+  algorithm.generate_lts(options);
+  return algorithm.number_of_states();
+}
+
+// Collects the states that are found during exploration.
+class state_collector: public lts::lps2lts_algorithm<lps::next_state_generator>
+{
+  public:
+    std::vector<lps::state> states;
+
+    void on_new_state(const lps::state& s) override
+    {
+      lts::lps2lts_algorithm<lps::next_state_generator>::on_new_state(s);
+      states.push_back(s);
+    }
+};
+
+// Enumerates the summation variables that satisfy the conditions of the summands of the
+// specification in each reachable state, and returns the number of solutions.
+std::size_t enumerate_summand_conditions(const std::string& text, benchmark_timer& timer)
+{
+  typedef data::enumerator_list_element_with_substitution<> enumerator_element;
+  lts::lts_generation_options options;
+  options.specification = linearise(text);
+  state_collector collector;
+  collector.generate_lts(options);
+  const lps::specification& spec = options.specification;
+  const data::variable_list& parameters = spec.process().process_parameters();
+  data::rewriter R(spec.data());
+  timer.start();
+  data::enumerator_identifier_generator id_generator;
+  data::enumerator_algorithm_with_iterator<> enumerator(R, spec.data(), R, id_generator, (std::numeric_limits<std::size_t>::max)());
+  data::mutable_indexed_substitution<> sigma;
+  std::size_t count = 0;
+  for (const lps::state& s: collector.states)
+  {
+    auto value = s.begin();
+    for (const data::variable& v: parameters)
+    {
+      sigma[v] = *value++;
+    }
+    for (const lps::action_summand& summand: spec.process().action_summands())
+    {
+      if (summand.summation_variables().empty())
+      {
+        continue;
+      }
+      std::deque<enumerator_element> queue(1, enumerator_element(summand.summation_variables(), R(summand.condition(), sigma)));
+      for (auto i = enumerator.begin(sigma, queue); i != enumerator.end(); ++i)
+      {
+        count++;
+      }
+    }
+  }
+  return count;
+}
+
+std::vector<benchmark> benchmarks()
+{
+  std::vector<benchmark> result;
+
+  result.push_back({ "aterm-create", { 1000000 }, [](std::size_t n, benchmark_timer&)
+    {
+      const atermpp::function_symbol f("f", 2);
+      std::vector<atermpp::aterm_appl> terms;
+      terms.reserve(n);
+      for (std::size_t i = 0; i < n; i++)
+      {
+        terms.emplace_back(f, atermpp::aterm_int(i), atermpp::aterm_int(i % 1000));
+      }
+      return n;
+    }});
+
+  result.push_back({ "indexed-set-put", { 1000000 }, [](std::size_t n, benchmark_timer& timer)
+    {
+      const atermpp::function_symbol f("f", 1);
+      std::vector<atermpp::aterm_appl> terms;
+      for (std::size_t i = 0; i < n; i++)
+      {
+        terms.emplace_back(f, atermpp::aterm_int(i));
+      }
+      timer.start();
+      atermpp::indexed_set<atermpp::aterm_appl> set;
+      for (int k = 0; k < 2; k++) // The second round only finds existing elements.
+      {
+        for (const atermpp::aterm_appl& t: terms)
+        {
+          set.put(t);
+        }
+      }
+      return 2 * n;
+    }});
+
+  result.push_back({ "baf-io", { 1000000 }, [](std::size_t n, benchmark_timer& timer)
+    {
+      const atermpp::function_symbol f("f", 2);
+      const atermpp::function_symbol g("g", 1);
+      atermpp::aterm_list l;
+      for (std::size_t i = 0; i < n; i++)
+      {
+        l.push_front(atermpp::aterm_appl(f, atermpp::aterm_int(i), atermpp::aterm_appl(g, atermpp::aterm_int(i % 100))));
+      }
+      timer.start();
+      std::stringstream stream;
+      atermpp::write_term_to_binary_stream(l, stream);
+      atermpp::aterm t = atermpp::read_term_from_binary_stream(stream);
+      if (t != l)
+      {
+        throw mcrl2::runtime_error("baf-io: the term that is read differs from the term that is written");
+      }
+      return n;
+    }});
+
+  result.push_back({ "jitty-rewrite", { 1000 }, [](std::size_t n, benchmark_timer& timer)
+    {
+      data::data_specification dataspec = data::parse_data_specification(
+        "map fib: Nat -> Nat;\n"
+        "var n: Nat;\n"
+        "eqn fib(0) = 0;\n"
+        "    fib(1) = 1;\n"
+        "    n > 1 -> fib(n) = fib(Int2Nat(n - 1)) + fib(Int2Nat(n - 2));\n");
+      data::rewriter R(dataspec, data::jitty);
+      data::data_expression x = data::parse_data_expression("fib(12)", dataspec);
+      timer.start();
+      for (std::size_t i = 0; i < n; i++)
+      {
+        R(x);
+      }
+      return n;
+    }});
+
+  result.push_back({ "enumerate", { 16 }, [](std::size_t n, benchmark_timer& timer)
+    {
+      typedef data::enumerator_list_element_with_substitution<> enumerator_element;
+      data::data_specification dataspec;
+      data::rewriter R(dataspec);
+      data::variable_vector v;
+      for (std::size_t i = 0; i < n; i++)
+      {
+        v.emplace_back("b" + std::to_string(i), data::sort_bool::bool_());
+      }
+      data::variable_list variables(v.begin(), v.end());
+      timer.start();
+      data::enumerator_identifier_generator id_generator;
+      data::enumerator_algorithm_with_iterator<> enumerator(R, dataspec, R, id_generator, (std::numeric_limits<std::size_t>::max)());
+      data::mutable_indexed_substitution<> sigma;
+      std::deque<enumerator_element> queue(1, enumerator_element(variables, data::sort_bool::true_()));
+      std::size_t count = 0;
+      for (auto i = enumerator.begin(sigma, queue); i != enumerator.end(); ++i)
+      {
+        count++;
+      }
+      return count;
+    }});
+
+  // Enumerates n variables of a structured sort, such that consecutive variables are different.
+  result.push_back({ "enumerate-struct", { 5, 6 }, [](std::size_t n, benchmark_timer& timer)
+    {
+      typedef data::enumerator_list_element_with_substitution<> enumerator_element;
+      data::data_specification dataspec = data::parse_data_specification("sort D = struct d1(Bool) | d2(Bool, Bool) | d3;");
+      data::rewriter R(dataspec);
+      const data::sort_expression D = data::parse_sort_expression("D", dataspec);
+      data::variable_vector v;
+      for (std::size_t i = 0; i < n; i++)
+      {
+        v.emplace_back("x" + std::to_string(i), D);
+      }
+      data::data_expression phi = data::sort_bool::true_();
+      for (std::size_t i = 0; i + 1 < n; i++)
+      {
+        phi = data::sort_bool::and_(phi, data::not_equal_to(v[i], v[i + 1]));
+      }
+      data::variable_list variables(v.begin(), v.end());
+      timer.start();
+      data::enumerator_identifier_generator id_generator;
+      data::enumerator_algorithm_with_iterator<> enumerator(R, dataspec, R, id_generator, (std::numeric_limits<std::size_t>::max)());
+      data::mutable_indexed_substitution<> sigma;
+      std::deque<enumerator_element> queue(1, enumerator_element(variables, phi));
+      std::size_t count = 0;
+      for (auto i = enumerator.begin(sigma, queue); i != enumerator.end(); ++i)
+      {
+        count++;
+      }
+      return count;
+    }});
+
+  result.push_back({ "enumerate-dining-philosophers", { 5, 6 }, [](std::size_t n, benchmark_timer& timer)
+    {
+      return enumerate_summand_conditions(dining_philosophers(n), timer);
+    }});
+
+  result.push_back({ "data-specification", { 20000, 50000 }, [](std::size_t n, benchmark_timer& timer)
+    {
+      const data::basic_sort D("D");
+      const data::function_sort D2Nat(data::sort_expression_list({ D }), data::sort_nat::nat());
+      std::vector<data::function_symbol> constructors;
+      std::vector<data::function_symbol> mappings;
+      for (std::size_t i = 0; i < n; i++)
+      {
+        constructors.emplace_back("d" + std::to_string(i), D);
+        mappings.emplace_back("f" + std::to_string(i), D2Nat);
+      }
+      timer.start();
+      data::data_specification dataspec;
+      dataspec.add_sort(D);
+      for (const data::function_symbol& f: constructors)
+      {
+        dataspec.add_constructor(f);
+      }
+      dataspec.constructors(D);
+      // The mappings are added to a data specification that is already normalised.
+      for (const data::function_symbol& f: mappings)
+      {
+        dataspec.add_mapping(f);
+        dataspec.mappings(data::sort_nat::nat());
+      }
+      if (dataspec.constructors(D).size() != n)
+      {
+        throw mcrl2::runtime_error("data-specification: the number of constructors of D is wrong");
+      }
+      return 2 * n;
+    }});
+
+  result.push_back({ "explore-dining-philosophers", { 5, 6 }, [](std::size_t n, benchmark_timer& timer)
+    {
+      return explore(dining_philosophers(n), timer);
+    }});
+
+  result.push_back({ "explore-token-ring", { 7, 8 }, [](std::size_t n, benchmark_timer& timer)
+    {
+      return explore(token_ring(n), timer);
+    }});
+
+  result.push_back({ "explore-buffer-chain", { 8, 10 }, [](std::size_t n, benchmark_timer& timer)
+    {
+      return explore(buffer_chain(n), timer);
+    }});
+
+  result.push_back({ "aut-parse", { 100000 }, [](std::size_t n, benchmark_timer& timer)
+    {
+      std::string text = random_aut(n, 4, 0.0);
+      timer.start();
+      return parse_aut(text).num_transitions();
+    }});
+
+  result.push_back({ "bisim", { 100000 }, [](std::size_t n, benchmark_timer& timer)
+    {
+      lts::lts_aut_t l = parse_aut(random_aut(n, 4, 0.0));
+      timer.start();
+      std::size_t transitions = l.num_transitions();
+      lts::reduce(l, lts::lts_eq_bisim);
+      return transitions;
+    }});
+
+  result.push_back({ "branching-bisim", { 100000 }, [](std::size_t n, benchmark_timer& timer)
+    {
+      lts::lts_aut_t l = parse_aut(random_aut(n, 4, 0.2));
+      timer.start();
+      std::size_t transitions = l.num_transitions();
+      lts::reduce(l, lts::lts_eq_branching_bisim);
+      return transitions;
+    }});
+
+  // The parallel bisimulation reduction with different numbers of threads, to measure the scaling.
+  std::vector<std::size_t> thread_counts = { 1, 2, 4 };
+  if (lts::detail::default_number_of_threads() > 4)
+  {
+    thread_counts.push_back(lts::detail::default_number_of_threads());
+  }
+  for (std::size_t threads: thread_counts)
+  {
+    result.push_back({ "bisim-parallel-" + std::to_string(threads), { 100000 }, [threads](std::size_t n, benchmark_timer& timer)
+      {
+        lts::lts_aut_t l = parse_aut(random_aut(n, 4, 0.0));
+        timer.start();
+        std::size_t transitions = l.num_transitions();
+        lts::detail::bisimulation_reduce_parallel(l, false, false, threads);
+        return transitions;
+      }});
+  }
+
+  // Weak bisimulation on a tau path of n states, of which the last state has n different visible actions.
+  // All states on the path have the same signature of size n, so the memory used should grow linearly in n.
+  // The reduction is applied directly, since a branching bisimulation reduction would remove the path.
+  result.push_back({ "weak-bisim-tau-path", { 50000, 100000, 200000 }, [](std::size_t n, benchmark_timer& timer)
+    {
+      std::ostringstream out;
+      out << "des (0," << 2 * n - 1 << "," << n + 1 << ")\n";
+      for (std::size_t i = 0; i + 1 < n; i++)
+      {
+        out << "(" << i << ",tau," << i + 1 << ")\n";
+      }
+      for (std::size_t i = 0; i < n; i++)
+      {
+        out << "(" << n - 1 << ",\"a" << i << "\"," << n << ")\n";
+      }
+      lts::lts_aut_t l = parse_aut(out.str());
+      timer.start();
+      lts::detail::weak_bisim_partitioner<lts::lts_aut_t> partitioner(l);
+      if (partitioner.num_eq_classes() != 2)
+      {
+        throw mcrl2::runtime_error("weak-bisim-tau-path: the number of equivalence classes is wrong");
+      }
+      return l.num_transitions();
+    }});
+
+  // The (ready) simulation preorder computed by the partitioners and by the bit matrix engine. Each
+  // benchmark compares two random LTSs with n states, so they all work on the same merged LTS.
+  const std::pair<std::string, lts::lts_preorder> simulation_preorders[] =
+  {
+    { "simulation-partitioner", lts::lts_pre_sim },
+    { "simulation-bit-matrix", lts::lts_pre_sim_bit_matrix },
+    { "ready-simulation-partitioner", lts::lts_pre_ready_sim },
+    { "ready-simulation-bit-matrix", lts::lts_pre_ready_sim_bit_matrix }
+  };
+  for (const auto& p: simulation_preorders)
+  {
+    lts::lts_preorder preorder = p.second;
+    result.push_back({ p.first, { 300, 1000 }, [preorder](std::size_t n, benchmark_timer& timer)
+      {
+        lts::lts_aut_t l1 = parse_aut(random_aut(n, 2, 0.0, 1));
+        lts::lts_aut_t l2 = parse_aut(random_aut(n, 2, 0.0, 2));
+        timer.start();
+        std::size_t transitions = l1.num_transitions() + l2.num_transitions();
+        lts::destructive_compare(l1, l2, preorder, false);
+        return transitions;
+      }});
+  }
+
+  return result;
+}
+
+class mcrl3benchmark_tool: public tool
+{
+  protected:
+    typedef tool super;
+
+    std::vector<std::string> m_selection;
+    std::size_t m_repetitions = 3;
+    std::size_t m_size = 0;
+    bool m_list = false;
+    std::string m_json_filename;
+
+    void add_options(utilities::interface_description& desc) override
+    {
+      super::add_options(desc);
+      desc.add_option("benchmarks", utilities::make_mandatory_argument("NAMES"),
+                      "run only the benchmarks of which the name starts with one of the comma separated NAMES. ", 'b');
+      desc.add_option("list", "print the names and sizes of the benchmarks, and do not run them. ", 'l');
+      desc.add_option("repetitions", utilities::make_mandatory_argument("NUM"),
+                      "run each benchmark NUM times (default is 3). The minimum and median times are reported. ", 'r');
+      desc.add_option("size", utilities::make_mandatory_argument("NUM"),
+                      "run each benchmark with size NUM instead of its default sizes. ", 's');
+      desc.add_option("json", utilities::make_mandatory_argument("FILE"),
+                      "write the measurements in JSON format to FILE. ", 'j');
+    }
+
+    void parse_options(const utilities::command_line_parser& parser) override
+    {
+      super::parse_options(parser);
+      if (parser.options.count("benchmarks"))
+      {
+        m_selection = utilities::split(parser.option_argument("benchmarks"), ",");
+      }
+      m_list = parser.options.count("list") > 0;
+      if (parser.options.count("repetitions"))
+      {
+        m_repetitions = parser.option_argument_as<std::size_t>("repetitions");
+      }
+      if (parser.options.count("size"))
+      {
+        m_size = parser.option_argument_as<std::size_t>("size");
+      }
+      if (parser.options.count("json"))
+      {
+        m_json_filename = parser.option_argument("json");
+      }
+    }
+
+    bool is_selected(const benchmark& b) const
+    {
+      if (m_selection.empty())
+      {
+        return true;
+      }
+      return std::any_of(m_selection.begin(), m_selection.end(), [&](const std::string& name) { return b.name.compare(0, name.size(), name) == 0; });
+    }
+
+  public:
+    mcrl3benchmark_tool()
+      : super("mcrl3benchmark", "Wieger Wesselink",
+              "run benchmarks of the core algorithms",
+              "Runs benchmarks of term creation, indexed sets, binary term I/O, jitty rewriting, enumeration, "
+              "state space exploration of scalable models (dining philosophers, a token ring and a chain "
+              "of buffers), parsing of .aut files, bisimulation reduction and simulation preorder computation. "
+              "For each benchmark and size the minimum and median time, the throughput in items per second "
+              "and the peak resident memory are reported. The peak memory is marked with a * if it could "
+              "not be measured per benchmark."
+             )
+    {}
+
+    bool run() override
+    {
+      std::vector<utilities::benchmark_measurement> measurements;
+      if (!m_list)
+      {
+        utilities::write_benchmark_header(std::cout);
+      }
+      for (const benchmark& b: benchmarks())
+      {
+        if (!is_selected(b))
+        {
+          continue;
+        }
+        std::vector<std::size_t> sizes = m_size == 0 ? b.sizes : std::vector<std::size_t>{ m_size };
+        if (m_list)
+        {
+          std::cout << b.name << " " << utilities::string_join(sizes, ",") << std::endl;
+          continue;
+        }
+        for (std::size_t size: sizes)
+        {
+          measurements.push_back(utilities::run_benchmark(b, size, m_repetitions));
+          utilities::write_benchmark_row(std::cout, measurements.back());
+          std::cout.flush();
+        }
+      }
+      if (!m_json_filename.empty())
+      {
+        std::ofstream out(m_json_filename);
+        if (!out.good())
+        {
+          throw mcrl2::runtime_error("Could not write to filename " + m_json_filename);
+        }
+        utilities::write_benchmark_json(out, measurements);
+      }
+      return true;
+    }
+};
+
+int main(int argc, char* argv[])
+{
+  return mcrl3benchmark_tool().execute(argc, argv);
+}
@@ -14,6 +14,7 @@
 #include <memory>
 #include <string>
 
+#include "mcrl2/data/detail/rewrite_profile.h"
 #include "mcrl2/data/rewriter_tool.h"
 #include "mcrl2/lps/io.h"
 #include "mcrl2/lts/detail/exploration.h"
@@ -21,6 +22,7 @@
 #include "mcrl2/process/action_parse.h"
 #include "mcrl2/utilities/input_output_tool.h"
 #include "mcrl2/utilities/logger.h"
+#include "mcrl2/utilities/text_utility.h"
 
 using namespace mcrl2;
 using namespace mcrl2::utilities::tools;
@@ -71,6 +73,7 @@ class mcrl3explore_tool: public rewriter_tool<input_output_tool>
 
     lts_generation_options m_options;
     std::string m_filename;
+    std::string m_rewriter_profile_filename;
     abortable* m_abortable = nullptr;
 
   public:
@@ -112,9 +115,31 @@ class mcrl3explore_tool: public rewriter_tool<input_output_tool>
       m_abortable->abort();
     }
 
+    void save_rewriter_profile(const data::detail::rewrite_profile& profile) const
+    {
+      data::detail::set_active_rewrite_profile(nullptr);
+      if (m_rewriter_profile_filename.empty())
+      {
+        return;
+      }
+      mCRL2log(verbose) << "writing rewriter profile to " << m_rewriter_profile_filename << std::endl;
+      profile.save(m_rewriter_profile_filename);
+    }
+
     bool run() override
     {
-      load_lps(m_options.specification, m_filename);
+      {
+        utilities::scoped_timer timing("load LPS", &timer());
+        load_lps(m_options.specification, m_filename);
+      }
+
+      // With only --telemetry the profile is used to count the rewrite calls.
+      data::detail::rewrite_profile profile;
+      profile.count_only = m_rewriter_profile_filename.empty();
+      if (!m_rewriter_profile_filename.empty() || !m_options.telemetry_filename.empty())
+      {
+        data::detail::set_active_rewrite_profile(&profile);
+      }
 
       try
       {
@@ -134,9 +159,11 @@ class mcrl3explore_tool: public rewriter_tool<input_output_tool>
       catch (mcrl2::runtime_error& e)
       {
         mCRL2log(error) << e.what() << std::endl;
+        save_rewriter_profile(profile);
         return false;
       }
 
+      save_rewriter_profile(profile);
       return true;
     }
 
@@ -162,6 +189,13 @@ class mcrl3explore_tool: public rewriter_tool<input_output_tool>
                  "detect nondeterministic states, i.e. states with outgoing transitions with the same label to different states. ", 'n').
       add_option("deadlock",
                  "detect deadlocks (i.e. for every deadlock a message is printed). ", 'D').
+      add_option("action", make_mandatory_argument("NAMES"),
+                 "detect actions from NAMES, a comma-separated list of action names; a message "
+                 "is printed for every occurrence of one of these action names. ", 'a').
+      add_option("trace", make_optional_argument("NUM", std::to_string(lts_generation_options::default_max_traces)),
+                 "write at most NUM traces to states detected with the --deadlock or --action options "
+                 "(default is unlimited). The traces are reconstructed from a table that stores for every "
+                 "state the predecessor and the summand by which it was reached. ", 't').
       add_option("out", make_mandatory_argument("FORMAT"),
                  "save the output in the specified FORMAT. ", 'o').
       add_option("no-info", "do not add state information to OUTFILE. "
@@ -175,8 +209,32 @@ class mcrl3explore_tool: public rewriter_tool<input_output_tool>
                  "For large state spaces the number of progress messages can be quite "
                  "horrendous. This feature helps to suppress those. Other verbose messages, "
                  "such as the total number of states explored, just remain visible. ").
+      add_option("compress-states",
+                 "store states as vectors of indices into tables with the values of the process parameters. "
+                 "This reduces the memory needed for the state table, in particular if the process "
+                 "parameters range over a small number of values. ").
+      add_option("external-memory",
+                 "store the visited states on disk instead of in memory, and detect duplicate states "
+                 "per level by merging sorted files. Only the aut output format is supported. ").
+      add_option("memory-budget", make_mandatory_argument("NUM"),
+                 "use at most NUM megabytes for sorting states in memory with --external-memory (default is 256). ").
+      add_option("tmp-dir", make_mandatory_argument("DIR"),
+                 "store the temporary files of --external-memory in directory DIR (default is the current directory). ").
       add_option("init-tsize", make_mandatory_argument("NUM"),
-                 "set the initial size of the internally used hash tables (default is 10000). ");
+                 "set the initial size of the internally used hash tables (default is 10000). ").
+      add_option("rewriter-profile", make_mandatory_argument("FILE"),
+                 "write statistics of the rewriter to FILE: for every data equation the number of times it is "
+                 "tried and applied and the time spent on it, and for every function symbol the number of "
+                 "rewrite steps. The statistics are written in JSON format if FILE has the extension .json, "
+                 "and as a sorted report otherwise. Only the jitty and jittyp rewriters can be profiled. ").
+      add_option("telemetry", make_mandatory_argument("FILE"),
+                 "write progress information to FILE, as one JSON object per line: the number of states, "
+                 "transitions and rewrite calls, the states and transitions per level, the size and load "
+                 "factor of the state table, the size of the term heap and the time spent on garbage "
+                 "collection, and per summand the time, the number of solutions and the fraction of states "
+                 "in which its condition has no solutions. FILE may also be a device, like /dev/fd/3. ").
+      add_option("telemetry-interval", make_mandatory_argument("NUM"),
+                 "write a line of progress information at most every NUM milliseconds (default is 1000). ");
     }
 
     void parse_options(const command_line_parser& parser) override
@@ -189,6 +247,34 @@ class mcrl3explore_tool: public rewriter_tool<input_output_tool>
       m_options.suppress_progress_messages  = parser.options.count("suppress") != 0;
       m_options.strat                       = parser.option_argument_as<mcrl2::data::rewriter::strategy>("rewriter");
       m_options.use_enumeration_caching     = parser.options.count("cached") > 0;
+      m_options.compress_states             = parser.options.count("compress-states") > 0;
+      m_options.external_memory             = parser.options.count("external-memory") > 0;
+      if (parser.options.count("memory-budget"))
+      {
+        m_options.memory_budget = parser.option_argument_as<std::size_t>("memory-budget") * 1024 * 1024;
+      }
+      if (parser.options.count("tmp-dir"))
+      {
+        m_options.temporary_directory = parser.option_argument("tmp-dir");
+      }
+      if (parser.options.count("rewriter-profile"))
+      {
+        m_rewriter_profile_filename = parser.option_argument("rewriter-profile");
+#ifdef MCRL2_JITTYC_AVAILABLE
+        if (m_options.strat == data::jitty_compiling || m_options.strat == data::jitty_compiling_prover)
+        {
+          parser.error("Option --rewriter-profile is not supported by the compiling rewriter; use -rjitty instead.");
+        }
+#endif // MCRL2_JITTYC_AVAILABLE
+      }
+      if (parser.options.count("telemetry"))
+      {
+        m_options.telemetry_filename = parser.option_argument("telemetry");
+      }
+      if (parser.options.count("telemetry-interval"))
+      {
+        m_options.telemetry_interval = parser.option_argument_as<std::size_t>("telemetry-interval");
+      }
 
       if (parser.options.count("dummy"))
       {
@@ -211,6 +297,20 @@ class mcrl3explore_tool: public rewriter_tool<input_output_tool>
         }
       }
 
+      if (parser.options.count("action"))
+      {
+        m_options.detect_action = true;
+        for (const std::string& name: utilities::split(parser.option_argument("action"), ","))
+        {
+          m_options.trace_actions.insert(core::identifier_string(name));
+        }
+      }
+      if (parser.options.count("trace"))
+      {
+        m_options.trace = true;
+        m_options.max_traces = parser.option_argument_as<std::size_t>("trace");
+      }
+
       if (parser.options.count("max"))
       {
         m_options.max_states = parser.option_argument_as<unsigned long> ("max");
@@ -247,6 +347,13 @@ class mcrl3explore_tool: public rewriter_tool<input_output_tool>
       {
         m_filename = parser.arguments[0];
       }
+      m_options.trace_prefix = m_filename.empty() ? std::string("mcrl3explore") : m_filename;
+      std::size_t dot = m_options.trace_prefix.find_last_of('.');
+      std::size_t slash = m_options.trace_prefix.find_last_of('/');
+      if (dot != std::string::npos && (slash == std::string::npos || dot > slash))
+      {
+        m_options.trace_prefix = m_options.trace_prefix.substr(0, dot);
+      }
       if (1 < parser.arguments.size())
       {
         m_options.filename = parser.arguments[1];
@@ -55,18 +55,24 @@ class mcrl3linearize_tool: public utilities::tools::input_output_tool
 
     bool run() override
     {
-      timer().start("parse + type check process specification");
-      process::process_specification procspec = process::detail::parse_process_specification(input_filename());
-      timer().finish("parse + type check process specification");
-      lps::specification lpsspec;
-      if (use_groote_implementation)
+      process::process_specification procspec;
       {
-        lpsspec = process::mcrl32lps(procspec, expand_structured_sorts, max_equation_usage);
+        utilities::scoped_timer timing("parse + type check process specification", &timer());
+        procspec = process::detail::parse_process_specification(input_filename());
       }
-      else
+      lps::specification lpsspec;
       {
-        lpsspec = linearize(procspec, expand_structured_sorts, max_equation_usage);
+        utilities::scoped_timer timing("linearize", &timer());
+        if (use_groote_implementation)
+        {
+          lpsspec = process::mcrl32lps(procspec, expand_structured_sorts, max_equation_usage);
+        }
+        else
+        {
+          lpsspec = linearize(procspec, expand_structured_sorts, max_equation_usage);
+        }
       }
+      utilities::scoped_timer timing("save LPS", &timer());
       lps::detail::save_lps(lpsspec, output_filename());
       return true;
     }
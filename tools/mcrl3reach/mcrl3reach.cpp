@@ -0,0 +1,72 @@
+// Author(s): Wieger Wesselink
+// Copyright: see the accompanying file COPYING or copy at
+// https://github.com/mCRL2org/mCRL2/blob/master/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file mcrl3reach.cpp
+
+#include <iomanip>
+#include <iostream>
+#include "mcrl2/data/rewriter_tool.h"
+#include "mcrl2/lps/symbolic_reachability.h"
+#include "mcrl2/utilities/input_tool.h"
+
+using namespace mcrl2;
+using data::tools::rewriter_tool;
+using utilities::tools::input_tool;
+
+class mcrl3reach_tool: public rewriter_tool<input_tool>
+{
+  protected:
+    typedef rewriter_tool<input_tool> super;
+
+    bool m_chaining = false;
+
+    void parse_options(const utilities::command_line_parser& parser) override
+    {
+      super::parse_options(parser);
+      m_chaining = parser.options.count("chaining") > 0;
+    }
+
+    void add_options(utilities::interface_description& desc) override
+    {
+      super::add_options(desc);
+      desc.add_option("chaining", "apply the transition groups one after another within each iteration, "
+                                  "instead of computing the successors of each level in a breadth first manner. "
+                                  "This typically reduces the number of iterations. ", 'c');
+    }
+
+  public:
+    mcrl3reach_tool()
+      : super("mcrl3reach", "Wieger Wesselink",
+              "compute the reachable states of an LPS symbolically",
+              "Computes the number of reachable states of the LPS in INFILE, using list decision diagrams. "
+              "The transition relation is learned on the fly for each summand, projected on the process "
+              "parameters that the summand depends on. If INFILE is not supplied, stdin is used."
+             )
+    {}
+
+    bool run() override
+    {
+      timer().start("initialize PINS");
+      lps::pins p(input_filename(), data::pp(rewrite_strategy()));
+      timer().finish("initialize PINS");
+
+      timer().start("symbolic reachability");
+      lps::symbolic_reachability_algorithm algorithm(p, m_chaining);
+      lps::symbolic_reachability_algorithm::ldd visited = algorithm.run();
+      timer().finish("symbolic reachability");
+
+      std::cout << "number of states: " << std::fixed << std::setprecision(0) << algorithm.count(visited) << std::endl;
+      std::cout << "number of iterations: " << algorithm.level() << std::endl;
+      return true;
+    }
+};
+
+int main(int argc, char* argv[])
+{
+  return mcrl3reach_tool().execute(argc, argv);
+}